@@ -0,0 +1,246 @@
+﻿#include "JobSystem.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace PSG
+{
+
+namespace
+{
+// 当前线程所属的调度器与队列下标（工作线程启动时设置）
+thread_local const JobSystem *tlsOwner = nullptr;
+thread_local uint32_t tlsIndex = 0;
+} // namespace
+
+JobSystem::JobSystem()
+{
+}
+
+JobSystem::~JobSystem()
+{
+    Destroy();
+}
+
+bool JobSystem::Init(uint32_t threadCount)
+{
+    if (!_threads.empty()) {
+        return false;
+    }
+
+    if (0 == threadCount) {
+        const uint32_t hardware = std::thread::hardware_concurrency();
+        threadCount = std::max(1u, hardware > 1 ? hardware - 1 : 1u);
+    }
+
+    for (uint32_t i = 0; i <= threadCount; ++i) {
+        _queues.push_back(new WorkQueue());
+    }
+
+    _quit = false;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        _threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    return true;
+}
+
+void JobSystem::Destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+
+    for (auto &thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    _threads.clear();
+
+    for (auto *queue : _queues) {
+        delete queue;
+    }
+    _queues.clear();
+    _queued = 0;
+}
+
+void JobSystem::Run(std::function<void()> func, JobCounter *counter,
+                    JobCounter *dependency)
+{
+    // 提交时就计数，挂起等待依赖的任务也算未完成
+    if (nullptr != counter) {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job{std::move(func), counter};
+
+    if (nullptr != dependency) {
+        std::lock_guard<std::mutex> lock(dependency->_mutex);
+        if (!dependency->IsDone()) {
+            dependency->_waiting.push_back(std::move(job));
+            return;
+        }
+    }
+
+    push(std::move(job));
+}
+
+void JobSystem::ParallelFor(
+    uint32_t count, uint32_t sliceCount,
+    std::function<void(uint32_t begin, uint32_t end)> func,
+    JobCounter &counter, JobCounter *dependency)
+{
+    if (0 == count) {
+        return;
+    }
+
+    if (0 == sliceCount) {
+        sliceCount = GetConcurrency();
+    }
+    sliceCount = std::min(sliceCount, count);
+    const uint32_t sliceSize = (count + sliceCount - 1) / sliceCount;
+
+    // 各段共享同一个函数对象，调用方返回后仍然有效
+    auto shared = std::make_shared<std::function<void(uint32_t, uint32_t)>>(
+        std::move(func));
+
+    for (uint32_t begin = 0; begin < count; begin += sliceSize) {
+        const uint32_t end = std::min(count, begin + sliceSize);
+        Run([shared, begin, end]() { (*shared)(begin, end); }, &counter,
+            dependency);
+    }
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    while (!counter.IsDone()) {
+        Job job;
+        if (pop(job)) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // 等待最后一个任务释放计数器的锁，之后调用方可以销毁计数器
+    std::lock_guard<std::mutex> lock(counter._mutex);
+}
+
+uint32_t JobSystem::queueIndex() const
+{
+    if (tlsOwner == this) {
+        return tlsIndex;
+    }
+
+    // 非工作线程使用末尾的共享队列
+    return static_cast<uint32_t>(_queues.size() - 1);
+}
+
+void JobSystem::push(Job &&job)
+{
+    // 没有工作线程时直接在当前线程执行
+    if (_queues.empty()) {
+        execute(job);
+        return;
+    }
+
+    WorkQueue *queue = _queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(std::move(job));
+    }
+    _queued.fetch_add(1, std::memory_order_release);
+
+    // 加锁后再通知，避免与休眠线程的条件检查错过
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wake.notify_one();
+}
+
+bool JobSystem::pop(Job &job)
+{
+    if (0 == _queued.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const uint32_t queueCount = static_cast<uint32_t>(_queues.size());
+    const uint32_t own = queueIndex();
+
+    // 自己的队列从队尾取
+    {
+        WorkQueue *queue = _queues[own];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->jobs.empty()) {
+            job = std::move(queue->jobs.back());
+            queue->jobs.pop_back();
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 从下一个队列开始依次窃取，分散竞争
+    for (uint32_t i = 1; i < queueCount; ++i) {
+        WorkQueue *queue = _queues[(own + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->jobs.empty()) {
+            job = std::move(queue->jobs.front());
+            queue->jobs.pop_front();
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job &job)
+{
+    job.func();
+
+    JobCounter *counter = job.counter;
+    if (nullptr == counter) {
+        return;
+    }
+
+    // 持锁递减：归零时取出依赖它的任务（与 Run 中的检查互斥），
+    // 且 Wait 返回前会获取该锁，保证此后不再访问计数器
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->_mutex);
+        if (1 == counter->_value.fetch_sub(1, std::memory_order_acq_rel)) {
+            ready.swap(counter->_waiting);
+        }
+    }
+
+    for (auto &next : ready) {
+        push(std::move(next));
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index)
+{
+    tlsOwner = this;
+    tlsIndex = index;
+
+    while (true) {
+        Job job;
+        if (pop(job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wake.wait(lock, [this]() {
+            return _quit || _queued.load(std::memory_order_acquire) > 0;
+        });
+        if (_quit) {
+            return;
+        }
+    }
+}
+
+} // namespace PSG
@@ -0,0 +1,163 @@
+﻿#ifndef JOBSYSTEM_H_
+#define JOBSYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PSG
+{
+
+class JobCounter;
+
+/**
+ * @brief 一个任务：执行函数 + 完成时递减的计数器
+ */
+struct Job
+{
+    std::function<void()> func;
+
+    JobCounter *counter = nullptr;
+};
+
+/**
+ * @brief 任务计数器
+ *
+ * 提交任务时 +1，任务完成时 -1，归零表示这组任务全部完成；
+ * 依赖它的任务在归零前挂在计数器上，归零时才进入队列；
+ * 销毁前必须经过 JobSystem::Wait
+ */
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool IsDone() const
+    {
+        return 0 == _value.load(std::memory_order_acquire);
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> _value{0};
+
+    // 保护 _waiting，并与归零时的取出互斥
+    std::mutex _mutex;
+
+    // 依赖该计数器的任务
+    std::vector<Job> _waiting;
+};
+
+/**
+ * @brief JobSystem
+ *
+ * 工作窃取任务调度：
+ * - 每个工作线程一个双端队列，自己从队尾取（LIFO，缓存友好），
+ *   空闲时从其他队列的队首窃取（FIFO，先取大块任务）
+ * - 非工作线程提交的任务进入额外的共享队列
+ * - Wait 不阻塞，等待期间执行队列中的任务，调用线程也参与计算
+ */
+class JobSystem
+{
+public:
+    JobSystem();
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+public:
+    /**
+     * @brief 启动工作线程
+     * @param threadCount 工作线程数，0 表示硬件线程数 - 1（调用线程在 Wait
+     *        时协助执行）
+     */
+    bool Init(uint32_t threadCount = 0);
+
+    /**
+     * @brief 停止工作线程（尚未执行的任务被丢弃，调用前应先 Wait）
+     */
+    void Destroy();
+
+    /**
+     * @brief 提交任务
+     * @param counter 完成计数器（可为空）
+     * @param dependency 依赖的计数器，归零后才开始执行（可为空）
+     */
+    void Run(std::function<void()> func, JobCounter *counter = nullptr,
+             JobCounter *dependency = nullptr);
+
+    /**
+     * @brief 把 [0, count) 切分为 sliceCount 段并行执行
+     * @param sliceCount 段数，0 表示 GetConcurrency()
+     * @param func 每段调用一次 func(begin, end)
+     */
+    void ParallelFor(uint32_t count, uint32_t sliceCount,
+                     std::function<void(uint32_t begin, uint32_t end)> func,
+                     JobCounter &counter, JobCounter *dependency = nullptr);
+
+    /**
+     * @brief 等待计数器归零，期间协助执行任务
+     */
+    void Wait(JobCounter &counter);
+
+    uint32_t GetWorkerCount() const
+    {
+        return static_cast<uint32_t>(_threads.size());
+    }
+
+    /**
+     * @brief 可同时执行任务的线程数（工作线程 + 等待中的调用线程）
+     */
+    uint32_t GetConcurrency() const
+    {
+        return GetWorkerCount() + 1;
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    /// 当前线程在本调度器中的队列下标（非工作线程为共享队列）
+    uint32_t queueIndex() const;
+
+    void push(Job &&job);
+
+    /// 先取自己的队尾，再窃取其他队列的队首
+    bool pop(Job &job);
+
+    void execute(Job &job);
+
+    void workerLoop(uint32_t index);
+
+private:
+    // 工作线程队列 + 末尾一个共享队列
+    std::vector<WorkQueue *> _queues;
+
+    std::vector<std::thread> _threads;
+
+    // 队列中的任务数（空闲线程据此休眠）
+    std::atomic<uint32_t> _queued{0};
+
+    std::mutex _sleepMutex;
+
+    std::condition_variable _wake;
+
+    bool _quit = false;
+};
+
+} // namespace PSG
+
+#endif // !JOBSYSTEM_H_
@@ -82,6 +82,7 @@ struct PushObject
 {
     alignas(16) MAT_4 model;
     alignas(16) PTF_3D color;
+    uint32_t textureIndex = 0; // Bindless 纹理下标（占用 color 后的填充）
 };
 
 // 矩阵信息结构体
@@ -290,6 +291,64 @@ struct VerCorTexNor
     }
 };
 
+// 逐实例数据（硬件实例化，与顶点数据使用不同的绑定）
+struct InstanceData
+{
+    MAT_4 model;
+    PTF_3D color;
+    uint32_t textureIndex = 0; // Bindless 纹理下标
+
+    // 绑定描述
+    //  每个实例之后才移动到下一个数据条目
+    static VkVertexInputBindingDescription
+    getBindingDescription(uint32_t binding = 1)
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = binding;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return bindingDescription;
+    }
+
+    // 属性描述
+    //  mat4 占用 4 个连续 location（每列一个 vec4），颜色、纹理下标紧随其后
+    static std::array<VkVertexInputAttributeDescription, 6>
+    getAttributeDescriptions(uint32_t binding = 1, uint32_t location = 4)
+    {
+        std::array<VkVertexInputAttributeDescription, 6>
+            attributeDescriptions{};
+        for (uint32_t i = 0; i < 4; ++i) {
+            attributeDescriptions[i].binding = binding;
+            attributeDescriptions[i].location = location + i;
+            attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[i].offset =
+                offsetof(InstanceData, model) + sizeof(PTF_4D) * i;
+        }
+
+        attributeDescriptions[4].binding = binding;
+        attributeDescriptions[4].location = location + 4;
+        attributeDescriptions[4].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[4].offset = offsetof(InstanceData, color);
+
+        attributeDescriptions[5].binding = binding;
+        attributeDescriptions[5].location = location + 5;
+        attributeDescriptions[5].format = VK_FORMAT_R32_UINT;
+        attributeDescriptions[5].offset =
+            offsetof(InstanceData, textureIndex);
+
+        return attributeDescriptions;
+    }
+};
+
+// 逐物体数据（存储缓冲，std430 布局，按 firstInstance + 实例号寻址）
+struct ObjectData
+{
+    alignas(16) MAT_4 model;
+    alignas(16) PTF_4D color;              // rgb 颜色，a 透明度
+    alignas(16) uint32_t textureIndex = 0; // Bindless 纹理下标
+};
+
 // 特化 hash 函数 用于 unordered_map
 namespace std
 {
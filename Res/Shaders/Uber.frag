@@ -0,0 +1,77 @@
+﻿#version 450
+
+#ifdef HAS_BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+// Uber 片段着色器
+// 特性宏（离线编译排列，对应 VKB::ShaderFeature）:
+//   HAS_TEXTURE   HAS_NORMAL   HAS_LIGHTING   HAS_UBO_COLOR   HAS_GPU_DRIVEN
+//   HAS_INSTANCING   HAS_OBJECT_BUFFER   HAS_BINDLESS
+//   （HAS_GPU_DRIVEN / HAS_INSTANCING / HAS_OBJECT_BUFFER 只影响顶点阶段）
+
+// 特化常量（运行时开关）
+layout(constant_id = 0) const float UV_SCALE = 1.0;
+layout(constant_id = 2) const bool USE_SPECULAR = true;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec3 fragNormal;
+layout(location = 3) in vec3 fragPos;
+layout(location = 4) in float fragAlpha;
+
+#ifdef HAS_BINDLESS
+// Bindless 纹理表（集合 1），按逐物体下标采样
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+layout(location = 5) flat in uint fragTextureIndex;
+#elif defined(HAS_TEXTURE)
+layout(binding = 2) uniform sampler2D texSampler;
+#endif
+
+#ifdef HAS_LIGHTING
+layout(binding = 3) uniform Light {
+    vec3 lightPos;    // 光源位置
+    vec3 lightColor;  // 光源颜色
+    vec3 viewPos;     // 摄像机位置
+} light;
+#endif
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+#ifdef HAS_BINDLESS
+    vec3 texColor = texture(textures[nonuniformEXT(fragTextureIndex)],
+                            fragTexCoord * UV_SCALE)
+                        .rgb;
+#elif defined(HAS_TEXTURE)
+    vec3 texColor = texture(texSampler, fragTexCoord * UV_SCALE).rgb;
+#else
+    vec3 texColor = vec3(1.0);
+#endif
+
+#ifdef HAS_LIGHTING
+    // 环境光
+    vec3 ambient = 0.1 * texColor * fragColor;
+
+    // 漫反射
+    vec3 norm = normalize(fragNormal);
+    vec3 lightDir = normalize(light.lightPos - fragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * light.lightColor * texColor;
+
+    // 镜面高光
+    vec3 specular = vec3(0.0);
+    if (USE_SPECULAR) {
+        vec3 viewDir = normalize(light.viewPos - fragPos);
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+        specular = spec * light.lightColor;
+    }
+
+    vec3 result = ambient + diffuse + specular;
+#else
+    vec3 result = fragColor * texColor;
+#endif
+
+    outColor = vec4(result, fragAlpha);
+}
@@ -0,0 +1,154 @@
+﻿#version 450
+
+// Uber 顶点着色器
+// 特性宏（离线编译排列，对应 VKB::ShaderFeature）:
+//   HAS_TEXTURE   HAS_NORMAL   HAS_LIGHTING   HAS_UBO_COLOR   HAS_GPU_DRIVEN
+//   HAS_INSTANCING   HAS_OBJECT_BUFFER   HAS_BINDLESS
+
+#if defined(HAS_LIGHTING) && !defined(HAS_NORMAL)
+#error "HAS_LIGHTING requires HAS_NORMAL"
+#endif
+
+#if defined(HAS_GPU_DRIVEN) && defined(HAS_INSTANCING)
+#error "HAS_GPU_DRIVEN and HAS_INSTANCING are exclusive"
+#endif
+
+#if defined(HAS_OBJECT_BUFFER) \
+    && (defined(HAS_GPU_DRIVEN) || defined(HAS_INSTANCING))
+#error "HAS_OBJECT_BUFFER excludes HAS_GPU_DRIVEN and HAS_INSTANCING"
+#endif
+
+#if defined(HAS_BINDLESS) \
+    && (!defined(HAS_TEXTURE) || defined(HAS_GPU_DRIVEN))
+#error "HAS_BINDLESS requires HAS_TEXTURE and excludes HAS_GPU_DRIVEN"
+#endif
+
+// 特化常量（运行时开关）
+layout(constant_id = 1) const bool USE_VERTEX_COLOR = false;
+
+#ifdef HAS_GPU_DRIVEN
+// GPU 驱动：逐物体数据来自存储缓冲，间接绘制的 firstInstance 即物体下标
+struct ObjectData
+{
+    mat4 model;
+    vec4 color;
+    vec4 sphere;
+    uvec4 mesh;
+};
+
+layout(std430, binding = 4) readonly buffer ObjectBuffer
+{
+    ObjectData objects[];
+};
+#elif defined(HAS_OBJECT_BUFFER)
+// 逐物体缓冲：本帧全部物体的数据，按 firstInstance + 实例号寻址
+struct FrameObject
+{
+    mat4 model;
+    vec4 color;
+    uint textureIndex;
+};
+
+layout(std430, binding = 5) readonly buffer FrameObjectBuffer
+{
+    FrameObject frameObjects[];
+};
+#elif !defined(HAS_INSTANCING)
+layout(push_constant) uniform PushObject
+{
+    mat4 model;
+    vec3 color;
+    uint textureIndex;
+} push;
+#endif
+
+layout(binding = 0) uniform UniformBufferObject{
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} MvpUbo;
+
+#ifdef HAS_UBO_COLOR
+layout(binding = 1) uniform UnMyColor{
+    float alpha;
+    vec3 color;
+} ColorUbo;
+#endif
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+#ifdef HAS_TEXTURE
+layout(location = 2) in vec2 inTexCoord;
+#endif
+#ifdef HAS_NORMAL
+layout(location = 3) in vec3 inNormal;
+#endif
+#ifdef HAS_INSTANCING
+// 逐实例属性（绑定 1，mat4 占 location 4 ~ 7）
+layout(location = 4) in mat4 instanceModel;
+layout(location = 8) in vec3 instanceColor;
+layout(location = 9) in uint instanceTextureIndex;
+#endif
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+layout(location = 3) out vec3 fragPos;
+layout(location = 4) out float fragAlpha;
+#ifdef HAS_BINDLESS
+// Bindless 纹理表下标（逐物体，不插值）
+layout(location = 5) flat out uint fragTextureIndex;
+#endif
+
+void main() {
+#ifdef HAS_GPU_DRIVEN
+    mat4 model = objects[gl_InstanceIndex].model;
+    vec3 objectColor = objects[gl_InstanceIndex].color.rgb;
+    float objectAlpha = 1.0;
+    uint textureIndex = 0;
+#elif defined(HAS_OBJECT_BUFFER)
+    mat4 model = frameObjects[gl_InstanceIndex].model;
+    vec3 objectColor = frameObjects[gl_InstanceIndex].color.rgb;
+    float objectAlpha = frameObjects[gl_InstanceIndex].color.a;
+    uint textureIndex = frameObjects[gl_InstanceIndex].textureIndex;
+#elif defined(HAS_INSTANCING)
+    mat4 model = instanceModel;
+    vec3 objectColor = instanceColor;
+    float objectAlpha = 1.0;
+    uint textureIndex = instanceTextureIndex;
+#else
+    mat4 model = push.model;
+    vec3 objectColor = push.color;
+    float objectAlpha = 1.0;
+    uint textureIndex = push.textureIndex;
+#endif
+
+#ifdef HAS_BINDLESS
+    fragTextureIndex = textureIndex;
+#endif
+
+    fragColor = USE_VERTEX_COLOR ? inColor : objectColor;
+    fragAlpha = objectAlpha;
+
+#ifdef HAS_UBO_COLOR
+    fragColor *= ColorUbo.color;
+    fragAlpha = ColorUbo.alpha;
+#endif
+
+#ifdef HAS_TEXTURE
+    fragTexCoord = inTexCoord;
+#else
+    fragTexCoord = vec2(0.0);
+#endif
+
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+    fragPos = worldPos.xyz;
+
+#ifdef HAS_NORMAL
+    fragNormal = normalize(mat3(transpose(inverse(model))) * inNormal);
+#else
+    fragNormal = vec3(0.0, 0.0, 1.0);
+#endif
+
+    gl_Position = MvpUbo.proj * MvpUbo.view * worldPos;
+}
@@ -1,12 +1,61 @@
 ﻿#include "VulkanBase.h"
 
 #include "PrintMsg.h"
+#include "VulkanPipelineManifest.h"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 
 namespace VKB
 {
 
+namespace
+{
+// 管线缓存与清单，运行结束时写回，下次启动预热
+const char *PIPELINE_CACHE_FILE = "PipelineCache.bin";
+const char *PIPELINE_MANIFEST_FILE = "PipelineManifest.txt";
+
+// 网格烘焙文件（含 LOD 链），源网格变化时重新生成
+const char *MESH_CACHE_FILE = "CubeMesh.bin";
+
+// 垂直视场角（度）
+constexpr float CAMERA_FOV_Y = 45.0f;
+
+// 投影远平面，同时用于归一化排序深度
+constexpr float CAMERA_FAR = 10.0f;
+
+// LOD 选择：允许的屏幕空间误差（像素）和切换滞后比例
+constexpr float LOD_PIXEL_ERROR = 1.0f;
+constexpr float LOD_HYSTERESIS = 0.25f;
+
+// GPU 驱动模式的静态场景：网格边长（物体数为平方）、间距、缩放
+constexpr uint32_t GPU_SCENE_SIZE = 64;
+constexpr float GPU_SCENE_SPACING = 1.5f;
+constexpr float GPU_SCENE_SCALE = 0.5f;
+
+// 实例缓冲的初始容量（实例个数），不足时自动扩容
+constexpr uint32_t INSTANCE_BUFFER_CAPACITY = 1024;
+
+// 逐物体缓冲的初始容量（物体个数），不足时自动扩容
+constexpr uint32_t OBJECT_BUFFER_CAPACITY = 1024;
+
+// Bindless 纹理表容量（受设备限制裁剪）
+constexpr uint32_t BINDLESS_TEXTURE_CAPACITY = 4096;
+
+// 并行帧数上限
+constexpr uint32_t MAX_PRESENT_FRAMES = 3;
+
+std::string formatBinds(const RenderQueueStats &stats)
+{
+    return "调用 " + std::to_string(stats.drawCalls) + " / 管线 "
+           + std::to_string(stats.pipelineBinds) + " / 描述符 "
+           + std::to_string(stats.descriptorBinds) + " / 顶点 "
+           + std::to_string(stats.vertexBufferBinds) + " / 索引 "
+           + std::to_string(stats.indexBufferBinds);
+}
+} // namespace
+
 VulkanBase::VulkanBase()
 {
     _instance = new VulkanInstance();
@@ -18,14 +67,17 @@ VulkanBase::VulkanBase()
     _framebuffer = new VulkanFramebuffer();
     _commandPool = new VulkanCommandPool();
     _commandBuffer = new VulkanCommandBuffer();
+    _commandAllocator = new VulkanCommandAllocator();
+    _jobSystem = new PSG::JobSystem();
+    _parallelRecorder = new VulkanParallelRecorder();
+    _commandCache = new VulkanCommandCache();
+    _indirectRenderer = new VulkanIndirectRenderer();
+    _framePacer = new VulkanFramePacer();
+    _bindlessTable = new VulkanBindlessTable();
     _pipelineLayout = new VulkanPipelineLayout();
-    _pipeline = new VulkanPipeline();
+    _pipelineRegistry = new VulkanPipelineRegistry();
     _sync = new VulkanSync();
 
-    _shaderModule.resize(2);
-    _shaderModule[0] = new VulkanShaderModule();
-    _shaderModule[1] = new VulkanShaderModule();
-
     _vertexBuffer = new VulkanVertexBuffer();
     _indexBuffer = new VulkanIndexBuffer();
 
@@ -38,8 +90,6 @@ VulkanBase::VulkanBase()
     _msaaColorBuffer = new VulkanMsaaColorBuffer();
 
     _sampler = new VulkanSampler();
-
-    _textures.resize(MAX_FRAMES_IN_FLIGHT);
 }
 
 VulkanBase::~VulkanBase()
@@ -71,15 +121,37 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
         return false;
     }
 
+    _useDynamicRendering = _preferDynamicRendering
+                           && _device->GetEnabledFeatures().dynamicRendering;
+
+    if (_bindless && !_device->GetEnabledFeatures().descriptorIndexing) {
+        PSG::PrintError("设备不支持描述符索引，回退到逐帧纹理绑定!");
+        _bindless = false;
+    }
+    PSG::PrintMsg("渲染路径",
+                  _useDynamicRendering ? "DynamicRendering" : "RenderPass");
+
     glfwGetFramebufferSize(window, &_width, &_height);
 
+    // 并行帧数决定每帧资源的份数，之后不再变化
+    MAX_FRAMES_IN_FLIGHT =
+        std::clamp(_presentConfig.framesInFlight, 1u, MAX_PRESENT_FRAMES);
+    _presentConfig.framesInFlight = MAX_FRAMES_IN_FLIGHT;
+    _textures.resize(MAX_FRAMES_IN_FLIGHT);
+
     // 创建交换链之前，必须先创建 Surface 和选择物理设备，因为交换链的创建
     if (!_swapchain->Init(
             _physicalDevice->Get(), _device->Get(), _surface->Get(),
             _physicalDevice->GetGraphicsQueueFamily(),
-            _physicalDevice->GetPresentQueueFamily(), _width, _height)) {
+            _physicalDevice->GetPresentQueueFamily(), _width, _height,
+            _presentConfig)) {
         return false;
     }
+    PSG::PrintMsg("呈现模式",
+                  PresentModeName(_swapchain->GetPresentMode()) + ", "
+                      + std::to_string(_swapchain->GetImageViewCount())
+                      + " 张图像, " + std::to_string(MAX_FRAMES_IN_FLIGHT)
+                      + " 帧并行");
 
     // -------------------------
     // 颜色附件
@@ -119,7 +191,9 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
         AttachmentType::RESOLVE);        // 附件类型
 
     // 创建必须在 Framebuffer 之前，因为 Framebuffer 需要RenderPass 的句柄
-    if (!_renderPass->Init(_device->Get(), _attachmentDesc)) {
+    // 动态渲染不需要 RenderPass
+    if (!_useDynamicRendering
+        && !_renderPass->Init(_device->Get(), _attachmentDesc)) {
         return false;
     }
 
@@ -131,46 +205,56 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
     }
 
     // 深度缓冲的创建必须在 Framebuffer 之前，因为 Framebuffer 需要它的
+    // GPU 驱动时深度缓冲还要生成遮挡剔除的 Hi-Z 金字塔，需要可采样
     if (!_depthBuffer->Init(_physicalDevice->Get(), _device->Get(),
                             _swapchain->GetExtent(),
-                            _physicalDevice->GetMsaaSamples())) {
+                            _physicalDevice->GetMsaaSamples(), _gpuDriven)) {
         return false;
     }
 
     // 然后在创建 Framebuffer 时，把深度缓冲 ImageView 也加入 attachments
-    if (!_framebuffer->Init(
-            _device->Get(), _renderPass->Get(), _swapchain->GetImageViews(),
-            _msaaColorBuffer->GetImageView(), _depthBuffer->GetImageView(),
-            _swapchain->GetExtent())) {
+    if (!createFramebuffer()) {
         return false;
     }
 
-    // CommandPool 的创建必须在 Framebuffer 之后，因为 CommandBuffer
-    // 需要知道交换链图像数量
+    // 一次性上传（顶点 / 索引 / 纹理）使用的命令池
     if (!_commandPool->Init(_device->Get(),
                             _physicalDevice->GetGraphicsQueueFamily())) {
         return false;
     }
 
+    // 各级 LOD 共用顶点，索引拼接在一个索引缓冲中
+    cookMesh();
+
     // =========================
     // 创建 VertexBuffer
     // =========================
-    _vertexCount = static_cast<uint32_t>(_vertices.size());
+    _vertexCount = static_cast<uint32_t>(_mesh.vertices.size());
+
+    PTF_3D boundsMin(std::numeric_limits<float>::max());
+    PTF_3D boundsMax(-std::numeric_limits<float>::max());
+    for (const VerCorTexNor &vertex : _mesh.vertices) {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    _meshCenter = (boundsMin + boundsMax) * 0.5f;
+    _meshExtent = (boundsMax - boundsMin) * 0.5f;
+
     if (!_vertexBuffer->Init(_physicalDevice->Get(), _device->Get(),
                              _commandPool->Get(), _device->GetGraphicsQueue(),
-                             _vertices.data(),
-                             sizeof(VerCorTexNor) * _vertices.size())) {
+                             _mesh.vertices.data(),
+                             sizeof(VerCorTexNor) * _mesh.vertices.size())) {
         return false;
     }
 
     // =========================
     // 创建 IndexBuffer
     // =========================
-    _indexCount = static_cast<uint32_t>(_indices.size());
+    _indexCount = _mesh.lods[0].indexCount;
     if (!_indexBuffer->Init(_physicalDevice->Get(), _device->Get(),
                             _commandPool->Get(), _device->GetGraphicsQueue(),
-                            _indices.data(),
-                            sizeof(uint32_t) * _indices.size())) {
+                            _mesh.indices.data(),
+                            sizeof(uint32_t) * _mesh.indices.size())) {
         return false;
     }
 
@@ -182,23 +266,52 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
     // =========================
     // 创建 Texture
     // =========================
-    if (!_textures[0].InitFromFile(
-            _physicalDevice->Get(), _device->Get(), _commandPool->Get(),
-            _device->GetGraphicsQueue(), "Res/Image/statue.jpg")) {
-        return false;
+    for (auto &texture : _textures) {
+        if (!texture.InitFromFile(_physicalDevice->Get(), _device->Get(),
+                                  _commandPool->Get(),
+                                  _device->GetGraphicsQueue(),
+                                  "Res/Image/statue.jpg")) {
+            return false;
+        }
     }
 
-    if (!_textures[1].InitFromFile(
-            _physicalDevice->Get(), _device->Get(), _commandPool->Get(),
-            _device->GetGraphicsQueue(), "Res/Image/statue.jpg")) {
+    // Bindless：纹理注册一次，之后只按下标引用
+    if (_bindless) {
+        if (!_bindlessTable->Init(_physicalDevice->Get(), _device->Get(),
+                                  BINDLESS_TEXTURE_CAPACITY)) {
+            return false;
+        }
+
+        for (auto &texture : _textures) {
+            const uint32_t index = _bindlessTable->Register(
+                texture.GetImageView(), _sampler->Get());
+            if (VulkanBindlessTable::INVALID_INDEX == index) {
+                return false;
+            }
+            _textureIndices.push_back(index);
+        }
+        PSG::PrintMsg("Bindless 纹理表",
+                      std::to_string(_bindlessTable->GetCount()) + " / "
+                          + std::to_string(_bindlessTable->GetCapacity()));
+    }
+
+    // 每帧一个命令池，帧命令缓冲与交换链无关，重建交换链时不再重新分配
+    if (!_commandAllocator->Init(_device->Get(),
+                                 _physicalDevice->GetGraphicsQueueFamily(),
+                                 MAX_FRAMES_IN_FLIGHT)) {
         return false;
     }
 
-    if (!_commandBuffer->Init(_device->Get(), _commandPool->Get(),
-                              _swapchain->GetImageViewCount())) {
+    if (!_commandBuffer->Init(_device->Get(), _commandAllocator->GetPools())) {
         return false;
     }
 
+    // GPU 驱动：上传静态场景并创建剔除管线，失败时回退到 CPU 录制
+    if (_gpuDriven && !createGpuScene()) {
+        PSG::PrintError("GPU 驱动渲染初始化失败，回退到 CPU 录制!");
+        _gpuDriven = false;
+    }
+
     // 创建描述符集布局绑定
     VkDescriptorSetLayoutBinding uboMvpBindind = _descriptorSetLayout->Make(
         0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
@@ -215,14 +328,27 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
     VkDescriptorSetLayoutBinding lightBindind = _descriptorSetLayout->Make(
         3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
 
+    // GPU 驱动的逐物体数据布局绑定
+    VkDescriptorSetLayoutBinding objectBindind = _descriptorSetLayout->Make(
+        4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
+
+    // 逐物体缓冲模式的每帧物体数据布局绑定
+    VkDescriptorSetLayoutBinding frameObjectBindind =
+        _descriptorSetLayout->Make(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                   VK_SHADER_STAGE_VERTEX_BIT);
+
     // 描述符数组
     std::vector<VkDescriptorSetLayoutBinding> bindings = {
-        uboMvpBindind, uboColorBindind, sampleBindind, lightBindind};
+        uboMvpBindind, uboColorBindind, sampleBindind, lightBindind,
+        objectBindind, frameObjectBindind};
 
     // 描述符集布局创建信息
     _descriptorSetLayout->Init(_device->Get(), bindings);
     std::vector<VkDescriptorSetLayout> setLayouts;
     setLayouts.push_back(_descriptorSetLayout->Get());
+    if (_bindless) {
+        setLayouts.push_back(_bindlessTable->GetLayout()); // 集合 1
+    }
 
     VkPushConstantRange pushRange{};
     pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
@@ -249,14 +375,42 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
                                     sizeof(LightInfo));
     }
 
+    // 实例化：每帧一个逐实例顶点缓冲
+    if (_instancing) {
+        _instanceBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto &instanceBuffer : _instanceBuffers) {
+            if (!instanceBuffer.Init(_physicalDevice->Get(), _device->Get(),
+                                     INSTANCE_BUFFER_CAPACITY)) {
+                PSG::PrintError("创建实例缓冲失败!");
+                return false;
+            }
+        }
+    }
+
+    // 逐物体缓冲：每帧一个存储缓冲，全部物体共用一次描述符绑定
+    if (_objectBuffer) {
+        _objectBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        for (auto &objectBuffer : _objectBuffers) {
+            if (!objectBuffer.Init(_physicalDevice->Get(), _device->Get(),
+                                   OBJECT_BUFFER_CAPACITY)) {
+                PSG::PrintError("创建物体缓冲失败!");
+                return false;
+            }
+        }
+    }
+
     // 描述符池创建信息
-    std::vector<VkDescriptorPoolSize> poolSizes(2);
+    std::vector<VkDescriptorPoolSize> poolSizes(3);
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     // 两个 UBO（MVP + Color + Light） 所以 * 3 （根据Unifrom 数量定）
     poolSizes[0].descriptorCount =
         static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 3);
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    // GPU 驱动物体 + 逐物体缓冲 两个存储缓冲
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[2].descriptorCount =
+        static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * 2);
 
     if (!_descriptorPool->Init(_device->Get(), MAX_FRAMES_IN_FLIGHT,
                                poolSizes)) {
@@ -272,52 +426,307 @@ int VulkanBase::InitVulkan(GLFWwindow *window)
         return false;
     }
 
-    // 配置描述符类
+    // 配置描述符类（每帧的全部绑定通过布局生成的更新模板一次写入）
     VulkanDescriptorSet descriptorSet;
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        // 配置描述符
-        descriptorSet.Init(_device->Get(), _descriptorSets[i]);
+        stageFrameDescriptors(descriptorSet, i);
+        descriptorSet.Flush();
+    }
 
-        descriptorSet.UpdateBuffer(0, _uniformMVPBuffer[i].Get(),
-                                   _uniformMVPBuffer[i].GetSize());
+    // 支持管线库时按部分编译并快速链接，否则回退到完整管线
+    const bool usePipelineLibrary =
+        _device->GetEnabledFeatures().graphicsPipelineLibrary;
+    if (!_pipelineRegistry->Init(_device->Get(), usePipelineLibrary,
+                                 MAX_FRAMES_IN_FLIGHT, PIPELINE_CACHE_FILE)) {
+        return false;
+    }
 
-        descriptorSet.UpdateBuffer(1, _uniformColorBuffer[i].Get(),
-                                   _uniformColorBuffer[i].GetSize());
+    // 扩展动态状态：剔除 / 深度 / 拓扑等不再产生新的管线
+    uint32_t dynamicStates = DYNAMIC_STATE_NONE;
+    if (_device->GetEnabledFeatures().extendedDynamicState) {
+        dynamicStates |= DYNAMIC_STATE_EXTENDED;
+    }
+    if (_device->GetEnabledFeatures().extendedDynamicState3PolygonMode) {
+        dynamicStates |= DYNAMIC_STATE_POLYGON_MODE;
+    }
+    _dynamicStateCache.Init(dynamicStates, _device->GetCmdSetPolygonMode());
+    _pipelineRegistry->SetDynamicStates(_dynamicStateCache.GetDynamicStates());
+    setupDynamicStateCache();
 
-        descriptorSet.UpdateBuffer(2, _textures[0].GetImageView(),
-                                   _sampler->Get());
+    // 帧任务调度：排序、并行录制等作为任务分散到各核心
+    if (!_jobSystem->Init()) {
+        return false;
+    }
+    _renderQueue.SetJobSystem(_jobSystem);
+    _frustumCuller.SetJobSystem(_jobSystem);
+    _transforms.SetJobSystem(_jobSystem);
+    PSG::PrintMsg("任务线程", std::to_string(_jobSystem->GetWorkerCount()));
+
+    // CPU 录制的场景：变换层级与逐物体数据
+    createScene();
+
+    // 并行录制：每段每帧一个命令池，段作为任务执行
+    if (_parallelRecording) {
+        if (!_parallelRecorder->Init(_device->Get(),
+                                     _physicalDevice->GetGraphicsQueueFamily(),
+                                     MAX_FRAMES_IN_FLIGHT, _jobSystem)) {
+            return false;
+        }
+        _parallelRecorder->SetDynamicStates(
+            _dynamicStateCache.GetDynamicStates(),
+            _device->GetCmdSetPolygonMode());
+        PSG::PrintMsg("并行录制分段",
+                      std::to_string(_parallelRecorder->GetSliceCount()));
+    }
+
+    // 命令缓存：独立命令池，录制结果跨帧保留
+    if (_commandCaching) {
+        if (!_commandCache->Init(_device->Get(),
+                                 _physicalDevice->GetGraphicsQueueFamily(),
+                                 MAX_FRAMES_IN_FLIGHT)) {
+            return false;
+        }
+        _commandCache->SetDynamicStates(_dynamicStateCache.GetDynamicStates(),
+                                        _device->GetCmdSetPolygonMode());
+    }
+
+    // 纹理 + 法线 + 光照 变体
+    const uint32_t features = SHADER_FEATURE_TEXTURE | SHADER_FEATURE_NORMAL
+                              | SHADER_FEATURE_LIGHTING;
+
+    PipelineStateDesc pipelineDesc{};
+    pipelineDesc.vertex = {"Uber", VK_SHADER_STAGE_VERTEX_BIT, features};
+    pipelineDesc.fragment = {"Uber", VK_SHADER_STAGE_FRAGMENT_BIT, features};
+    pipelineDesc.renderPass = _renderPass->Get();
+    if (_useDynamicRendering) {
+        // 动态渲染：管线只与附件格式相关
+        pipelineDesc.renderPass = VK_NULL_HANDLE;
+        pipelineDesc.colorFormat = _swapchain->GetFormat();
+        pipelineDesc.depthFormat = _depthBuffer->GetFormat();
+    }
+    pipelineDesc.layout = _pipelineLayout->Get();
+    pipelineDesc.samples = _physicalDevice->GetMsaaSamples();
+
+    // 预热：并行创建上次运行用到的全部管线
+    VulkanPipelineManifest manifest;
+    if (manifest.Load(PIPELINE_MANIFEST_FILE)) {
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t created =
+            _pipelineRegistry->WarmUp(manifest.Resolve(pipelineDesc));
+        auto end = std::chrono::high_resolution_clock::now();
+        float ms =
+            std::chrono::duration<float, std::milli>(end - start).count();
+        PSG::PrintMsg("管线预热", std::to_string(created) + " 个, "
+                                      + std::to_string(ms) + " ms");
+    }
+
+    // Bindless 变体：纹理从纹理表按逐物体下标采样
+    PipelineStateDesc baseDesc = pipelineDesc;
+    if (_bindless) {
+        pipelineDesc.vertex.features |= SHADER_FEATURE_BINDLESS;
+        pipelineDesc.fragment.features |= SHADER_FEATURE_BINDLESS;
+    }
+
+    _pipeline = _pipelineRegistry->GetPipeline(pipelineDesc);
+    if (!_pipeline && _bindless) {
+        PSG::PrintError("Bindless 管线创建失败，回退到逐帧纹理绑定!");
+        _bindless = false;
+        _textureIndices.clear();
+        pipelineDesc = baseDesc;
+        _pipeline = _pipelineRegistry->GetPipeline(pipelineDesc);
+    }
+    if (!_pipeline) {
+        return false;
+    }
+
+    // GPU 驱动变体：只有顶点阶段不同，片段着色器共用
+    // 物体数据中没有纹理下标，使用绑定 2 的纹理
+    if (_gpuDriven) {
+        PipelineStateDesc gpuDrivenDesc = baseDesc;
+        gpuDrivenDesc.vertex.features |= SHADER_FEATURE_GPU_DRIVEN;
+        _gpuDrivenPipeline = _pipelineRegistry->GetPipeline(gpuDrivenDesc);
+        if (!_gpuDrivenPipeline) {
+            PSG::PrintError("GPU 驱动管线创建失败，回退到 CPU 录制!");
+            _gpuDriven = false;
+        }
+    }
 
-        descriptorSet.UpdateBuffer(3, _uniformLightBuffer[i].Get(),
-                                   _uniformLightBuffer[i].GetSize());
+    // 实例化变体：顶点输入多一个逐实例绑定，片段着色器共用
+    if (_instancing) {
+        PipelineStateDesc instancedDesc = pipelineDesc;
+        instancedDesc.vertex.features |= SHADER_FEATURE_INSTANCING;
+        _instancedPipeline = _pipelineRegistry->GetPipeline(instancedDesc);
+        if (!_instancedPipeline) {
+            PSG::PrintError("实例化管线创建失败，回退到逐物体绘制!");
+            _instancing = false;
+        }
     }
 
-    _shaderModule[0]->Init(_device->Get(),
-                           "Res\\Shaders\\VerMVPColorPushTexLight.spv",
-                           VK_SHADER_STAGE_VERTEX_BIT);
-    _shaderModule[1]->Init(_device->Get(),
-                           "Res\\Shaders\\VerMVPColorPushTexLightFrag.spv",
-                           VK_SHADER_STAGE_FRAGMENT_BIT);
+    // 逐物体缓冲变体：物体数据来自存储缓冲，不再使用 Push Constant
+    if (_objectBuffer) {
+        PipelineStateDesc objectDesc = pipelineDesc;
+        objectDesc.vertex.features |= SHADER_FEATURE_OBJECT_BUFFER;
+        _objectPipeline = _pipelineRegistry->GetPipeline(objectDesc);
+        if (!_objectPipeline) {
+            PSG::PrintError("逐物体缓冲管线创建失败，回退到 Push Constant!");
+            _objectBuffer = false;
+        }
+    }
+    if (_gpuDriven) {
+        const char *drawMode = _indirectRenderer->IsUsingDrawCount()
+                                   ? "DrawIndirectCount"
+                                   : "MultiDrawIndirect";
+        const char *cullMode = _indirectRenderer->IsOcclusionCulling()
+                                   ? "视锥体 + Hi-Z 遮挡剔除"
+                                   : "视锥体剔除";
+        PSG::PrintMsg("GPU 驱动渲染",
+                      std::to_string(_indirectRenderer->GetObjectCount())
+                          + " 个物体, " + drawMode + ", " + cullMode);
+    }
 
-    if (!_pipeline->Init(_device->Get(), _renderPass->Get(),
-                         _pipelineLayout->Get(), _shaderModule,
-                         _swapchain->GetExtent(),
-                         _physicalDevice->GetMsaaSamples())) {
+    // 同步对象按帧序号索引，数量不能少于并行帧数
+    if (!_sync->Init(_device->Get(),
+                     std::max(_swapchain->GetImageViewCount(),
+                              MAX_FRAMES_IN_FLIGHT))) {
         return false;
     }
 
-    if (!_sync->Init(_device->Get(), _swapchain->GetImageViewCount())) {
+    // present_wait：设备不支持时只统计 GPU 完成延迟
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+    if (_presentConfig.presentWait) {
+        waitForPresent = _device->GetWaitForPresent();
+        if (nullptr == waitForPresent) {
+            PSG::PrintError("设备不支持 present_wait，不按显示时间节拍!");
+        }
+    }
+    if (!_framePacer->Init(_device->Get(), waitForPresent,
+                           MAX_FRAMES_IN_FLIGHT)) {
         return false;
     }
+    _framePacer->SetSwapchain(_swapchain->Get(), _swapchain->GetPresentMode());
+
+    // 流水线模式：之后的 Vulkan 录制与提交都在渲染线程
+    if (_pipelinedFrames) {
+        _renderThread = std::thread(&VulkanBase::renderLoop, this);
+    }
+    PSG::PrintMsg("帧流水线", _pipelinedFrames ? "模拟 / 渲染线程" : "单线程");
 
     _initialized = true;
     return true;
 }
 
 int VulkanBase::DrawFrame()
+{
+    if (!_pipelinedFrames) {
+        simulate(_packet);
+        return renderFrame(_packet);
+    }
+
+    // 渲染线程仍在读取要写的槽位时等待（模拟最多领先一帧）
+    simulate(_framePackets.BeginWrite());
+    _framePackets.EndWrite();
+    return 0;
+}
+
+void VulkanBase::simulate(FramePacket &packet)
+{
+    // --- 时间计算 ---
+    static auto startTime = std::chrono::high_resolution_clock::now();
+    auto currentTime = std::chrono::high_resolution_clock::now();
+    float time = std::chrono::duration<float, std::chrono::seconds::period>(
+                     currentTime - startTime)
+                     .count();
+
+    packet.tick = ++_tick;
+
+    // 窗口查询只能在主线程，交给渲染线程重建交换链时使用
+    glfwGetFramebufferSize(_window, &packet.width, &packet.height);
+
+    // ====== 场景变换 ======
+    // 只有旋转节点的子树被重算；物体节点的世界矩阵直接写入逐物体数据
+    _transforms.SetLocal(_spinNode,
+                         glm::rotate(MAT_4(1.0f), time * glm::radians(90.0f),
+                                     PTF_3D(0.0f, 0.0f, 1.0f)));
+    _transforms.Update(&_sceneObjects[0].model, sizeof(PushObject));
+
+    // ====== MVP ======
+    MvpMatrix &ubo = packet.mvp;
+    ubo.model = _transforms.GetWorld(_spinNode);
+
+    float radius = 5.0f;
+    float speed = glm::radians(45.0f);
+    float angle = time * speed;
+    float camX = radius * cos(angle);
+    float camY = radius * sin(angle);
+    float camZ = 1.0f;
+
+    glm::vec3 cameraPos(camX, camY, camZ);
+    packet.cameraPos = cameraPos;
+    ubo.view =
+        glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // 最小化时帧缓冲为 0（此时不会呈现）
+    const float aspect = packet.height > 0
+                             ? float(packet.width) / float(packet.height)
+                             : 1.0f;
+    ubo.proj =
+        glm::perspective(glm::radians(CAMERA_FOV_Y), aspect, 0.1f, CAMERA_FAR);
+    ubo.proj[1][1] *= -1; // glm Y轴反转
+
+    packet.viewProj = ubo.proj * ubo.view;
+
+    // ====== 颜色/透明度 ======
+    static bool firstCall = true;
+    if (firstCall) {
+        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+        firstCall = false;
+    }
+    packet.color.color = glm::vec3(1.0f);
+    packet.color.alpha = static_cast<float>(std::rand()) / RAND_MAX;
+
+    // ====== 光照信息 ======
+    LightInfo &lightUbo = packet.light;
+    lightUbo.lightPos =
+        PTF_3D(2.0f * sin(time), 2.0f, 2.0f * cos(time)); // 光源绕Y旋转
+    lightUbo.lightColor = PTF_3D(1.0f, 1.0f, 1.0f);       // 白光
+    lightUbo.viewPos = cameraPos;                         // 摄像机位置
+
+    // ====== 可见物体 ======
+    std::vector<PushObject> &pushObjects = packet.objects;
+    pushObjects = _sceneObjects;
+    packet.drawStates = _sceneDrawStates;
+
+    // Bindless：每秒轮换各物体的纹理，只改下标，不写描述符
+    if (!_textureIndices.empty()) {
+        const size_t offset = static_cast<size_t>(time);
+        for (size_t i = 0; i < pushObjects.size(); ++i) {
+            pushObjects[i].textureIndex =
+                _textureIndices[(i + offset) % _textureIndices.size()];
+        }
+    }
+}
+
+void VulkanBase::renderLoop()
+{
+    // Stop 之后返回空，线程退出
+    while (const FramePacket *packet = _framePackets.AcquireRead()) {
+        renderFrame(*packet);
+        _framePackets.ReleaseRead();
+    }
+}
+
+int VulkanBase::renderFrame(const FramePacket &packet)
 {
     // 1. 等待上一帧
     const auto &inFlightFence = _sync->GetInFlightFence(_currentFrame);
     vkWaitForFences(_device->Get(), 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+    _framePacer->FrameRetired(_currentFrame);
+
+    // 按节拍等待排队的呈现显示后，再开始本帧（采样输入）
+    _framePacer->BeginFrame(_currentFrame);
+
+    // 替换后台优化链接完成的管线
+    _pipelineRegistry->Update();
 
     // 2. 获取 Swapchain Image
     uint32_t imageIndex;
@@ -327,38 +736,19 @@ int VulkanBase::DrawFrame()
                               imageAvailable, VK_NULL_HANDLE, &imageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        recreateSwapchain();
+        recreateSwapchain(packet.width, packet.height);
         return 0;
     }
 
-    updateUniformBuffer(_currentFrame);
+    updateUniformBuffer(packet, _currentFrame);
     // updateTextureIfNeeded(_currentFrame);
 
     vkResetFences(_device->Get(), 1, &inFlightFence);
 
-    // 4. reset + record 当前帧的 CommandBuffer
-    VkCommandBuffer cb = _commandBuffer->Get(_currentFrame);
-    vkResetCommandBuffer(cb, 0);
-
-    std::vector<PushObject> pushObjects(5);
-    pushObjects[0].model = MAT_4(1.0f);
-    pushObjects[0].color = PTF_3D(1.0f);
-
-    pushObjects[1].model = glm::translate(MAT_4(1.0f), PTF_3D(2.0f, 0, 0));
-    pushObjects[1].color = PTF_3D(1.0f, 0.0, 0.0f);
-    pushObjects[2].model = glm::translate(MAT_4(1.0f), PTF_3D(-2.0f, 0, 0));
-    pushObjects[2].color = PTF_3D(0.0f, 1.0, 0.0f);
-    pushObjects[3].model = glm::translate(MAT_4(1.0f), PTF_3D(0, 2.0f, 0));
-    pushObjects[3].color = PTF_3D(0.0f, 0.0, 1.0f);
-    pushObjects[4].model = glm::translate(MAT_4(1.0f), PTF_3D(0, -2.0f, 0));
-    pushObjects[4].color = PTF_3D(1.0f, 0.0, 1.0f);
+    // 4. 整体重置当前帧的命令池 + record 当前帧的 CommandBuffer
+    _commandAllocator->BeginFrame(_currentFrame);
 
-    // 录制 CommandBuffer 绘制
-    _commandBuffer->Record(
-        _currentFrame, _renderPass->Get(), _framebuffer->Get()[imageIndex],
-        _swapchain->GetExtent(), _pipeline->Get(), _pipelineLayout->Get(),
-        _descriptorSets, _vertexBuffer->Get(), _indexBuffer->Get(), _indexCount,
-        pushObjects);
+    recordCommandBuffer(imageIndex, packet);
 
     // 3. 提交 CommandBuffer
     VkSubmitInfo submitInfo{};
@@ -390,13 +780,13 @@ int VulkanBase::DrawFrame()
     VkSwapchainKHR swapchains[] = {_swapchain->Get()};
     presentInfo.pSwapchains = swapchains;
     presentInfo.pImageIndices = &imageIndex;
+    _framePacer->PreparePresent(presentInfo);
 
     result = vkQueuePresentKHR(_device->GetPresentQueue(), &presentInfo);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR
-        || _framebufferResized) {
-        _framebufferResized = false;
-        recreateSwapchain();
+        || _framebufferResized.exchange(false)) {
+        recreateSwapchain(packet.width, packet.height);
     }
 
     // 前进到下一帧
@@ -404,24 +794,425 @@ int VulkanBase::DrawFrame()
     return 0;
 }
 
+void VulkanBase::recordCommandBuffer(uint32_t imageIndex,
+                                     const FramePacket &frame)
+{
+    // GPU 驱动：剔除与绘制参数都在 GPU 上生成，CPU 开销与物体数量无关
+    if (_gpuDriven) {
+        // 该帧栅栏已等待，回读槽位中是上一次使用该槽位时的统计
+        const GpuCullStats cullStats =
+            _indirectRenderer->GetStats(_currentFrame);
+        if (cullStats != _cullStats) {
+            _cullStats = cullStats;
+            PSG::PrintMsg(
+                "GPU 剔除",
+                "视锥体剔除 " + std::to_string(_cullStats.frustumCulled)
+                    + ", 遮挡剔除 " + std::to_string(_cullStats.occlusionCulled)
+                    + ", 绘制 " + std::to_string(_cullStats.earlyDrawn)
+                    + " + 补画 " + std::to_string(_cullStats.lateDrawn));
+        }
+
+        if (_useDynamicRendering) {
+            const VulkanDepthPyramid *depthPyramid =
+                _indirectRenderer->IsOcclusionCulling() ? _depthPyramid
+                                                        : nullptr;
+            _commandBuffer->Record(
+                _currentFrame, getRenderingAttachments(imageIndex),
+                _swapchain->GetExtent(), _gpuDrivenPipeline->Get(),
+                _pipelineLayout->Get(), _descriptorSets[_currentFrame],
+                _vertexBuffer->Get(), _indexBuffer->Get(), *_indirectRenderer,
+                depthPyramid);
+        } else {
+            _commandBuffer->Record(
+                _currentFrame, _renderPass->Get(),
+                _framebuffer->Get()[imageIndex], _swapchain->GetExtent(),
+                _gpuDrivenPipeline->Get(), _pipelineLayout->Get(),
+                _descriptorSets[_currentFrame], _vertexBuffer->Get(),
+                _indexBuffer->Get(), *_indirectRenderer);
+        }
+        return;
+    }
+
+    buildRenderQueue(frame, _objectBuffer);
+
+    // 逐物体数据写入本帧的存储缓冲，失败时回退到 Push Constant
+    if (_objectBuffer && !updateObjectBuffer()) {
+        PSG::PrintError("逐物体缓冲上传失败，回退到 Push Constant!");
+        _objectBuffer = false;
+        buildRenderQueue(frame, false);
+    }
+
+    // 合并后的逐实例数据写入本帧的实例缓冲（该帧栅栏已等待）
+    if (_instancing && !_objectBuffer) {
+        VulkanInstanceBuffer &instanceBuffer = _instanceBuffers[_currentFrame];
+        if (instanceBuffer.Update(_renderQueue.GetInstances())) {
+            _renderQueue.SetInstanceBuffer(instanceBuffer.Get());
+        } else {
+            // 无法上传时按逐物体绘制
+            _renderQueue.Sort(0, false);
+        }
+    }
+
+    // 绑定次数变化时输出排序前后的对比
+    if (_renderQueue.GetSortedStats() != _queueStats) {
+        _queueStats = _renderQueue.GetSortedStats();
+        PSG::PrintMsg("渲染队列",
+                      std::to_string(_queueStats.drawCount) + " 个 Draw, "
+                          + "排序前 "
+                          + formatBinds(_renderQueue.GetSubmitStats())
+                          + ", 排序后 " + formatBinds(_queueStats));
+    }
+
+    // 二级命令缓冲继承的渲染目标
+    SecondaryTarget target{};
+    target.samples = _physicalDevice->GetMsaaSamples();
+    if (_useDynamicRendering) {
+        target.colorFormat = _swapchain->GetFormat();
+        target.depthFormat = _depthBuffer->GetFormat();
+    } else {
+        target.renderPass = _renderPass->Get();
+        target.framebuffer = _framebuffer->Get()[imageIndex];
+    }
+
+    // 命令缓存：输入未变化时直接复用；并行录制：各线程录制二级命令缓冲
+    // 两种方式下主命令缓冲都只负责执行
+    std::vector<VkCommandBuffer> secondaries;
+    if (_commandCaching) {
+        VkCommandBuffer cached = _commandCache->Acquire(
+            _currentFrame, target, _swapchain->GetExtent(),
+            _pipelineLayout->Get(), _renderQueue);
+        if (cached != VK_NULL_HANDLE) {
+            secondaries.push_back(cached);
+        }
+    } else if (_parallelRecording) {
+        _parallelRecorder->Record(_currentFrame, target,
+                                  _swapchain->GetExtent(),
+                                  _pipelineLayout->Get(), _renderQueue,
+                                  secondaries);
+    }
+
+    // 没有得到二级命令缓冲（如缓存录制失败）时回退到主命令缓冲直接录制，
+    // 否则本帧会执行空的二级命令缓冲列表，画面为空
+    const bool useSecondaries = !secondaries.empty();
+
+    // 录制 CommandBuffer 绘制
+    if (_useDynamicRendering) {
+        RenderingAttachments attachments = getRenderingAttachments(imageIndex);
+
+        if (useSecondaries) {
+            _commandBuffer->Record(_currentFrame, attachments,
+                                   _swapchain->GetExtent(), secondaries);
+        } else {
+            _commandBuffer->Record(_currentFrame, attachments,
+                                   _swapchain->GetExtent(),
+                                   _pipelineLayout->Get(), _renderQueue);
+        }
+    } else if (useSecondaries) {
+        _commandBuffer->Record(_currentFrame, _renderPass->Get(),
+                               _framebuffer->Get()[imageIndex],
+                               _swapchain->GetExtent(), secondaries);
+    } else {
+        _commandBuffer->Record(_currentFrame, _renderPass->Get(),
+                               _framebuffer->Get()[imageIndex],
+                               _swapchain->GetExtent(), _pipelineLayout->Get(),
+                               _renderQueue);
+    }
+
+    // 主命令缓冲直接录制时，输出实际调用与过滤掉的冗余命令数
+    const CommandListStats &commandStats = _commandBuffer->GetCommandStats();
+    if (!useSecondaries && commandStats != _commandStats) {
+        _commandStats = commandStats;
+        PSG::PrintMsg("命令列表",
+                      std::to_string(_commandStats.draws) + " 次绘制, 调用 "
+                          + std::to_string(_commandStats.issued) + ", 过滤 "
+                          + std::to_string(_commandStats.filtered));
+    }
+}
+
+void VulkanBase::buildRenderQueue(const FramePacket &frame, bool objectBuffer)
+{
+    const std::vector<PushObject> &pushObjects = frame.objects;
+
+    // 每个物体的绘制状态（启用动态状态时逐 Draw 设置，冗余状态会被过滤）
+    const std::vector<DynamicDrawState> &drawStates = frame.drawStates;
+
+    // 视锥体剔除：只提交可见物体
+    _frustumCuller.Clear();
+    for (const PushObject &object : pushObjects) {
+        _frustumCuller.Add(object.model, _meshCenter, _meshExtent);
+    }
+    const std::vector<uint32_t> &visible =
+        _frustumCuller.Cull(Frustum::FromViewProj(frame.viewProj));
+
+    // 物体 LOD 跨帧保留，用于切换滞后
+    _objectLods.resize(pushObjects.size(), 0);
+    const float projectionScale = VulkanMeshLod::ProjectionScale(
+        float(frame.height), glm::radians(CAMERA_FOV_Y));
+
+    // 按排序键整理 Draw：同状态的相邻绘制，不透明由近到远
+    _renderQueue.Clear();
+    for (uint32_t i : visible) {
+        DrawPacket packet{};
+        packet.pipeline =
+            objectBuffer ? _objectPipeline->Get() : _pipeline->Get();
+        if (_instancing && !objectBuffer) {
+            packet.instancedPipeline = _instancedPipeline->Get();
+        }
+        packet.descriptorSet = _descriptorSets[_currentFrame];
+        packet.vertexBuffer = _vertexBuffer->Get();
+        packet.indexBuffer = _indexBuffer->Get();
+        packet.pushObject = pushObjects[i];
+        packet.drawState = drawStates[i];
+
+        const MAT_4 &model = pushObjects[i].model;
+        const PTF_3D position = PTF_3D(model[3]);
+        const float distance = glm::distance(position, frame.cameraPos);
+
+        // 按投影到屏幕的几何误差选择 LOD
+        const float scale = std::max({glm::length(PTF_3D(model[0])),
+                                      glm::length(PTF_3D(model[1])),
+                                      glm::length(PTF_3D(model[2]))});
+        _objectLods[i] = VulkanMeshLod::SelectLod(
+            _mesh.lods, scale, distance, projectionScale, _objectLods[i],
+            LOD_PIXEL_ERROR, LOD_HYSTERESIS);
+
+        const MeshLod &lod = _mesh.lods[_objectLods[i]];
+        packet.firstIndex = lod.firstIndex;
+        packet.indexCount = lod.indexCount;
+
+        const float depth = distance / CAMERA_FAR;
+        _renderQueue.Submit(packet, 0, false, depth);
+    }
+    if (_bindless) {
+        _renderQueue.SetBindlessSet(_bindlessTable->Get());
+    }
+    _renderQueue.Sort(0, _instancing, objectBuffer);
+}
+
+bool VulkanBase::updateObjectBuffer()
+{
+    VulkanObjectBuffer &objectBuffer = _objectBuffers[_currentFrame];
+    const VkBuffer previous = objectBuffer.Get();
+    if (!objectBuffer.Update(_renderQueue.GetObjects())) {
+        return false;
+    }
+
+    // 扩容后缓冲已更换：重写本帧的描述符（该帧栅栏已等待，未在使用）
+    if (objectBuffer.Get() != previous) {
+        VulkanDescriptorSet descriptorSet;
+        descriptorSet.Init(_device->Get(), _descriptorSets[_currentFrame],
+                           _descriptorSetLayout);
+        descriptorSet.UpdateBuffer(
+            5, objectBuffer.Get(),
+            static_cast<uint32_t>(objectBuffer.GetSize()),
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        descriptorSet.Flush();
+
+        // 引用该描述符集的缓存命令缓冲随之失效
+        _commandCache->Invalidate();
+    }
+
+    return true;
+}
+
+RenderingAttachments
+VulkanBase::getRenderingAttachments(uint32_t imageIndex) const
+{
+    RenderingAttachments attachments{};
+    attachments.swapImage = _swapchain->GetImages()[imageIndex];
+    attachments.swapImageView = _swapchain->GetImageViews()[imageIndex];
+    attachments.depthImage = _depthBuffer->GetImage();
+    attachments.depthImageView = _depthBuffer->GetImageView();
+    attachments.depthFormat = _depthBuffer->GetFormat();
+    if (_physicalDevice->GetMsaaSamples() != VK_SAMPLE_COUNT_1_BIT) {
+        attachments.msaaImage = _msaaColorBuffer->GetImage();
+        attachments.msaaImageView = _msaaColorBuffer->GetImageView();
+    }
+    return attachments;
+}
+
+void VulkanBase::BenchmarkDescriptorUpdates()
+{
+    // 描述符集不能在 GPU 使用时更新
+    vkDeviceWaitIdle(_device->Get());
+
+    VulkanDescriptorSet descriptorSet;
+    stageFrameDescriptors(descriptorSet, 0);
+    descriptorSet.Benchmark();
+}
+
+void VulkanBase::stageFrameDescriptors(VulkanDescriptorSet &descriptorSet,
+                                       int frame)
+{
+    // 配置描述符
+    descriptorSet.Init(_device->Get(), _descriptorSets[frame],
+                       _descriptorSetLayout);
+
+    descriptorSet.UpdateBuffer(0, _uniformMVPBuffer[frame].Get(),
+                               _uniformMVPBuffer[frame].GetSize());
+
+    descriptorSet.UpdateBuffer(1, _uniformColorBuffer[frame].Get(),
+                               _uniformColorBuffer[frame].GetSize());
+
+    descriptorSet.UpdateBuffer(2, _textures[0].GetImageView(),
+                               _sampler->Get());
+
+    descriptorSet.UpdateBuffer(3, _uniformLightBuffer[frame].Get(),
+                               _uniformLightBuffer[frame].GetSize());
+
+    if (_gpuDriven) {
+        descriptorSet.UpdateBuffer(
+            4, _indirectRenderer->GetObjectBuffer(),
+            static_cast<uint32_t>(_indirectRenderer->GetObjectBufferSize()),
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    }
+
+    if (_objectBuffer) {
+        descriptorSet.UpdateBuffer(
+            5, _objectBuffers[frame].Get(),
+            static_cast<uint32_t>(_objectBuffers[frame].GetSize()),
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    }
+}
+
+void VulkanBase::createScene()
+{
+    _transforms.Clear();
+    _sceneObjects.clear();
+    _sceneDrawStates.clear();
+
+    // 场景根节点（不输出物体）
+    const uint32_t root =
+        _transforms.Add(VulkanTransformHierarchy::INVALID_NODE, MAT_4(1.0f));
+
+    auto addObject = [&](const PTF_3D &position, const PTF_3D &color,
+                         const DynamicDrawState &drawState) {
+        PushObject object{};
+        object.color = color;
+        _sceneObjects.push_back(object);
+        _sceneDrawStates.push_back(drawState);
+
+        const uint32_t slot = static_cast<uint32_t>(_sceneObjects.size() - 1);
+        return _transforms.Add(root, glm::translate(MAT_4(1.0f), position),
+                               slot);
+    };
+
+    // 旋转节点绕 Z 轴旋转，只驱动 ubo.model，不输出物体
+    _spinNode = _transforms.Add(root, MAT_4(1.0f));
+
+    // 不透明物体：三角形列表、不剔除、深度测试 + 写入，与基础管线一致
+    DynamicDrawState opaque{};
+    opaque.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    opaque.cullMode = VK_CULL_MODE_NONE;
+    opaque.depthTestEnable = VK_TRUE;
+    opaque.depthWriteEnable = VK_TRUE;
+    opaque.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    // 五个物体都静止
+    addObject(PTF_3D(0.0f), PTF_3D(1.0f), opaque);
+    addObject(PTF_3D(2.0f, 0.0f, 0.0f), PTF_3D(1.0f, 0.0f, 0.0f), opaque);
+    addObject(PTF_3D(-2.0f, 0.0f, 0.0f), PTF_3D(0.0f, 1.0f, 0.0f), opaque);
+    addObject(PTF_3D(0.0f, 2.0f, 0.0f), PTF_3D(0.0f, 0.0f, 1.0f), opaque);
+    addObject(PTF_3D(0.0f, -2.0f, 0.0f), PTF_3D(1.0f, 0.0f, 1.0f), opaque);
+}
+
+void VulkanBase::cookMesh()
+{
+    const uint64_t sourceHash = VulkanMeshLod::HashSource(_vertices, _indices);
+    if (VulkanMeshLod::Load(MESH_CACHE_FILE, sourceHash, _mesh)) {
+        return;
+    }
+
+    // 写回失败只影响下次启动，本次直接使用烘焙结果
+    VulkanMeshLod::Cook(_vertices, _indices, _mesh);
+    VulkanMeshLod::Save(MESH_CACHE_FILE, _mesh);
+}
+
+bool VulkanBase::createGpuScene()
+{
+    // 静态网格场景：GPU_SCENE_SIZE x GPU_SCENE_SIZE 个立方体
+    std::vector<GpuObject> objects;
+    objects.reserve(GPU_SCENE_SIZE * GPU_SCENE_SIZE);
+
+    const float half = 0.5f * GPU_SCENE_SPACING * (GPU_SCENE_SIZE - 1);
+    for (uint32_t y = 0; y < GPU_SCENE_SIZE; ++y) {
+        for (uint32_t x = 0; x < GPU_SCENE_SIZE; ++x) {
+            const PTF_3D position(x * GPU_SCENE_SPACING - half,
+                                  y * GPU_SCENE_SPACING - half, 0.0f);
+
+            GpuObject object{};
+            object.model = glm::translate(MAT_4(1.0f), position)
+                           * glm::scale(MAT_4(1.0f), PTF_3D(GPU_SCENE_SCALE));
+            object.color = PTF_4D(float(x) / GPU_SCENE_SIZE,
+                                  float(y) / GPU_SCENE_SIZE, 1.0f, 1.0f);
+
+            // 单位立方体的外接球半径为 sqrt(3) / 2
+            object.sphere =
+                PTF_4D(position, 0.8660254f * GPU_SCENE_SCALE);
+            object.indexCount = _indexCount;
+            objects.push_back(object);
+        }
+    }
+
+    // 金字塔与深度缓冲大小绑定，深度缓冲不可采样时只作为占位；
+    // 创建失败（如缺少 HiZ.spv）时 GPU 剔除只做视锥体测试
+    const bool hasPyramid = createDepthPyramid();
+
+    if (!_indirectRenderer->Init(
+            _physicalDevice->Get(), _device->Get(), _commandPool->Get(),
+            _device->GetGraphicsQueue(), _device->GetEnabledFeatures(), objects,
+            _depthPyramid, MAX_FRAMES_IN_FLIGHT,
+            _device->GetCmdPushDescriptorSetWithTemplate())) {
+        return false;
+    }
+
+    // 两个阶段之间需要结束渲染并生成金字塔，只在动态渲染下启用
+    _indirectRenderer->SetOcclusionCulling(hasPyramid && _occlusionCulling
+                                           && _useDynamicRendering);
+    return true;
+}
+
+bool VulkanBase::createDepthPyramid()
+{
+    _depthPyramid = new VulkanDepthPyramid();
+    if (!_depthPyramid->Init(_physicalDevice->Get(), _device->Get(),
+                             _commandPool->Get(), _device->GetGraphicsQueue(),
+                             *_depthBuffer)) {
+        // 创建了一半的金字塔不能再被录制
+        PSG::PrintError("创建 Hi-Z 金字塔失败，关闭遮挡剔除!");
+        SDelete(_depthPyramid);
+        return false;
+    }
+    return true;
+}
+
 void VulkanBase::Shutdown()
 {
     /* 销毁顺序不能乱*/
     if (!_initialized)
         return;
 
+    // 先停止渲染线程，之后的 Vulkan 调用都在当前线程
+    _framePackets.Stop();
+    if (_renderThread.joinable()) {
+        _renderThread.join();
+    }
+
     if (_device && _device->Get() != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(_device->Get());
     }
 
     cleanupSwapchain();
 
+    SDelete(_framePacer);
     SDelete(_sync);
 
     SDelete(_vertexBuffer);
     SDelete(_indexBuffer);
 
     _uniformMVPBuffer.clear();
+    _instanceBuffers.clear();
+    _objectBuffers.clear();
     _uniformColorBuffer.clear();
     _uniformLightBuffer.clear();
 
@@ -429,18 +1220,30 @@ void VulkanBase::Shutdown()
     SDelete(_descriptorPool);
     _descriptorSets.clear();
 
+    SDelete(_bindlessTable);
+    _textureIndices.clear();
     SDelete(_sampler);
     _textures.clear();
 
-    SDelete(_pipeline);
+    _pipeline = nullptr;
+    _gpuDrivenPipeline = nullptr;
+    _instancedPipeline = nullptr;
+    _objectPipeline = nullptr;
+    SDelete(_indirectRenderer);
+    _pipelineRegistry->SaveManifest(PIPELINE_MANIFEST_FILE);
+    _pipelineRegistry->SavePipelineCache();
+    SDelete(_pipelineRegistry);
     SDelete(_pipelineLayout);
     SDelete(_renderPass);
 
-    for (auto *shader : _shaderModule) {
-        SDelete(shader);
-    }
-    _shaderModule.clear();
-
+    SDelete(_parallelRecorder);
+    _renderQueue.SetJobSystem(nullptr);
+    _frustumCuller.SetJobSystem(nullptr);
+    _transforms.SetJobSystem(nullptr);
+    SDelete(_jobSystem);
+    SDelete(_commandCache);
+    SDelete(_commandBuffer);
+    SDelete(_commandAllocator);
     SDelete(_commandPool);
     SDelete(_device);
     SDelete(_physicalDevice);
@@ -460,15 +1263,16 @@ bool VulkanBase::createSurface(GLFWwindow *window)
     return _surface->Create(_instance->Get(), window);
 }
 
-void VulkanBase::recreateSwapchain()
+void VulkanBase::recreateSwapchain(int width, int height)
 {
     vkDeviceWaitIdle(_device->Get()); // 等待 GPU 空闲
 
-    // 获取最新窗口大小
-    glfwGetFramebufferSize(_window, &_width, &_height);
-    if (_width == 0 || _height == 0) {
+    // 窗口大小由主线程查询后随数据包传入
+    if (width == 0 || height == 0) {
         return; // 最小化时跳过
     }
+    _width = width;
+    _height = height;
 
     cleanupSwapchain();
 
@@ -476,7 +1280,9 @@ void VulkanBase::recreateSwapchain()
     _swapchain = new VulkanSwapchain();
     _swapchain->Init(_physicalDevice->Get(), _device->Get(), _surface->Get(),
                      _physicalDevice->GetGraphicsQueueFamily(),
-                     _physicalDevice->GetPresentQueueFamily(), _width, _height);
+                     _physicalDevice->GetPresentQueueFamily(), _width, _height,
+                     _presentConfig);
+    _framePacer->SetSwapchain(_swapchain->Get(), _swapchain->GetPresentMode());
 
     // 重新创建 多重采样颜色缓冲
     _msaaColorBuffer = new VulkanMsaaColorBuffer();
@@ -488,73 +1294,57 @@ void VulkanBase::recreateSwapchain()
     _depthBuffer = new VulkanDepthBuffer();
     _depthBuffer->Init(_physicalDevice->Get(), _device->Get(),
                        _swapchain->GetExtent(),
-                       _physicalDevice->GetMsaaSamples());
+                       _physicalDevice->GetMsaaSamples(), _gpuDriven);
+
+    // 重新创建 Hi-Z 金字塔，新金字塔生成前不做遮挡测试；
+    // 旧金字塔已销毁，失败时剔除改用占位图像并关闭遮挡剔除
+    if (_gpuDriven) {
+        const bool hasPyramid = createDepthPyramid();
+        _indirectRenderer->SetDepthPyramid(_depthPyramid);
+        _indirectRenderer->SetOcclusionCulling(hasPyramid && _occlusionCulling
+                                               && _useDynamicRendering);
+    }
 
-    // 重新创建 Framebuffer
+    // 重新创建 Framebuffer（动态渲染时不需要）
     _framebuffer = new VulkanFramebuffer();
-    _framebuffer->Init(_device->Get(), _renderPass->Get(),
-                       _swapchain->GetImageViews(),
-                       _msaaColorBuffer->GetImageView(),
-                       _depthBuffer->GetImageView(), _swapchain->GetExtent());
+    createFramebuffer();
 
-    // 重新创建 CommandBuffer
-    _commandBuffer = new VulkanCommandBuffer();
-    _commandBuffer->Init(_device->Get(), _commandPool->Get(),
-                         _swapchain->GetImageViewCount());
+    // 渲染目标已重建，缓存的命令缓冲全部重新录制
+    _commandCache->Invalidate();
 }
 
-void VulkanBase::updateUniformBuffer(uint32_t currentImage)
+void VulkanBase::setupDynamicStateCache()
 {
-    // --- 时间计算 ---
-    static auto startTime = std::chrono::high_resolution_clock::now();
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(
-                     currentTime - startTime)
-                     .count();
-
-    // ====== MVP ======
-    MvpMatrix ubo{};
-    ubo.model = glm::rotate(MAT_4(1.0f), time * glm::radians(90.0f),
-                            PTF_3D(0.0f, 0.0f, 1.0f));
-
-    float radius = 5.0f;
-    float speed = glm::radians(45.0f);
-    float angle = time * speed;
-    float camX = radius * cos(angle);
-    float camY = radius * sin(angle);
-    float camZ = 1.0f;
-
-    glm::vec3 cameraPos(camX, camY, camZ);
-    ubo.view =
-        glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    if (_dynamicStateCache.GetDynamicStates() != DYNAMIC_STATE_NONE) {
+        _commandBuffer->SetDynamicStateCache(&_dynamicStateCache);
+    }
+}
 
-    const auto &extent = _swapchain->GetExtent();
-    ubo.proj = glm::perspective(glm::radians(45.0f),
-                                float(extent.width) / float(extent.height),
-                                0.1f, 10.0f);
-    ubo.proj[1][1] *= -1; // glm Y轴反转
+bool VulkanBase::createFramebuffer()
+{
+    if (_useDynamicRendering) {
+        return true;
+    }
 
-    _uniformMVPBuffer[currentImage].Update(&ubo, sizeof(MvpMatrix));
+    return _framebuffer->Init(
+        _device->Get(), _renderPass->Get(), _swapchain->GetImageViews(),
+        _msaaColorBuffer->GetImageView(), _depthBuffer->GetImageView(),
+        _swapchain->GetExtent());
+}
 
-    // ====== 颜色/透明度 ======
-    static bool firstCall = true;
-    if (firstCall) {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        firstCall = false;
+void VulkanBase::updateUniformBuffer(const FramePacket &packet,
+                                     uint32_t currentImage)
+{
+    // 数据已在模拟线程算好，这里只写入本帧的缓冲（该帧栅栏已等待）
+    if (_gpuDriven) {
+        _indirectRenderer->SetFrustum(packet.viewProj);
     }
-    AlphaColor colorUbo{};
-    colorUbo.color = glm::vec3(1.0f);
-    colorUbo.alpha = static_cast<float>(std::rand()) / RAND_MAX;
-    _uniformColorBuffer[currentImage].Update(&colorUbo, sizeof(AlphaColor));
-
-    // ====== 光照信息 ======
-    LightInfo lightUbo{};
-    lightUbo.lightPos =
-        PTF_3D(2.0f * sin(time), 2.0f, 2.0f * cos(time)); // 光源绕Y旋转
-    lightUbo.lightColor = PTF_3D(1.0f, 1.0f, 1.0f);       // 白光
-    lightUbo.viewPos = cameraPos;                         // 摄像机位置
 
-    _uniformLightBuffer[currentImage].Update(&lightUbo, sizeof(LightInfo));
+    _uniformMVPBuffer[currentImage].Update(&packet.mvp, sizeof(MvpMatrix));
+    _uniformColorBuffer[currentImage].Update(&packet.color,
+                                             sizeof(AlphaColor));
+    _uniformLightBuffer[currentImage].Update(&packet.light,
+                                             sizeof(LightInfo));
 }
 
 void VulkanBase::updateTextureIfNeeded()
@@ -572,9 +1362,11 @@ void VulkanBase::updateTextureIfNeeded()
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
 
         // 配置描述符
-        descriptorSet.Init(_device->Get(), _descriptorSets[i]);
+        descriptorSet.Init(_device->Get(), _descriptorSets[i],
+                           _descriptorSetLayout);
         descriptorSet.UpdateBuffer(2, newTexture->GetImageView(),
                                    _sampler->Get());
+        descriptorSet.Flush();
     }
 
     // SDelete(_texture);
@@ -587,19 +1379,21 @@ void VulkanBase::updateTextureIfNeeded(uint32_t currentImage)
     VulkanDescriptorSet descriptorSet;
 
     // 配置描述符 只更新当前帧的描述符集
-    descriptorSet.Init(_device->Get(), _descriptorSets[currentImage]);
+    descriptorSet.Init(_device->Get(), _descriptorSets[currentImage],
+                       _descriptorSetLayout);
     descriptorSet.UpdateBuffer(2, _textures[currentImage].GetImageView(),
                                _sampler->Get());
+    descriptorSet.Flush();
 }
 
 void VulkanBase::cleanupSwapchain()
 {
     // 销毁旧资源
+    SDelete(_depthPyramid);
     SDelete(_depthBuffer);
     SDelete(_msaaColorBuffer);
 
     SDelete(_framebuffer);
-    SDelete(_commandBuffer);
     SDelete(_swapchain);
 }
 
@@ -3,28 +3,46 @@
 
 #include "MacroHead.h"
 
+#include <atomic>
+#include <thread>
+
 #include "VulkanAttachmentDesc.h"
+#include "VulkanBindlessTable.h"
+#include "VulkanCommandAllocator.h"
 #include "VulkanCommandBuffer.h"
+#include "VulkanCommandCache.h"
 #include "VulkanCommandPool.h"
 #include "VulkanDepthBuffer.h"
+#include "VulkanDepthPyramid.h"
 #include "VulkanDescriptorPool.h"
 #include "VulkanDescriptorSet.h"
 #include "VulkanDescriptorSetLayout.h"
 #include "VulkanDevice.h"
+#include "VulkanFramePacer.h"
+#include "VulkanFramePacket.h"
 #include "VulkanFramebuffer.h"
+#include "VulkanFrustumCuller.h"
+#include "VulkanIndirectRenderer.h"
 #include "VulkanIndexBuffer.h"
 #include "VulkanInstance.h"
+#include "VulkanInstanceBuffer.h"
+#include "VulkanMeshLod.h"
 #include "VulkanMsaaColorBuffer.h"
+#include "VulkanObjectBuffer.h"
+#include "VulkanParallelRecorder.h"
 #include "VulkanPhysicalDevice.h"
 #include "VulkanPipeline.h"
 #include "VulkanPipelineLayout.h"
+#include "VulkanPipelineRegistry.h"
 #include "VulkanRenderPass.h"
+#include "VulkanRenderQueue.h"
 #include "VulkanSamper.h"
 #include "VulkanShaderModule.h"
 #include "VulkanSurface.h"
 #include "VulkanSwapchain.h"
 #include "VulkanSync.h"
 #include "VulkanTexture.h"
+#include "VulkanTransformHierarchy.h"
 #include "VulkanUniformBuffer.h"
 #include "VulkanUtils.h"
 #include "VulkanVertexBuffer.h"
@@ -38,24 +56,187 @@ public:
     virtual ~VulkanBase();
 
     int InitVulkan(GLFWwindow *window);
+
+    /**
+     * @brief 推进一帧
+     *
+     * 流水线模式下只在主线程模拟并发布数据包，录制与提交在渲染线程；
+     * 否则模拟后直接在当前线程渲染
+     */
     int DrawFrame();
     void Shutdown();
 
+    /**
+     * @brief 描述符更新微基准（InitVulkan 之后、第一帧之前调用）
+     *
+     * 用第 0 帧的全部绑定比较逐个写入、合并写入与更新模板
+     */
+    void BenchmarkDescriptorUpdates();
+
 public:
     void SetFramebufferResized(bool resized)
     {
         _framebufferResized = resized;
     }
 
+    /**
+     * @brief 是否优先使用动态渲染（需在 InitVulkan 之前设置）
+     *
+     * 设备不支持时自动回退到 RenderPass + Framebuffer
+     */
+    void SetPreferDynamicRendering(bool prefer)
+    {
+        _preferDynamicRendering = prefer;
+    }
+
+    /**
+     * @brief 是否启用多线程命令录制（需在 InitVulkan 之前设置）
+     *
+     * Draw 数量较多时按线程切分，录制到二级命令缓冲
+     */
+    void SetParallelRecording(bool enable)
+    {
+        _parallelRecording = enable;
+    }
+
+    /**
+     * @brief 是否启用 GPU 驱动渲染（需在 InitVulkan 之前设置）
+     *
+     * 静态场景由计算着色器剔除并生成间接绘制命令，
+     * 设备不支持时自动回退到 CPU 录制
+     */
+    void SetGpuDriven(bool enable)
+    {
+        _gpuDriven = enable;
+    }
+
+    /**
+     * @brief GPU 驱动时是否两阶段 Hi-Z 遮挡剔除（需在 InitVulkan 之前设置）
+     *
+     * 需要动态渲染且深度缓冲可采样，否则只做视锥体剔除
+     */
+    void SetOcclusionCulling(bool enable)
+    {
+        _occlusionCulling = enable;
+    }
+
+    /**
+     * @brief 是否启用硬件实例化（需在 InitVulkan 之前设置）
+     *
+     * 排序后网格、材质、状态相同的相邻 Draw 合并为一次实例化绘制，
+     * 逐物体变换 / 颜色走绑定 1 的逐实例顶点流
+     */
+    void SetInstancing(bool enable)
+    {
+        _instancing = enable;
+    }
+
+    /**
+     * @brief 是否启用逐物体缓冲（需在 InitVulkan 之前设置）
+     *
+     * 每帧全部物体的变换 / 颜色写入一个存储缓冲，着色器按实例号寻址，
+     * 不再逐 Draw 推送 Push Constant，可合并的 Draw 合并为一次绘制，
+     * 优先于硬件实例化
+     */
+    void SetObjectBuffer(bool enable)
+    {
+        _objectBuffer = enable;
+    }
+
+    /**
+     * @brief 是否启用 Bindless 纹理表（需在 InitVulkan 之前设置）
+     *
+     * 纹理注册到描述符索引的大数组中，着色器按逐物体下标采样，
+     * 切换纹理不再写描述符，设备不支持时回退到逐帧绑定
+     */
+    void SetBindless(bool enable)
+    {
+        _bindless = enable;
+    }
+
+    /**
+     * @brief 是否缓存静态内容的命令缓冲（需在 InitVulkan 之前设置）
+     *
+     * 场景内容不变时只重复执行上次录制的二级命令缓冲，
+     * 优先于并行录制
+     */
+    void SetCommandCaching(bool enable)
+    {
+        _commandCaching = enable;
+    }
+
+    /**
+     * @brief 呈现策略：并行帧数、交换链图像数、呈现模式、present_wait
+     *        （需在 InitVulkan 之前设置）
+     */
+    void SetPresentConfig(const PresentConfig &config)
+    {
+        _presentConfig = config;
+    }
+
+    /**
+     * @brief 是否把模拟与渲染拆到两个线程（需在 InitVulkan 之前设置）
+     *
+     * 主线程模拟第 N + 1 帧时，渲染线程录制并提交第 N 帧，
+     * 两者通过双缓冲的帧数据包交接
+     */
+    void SetPipelinedFrames(bool enable)
+    {
+        _pipelinedFrames = enable;
+    }
+
 private:
     bool createInstance();
 
     bool createSurface(GLFWwindow *window);
 
-    void recreateSwapchain();
+    // 按主线程查询到的帧缓冲大小重建（GLFW 不能在渲染线程调用）
+    void recreateSwapchain(int width, int height);
+
+    // 模拟一帧：相机、Uniform 数据、可见物体及其变换（主线程）
+    void simulate(FramePacket &packet);
+
+    // 按数据包录制、提交并呈现一帧
+    int renderFrame(const FramePacket &packet);
+
+    // 渲染线程：依次消费模拟线程发布的数据包
+    void renderLoop();
+
+    // 创建 Framebuffer（动态渲染时跳过）
+    bool createFramebuffer();
+
+    // 将动态状态缓存交给 CommandBuffer（启用动态状态时）
+    void setupDynamicStateCache();
+
+    // 录制当前帧的 CommandBuffer（GPU 驱动 / 渲染队列）
+    void recordCommandBuffer(uint32_t imageIndex, const FramePacket &frame);
+
+    // 按数据包整理本帧的渲染队列
+    void buildRenderQueue(const FramePacket &frame, bool objectBuffer);
+
+    // 上传本帧的逐物体数据，扩容时重写描述符
+    bool updateObjectBuffer();
+
+    // 当前交换链图像对应的动态渲染附件
+    RenderingAttachments getRenderingAttachments(uint32_t imageIndex) const;
+
+    // 生成 GPU 驱动的静态场景并上传
+    bool createGpuScene();
+
+    // 由当前深度缓冲创建 Hi-Z 金字塔（GPU 驱动遮挡剔除）
+    bool createDepthPyramid();
+
+    // 暂存该帧描述符集的全部绑定（由调用者 Flush）
+    void stageFrameDescriptors(VulkanDescriptorSet &descriptorSet, int frame);
+
+    // 建立 CPU 录制场景的变换层级和物体
+    void createScene();
+
+    // 读取烘焙网格，不存在或已过期时生成 LOD 链并写回
+    void cookMesh();
 
     // 更新uniform缓冲区
-    void updateUniformBuffer(uint32_t currentImage);
+    void updateUniformBuffer(const FramePacket &packet, uint32_t currentImage);
 
     // 创建纹理 释放旧的
     void updateTextureIfNeeded();
@@ -78,10 +259,27 @@ private:
     VulkanFramebuffer *_framebuffer = nullptr;
     VulkanCommandPool *_commandPool = nullptr;
     VulkanCommandBuffer *_commandBuffer = nullptr;
+    VulkanCommandAllocator *_commandAllocator = nullptr; // 每帧命令池
+    PSG::JobSystem *_jobSystem = nullptr;                // 帧任务调度
+    VulkanParallelRecorder *_parallelRecorder = nullptr; // 多线程录制
+    VulkanCommandCache *_commandCache = nullptr;         // 静态内容缓存
+    VulkanIndirectRenderer *_indirectRenderer = nullptr; // GPU 驱动间接绘制
+    VulkanFramePacer *_framePacer = nullptr;             // 帧节拍与延迟统计
+    VulkanBindlessTable *_bindlessTable = nullptr;       // Bindless 纹理表
 
     VulkanPipelineLayout *_pipelineLayout = nullptr;
-    std::vector<VulkanShaderModule *> _shaderModule;
-    VulkanPipeline *_pipeline = nullptr;
+    VulkanPipelineRegistry *_pipelineRegistry = nullptr;
+    VulkanPipeline *_pipeline = nullptr; // 由 _pipelineRegistry 持有
+    VulkanPipeline *_gpuDrivenPipeline = nullptr; // 同上，GPU 驱动变体
+    VulkanPipeline *_instancedPipeline = nullptr; // 同上，实例化变体
+    VulkanPipeline *_objectPipeline = nullptr;    // 同上，逐物体缓冲变体
+    VulkanDynamicStateCache _dynamicStateCache; // 逐 Draw 动态状态
+    VulkanRenderQueue _renderQueue;             // 按排序键整理的 Draw
+    VulkanFrustumCuller _frustumCuller;         // 提交前的视锥体剔除
+    std::vector<uint32_t> _objectLods;          // 每个物体当前的 LOD
+    RenderQueueStats _queueStats;               // 上次输出的绑定次数
+    CommandListStats _commandStats;             // 上次输出的命令统计
+    GpuCullStats _cullStats;                    // 上次输出的 GPU 剔除统计
     VulkanSync *_sync = nullptr;
 
     VulkanVertexBuffer *_vertexBuffer = nullptr;
@@ -91,6 +289,8 @@ private:
     VulkanDescriptorPool *_descriptorPool = nullptr;
 
     std::vector<VulkanUniformBuffer> _uniformMVPBuffer;
+    std::vector<VulkanInstanceBuffer> _instanceBuffers; // 每帧逐实例数据
+    std::vector<VulkanObjectBuffer> _objectBuffers;     // 每帧逐物体数据
     std::vector<VulkanUniformBuffer> _uniformColorBuffer;
     std::vector<VulkanUniformBuffer> _uniformLightBuffer;
 
@@ -99,6 +299,8 @@ private:
 
     VulkanDepthBuffer *_depthBuffer = nullptr;
 
+    VulkanDepthPyramid *_depthPyramid = nullptr; // 遮挡剔除的 Hi-Z 金字塔
+
     VulkanMsaaColorBuffer *_msaaColorBuffer = nullptr; // MSAA 颜色缓冲
 
     VulkanAttachmentDesc _attachmentDesc; // 附件描述
@@ -107,14 +309,63 @@ private:
 
     std::vector<VulkanTexture> _textures; // 纹理对象
 
+    std::vector<uint32_t> _textureIndices; // 纹理在 Bindless 表中的下标
+
 private:
     GLFWwindow *_window = nullptr;
 
-    bool _framebufferResized = false;
+    // 主线程设置，渲染线程读取并清除
+    std::atomic<bool> _framebufferResized = false;
+
+    bool _preferDynamicRendering = true;
+
+    // 实际是否使用动态渲染（无 RenderPass / Framebuffer）
+    bool _useDynamicRendering = false;
+
+    bool _parallelRecording = false;
+
+    bool _gpuDriven = false;
+
+    bool _occlusionCulling = true;
+
+    bool _instancing = false;
+
+    bool _objectBuffer = false;
+
+    bool _bindless = false;
+
+    bool _commandCaching = false;
+
+    PresentConfig _presentConfig;
+
+    bool _pipelinedFrames = false;
+
+    std::thread _renderThread; // 流水线模式的渲染线程
+
+    FramePacketBuffer _framePackets; // 模拟 -> 渲染的双缓冲
+
+    FramePacket _packet; // 非流水线模式使用的数据包
+
+    uint64_t _tick = 0; // 模拟步数
+
+    VulkanTransformHierarchy _transforms; // 场景变换层级（主线程）
+
+    std::vector<PushObject> _sceneObjects; // 层级直接写入的逐物体数据
+
+    std::vector<DynamicDrawState> _sceneDrawStates; // 逐物体绘制状态
+
+    uint32_t _spinNode = VulkanTransformHierarchy::INVALID_NODE; // 旋转节点
 
 private:
     uint32_t _vertexCount = 0;
 
+    // 网格的局部包围盒（中心 + 半边长），用于视锥体剔除
+    PTF_3D _meshCenter = PTF_3D(0.0f);
+    PTF_3D _meshExtent = PTF_3D(0.0f);
+
+    // 烘焙后的网格：顶点缓冲共用，索引缓冲依次存放各级 LOD
+    CookedMesh _mesh;
+
     const std::vector<VerCorTexNor> _vertices = {
         // Front (+Z)
         {{-0.5f, -0.5f, 0.5f}, {1, 0, 0}, {0, 0}, {0, 0, 1}},
@@ -170,10 +421,7 @@ private:
     bool _initialized = false;
 
     uint32_t _currentFrame = 0;
-    uint32_t MAX_FRAMES_IN_FLIGHT = 2;
-
-private:
-    PTF_3D _cameraPos = PTF_3D(0.0f, 5.0f, 0.0f);
+    uint32_t MAX_FRAMES_IN_FLIGHT = 2; // 由 PresentConfig 决定（1 ~ 3）
 };
 } // namespace VKB
 
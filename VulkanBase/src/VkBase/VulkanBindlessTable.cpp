@@ -0,0 +1,176 @@
+﻿#include "VulkanBindlessTable.h"
+#include "PrintMsg.h"
+
+#include <algorithm>
+
+namespace VKB
+{
+
+VulkanBindlessTable::VulkanBindlessTable()
+{
+}
+
+VulkanBindlessTable::~VulkanBindlessTable()
+{
+    Destroy();
+}
+
+bool VulkanBindlessTable::Init(VkPhysicalDevice physicalDevice,
+                               VkDevice device, uint32_t capacity)
+{
+    _device = device;
+
+    // 组合图像采样器同时计入采样器与采样图像的上限
+    VkPhysicalDeviceVulkan12Properties properties12{};
+    properties12.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    _capacity = std::min(
+        {capacity,
+         properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+         properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+         properties12.maxDescriptorSetUpdateAfterBindSamplers,
+         properties12.maxDescriptorSetUpdateAfterBindSampledImages});
+    if (0 == _capacity) {
+        PSG::PrintError("设备不支持绑定后更新的采样图像!");
+        return false;
+    }
+
+    // =========================
+    // 布局：部分绑定 + 绑定后更新
+    // =========================
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = _capacity;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    const VkDescriptorBindingFlags bindingFlags =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+        | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+        | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = 1;
+    flagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags =
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &_layout)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建 Bindless 描述符集布局失败!");
+        return false;
+    }
+
+    // =========================
+    // 描述符池：只分配一个集合
+    // =========================
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = _capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &_pool)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建 Bindless 描述符池失败!");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_layout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &_set) != VK_SUCCESS) {
+        PSG::PrintError("分配 Bindless 描述符集失败!");
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t VulkanBindlessTable::Register(VkImageView imageView,
+                                       VkSampler sampler)
+{
+    uint32_t index = INVALID_INDEX;
+    if (!_freeIndices.empty()) {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+    } else if (_next < _capacity) {
+        index = _next++;
+    } else {
+        PSG::PrintError("Bindless 纹理表已满!");
+        return INVALID_INDEX;
+    }
+
+    write(index, imageView, sampler);
+    return index;
+}
+
+void VulkanBindlessTable::Release(uint32_t index)
+{
+    // 部分绑定：槽位内容保留也不会被访问，直到重新注册时覆盖
+    if (index < _next) {
+        _freeIndices.push_back(index);
+    }
+}
+
+void VulkanBindlessTable::Destroy()
+{
+    // 集合随池一起释放
+    if (_pool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(_device, _pool, nullptr);
+        _pool = VK_NULL_HANDLE;
+        _set = VK_NULL_HANDLE;
+    }
+
+    if (_layout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(_device, _layout, nullptr);
+        _layout = VK_NULL_HANDLE;
+    }
+
+    _capacity = 0;
+    _next = 0;
+    _freeIndices.clear();
+}
+
+void VulkanBindlessTable::write(uint32_t index, VkImageView imageView,
+                                VkSampler sampler)
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = _set;
+    write.dstBinding = 0;
+    write.dstArrayElement = index;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(_device, 1, &write, 0, nullptr);
+}
+
+} // namespace VKB
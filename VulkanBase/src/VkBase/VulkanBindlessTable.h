@@ -0,0 +1,94 @@
+﻿#ifndef VULKANBINDLESSTABLE_H_
+#define VULKANBINDLESSTABLE_H_
+
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanBindlessTable
+ *
+ * Bindless 纹理表（描述符索引）：
+ * - 一个描述符集，绑定 0 为大容量的组合图像采样器数组
+ * - 部分绑定 + 绑定后更新：未注册的槽位可以为空，
+ *   注册新纹理不影响已录制 / 正在执行的命令缓冲
+ * - 注册时分配稳定的下标，只写一次描述符，着色器按下标采样，
+ *   切换纹理不需要任何描述符写入
+ */
+class VulkanBindlessTable
+{
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    VulkanBindlessTable();
+
+    ~VulkanBindlessTable();
+
+public:
+    /**
+     * @brief 创建布局、描述符池与描述符集
+     * @param capacity 期望的数组容量（受设备限制裁剪）
+     */
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
+              uint32_t capacity);
+
+    /**
+     * @brief 注册纹理，返回稳定下标（表满时返回 INVALID_INDEX）
+     */
+    uint32_t Register(VkImageView imageView, VkSampler sampler);
+
+    /**
+     * @brief 释放下标，之后可被重新分配
+     *
+     * 调用方需保证引用该下标的帧已经完成
+     */
+    void Release(uint32_t index);
+
+    void Destroy();
+
+    VkDescriptorSet Get() const
+    {
+        return _set;
+    }
+
+    VkDescriptorSetLayout GetLayout() const
+    {
+        return _layout;
+    }
+
+    uint32_t GetCapacity() const
+    {
+        return _capacity;
+    }
+
+    // 当前已注册的纹理数
+    uint32_t GetCount() const
+    {
+        return _next - static_cast<uint32_t>(_freeIndices.size());
+    }
+
+private:
+    void write(uint32_t index, VkImageView imageView, VkSampler sampler);
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+
+    VkDescriptorPool _pool = VK_NULL_HANDLE;
+
+    VkDescriptorSet _set = VK_NULL_HANDLE;
+
+    uint32_t _capacity = 0;
+
+    // 从未分配过的最小下标
+    uint32_t _next = 0;
+
+    // 已释放、可复用的下标
+    std::vector<uint32_t> _freeIndices;
+};
+
+} // namespace VKB
+
+#endif // !VULKANBINDLESSTABLE_H_
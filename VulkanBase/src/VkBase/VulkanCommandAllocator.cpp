@@ -0,0 +1,99 @@
+﻿#include "VulkanCommandAllocator.h"
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+VulkanCommandAllocator::VulkanCommandAllocator()
+{
+}
+
+VulkanCommandAllocator::~VulkanCommandAllocator()
+{
+    Destroy();
+}
+
+bool VulkanCommandAllocator::Init(VkDevice device, uint32_t queueFamilyIndex,
+                                  uint32_t framesInFlight)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建命令分配器失败：逻辑设备为空!");
+        return false;
+    }
+
+    _device = device;
+    _frames.resize(framesInFlight);
+    for (auto &frame : _frames) {
+        // 只做整池重置，不需要 RESET_COMMAND_BUFFER
+        frame.pool = new VulkanCommandPool();
+        if (!frame.pool->Init(device, queueFamilyIndex,
+                              VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)) {
+            Destroy();
+            return false;
+        }
+    }
+
+    _currentFrame = 0;
+    return true;
+}
+
+void VulkanCommandAllocator::Destroy()
+{
+    // 销毁命令池时其中的 CommandBuffer 一并释放
+    for (auto &frame : _frames) {
+        SDelete(frame.pool);
+    }
+    _frames.clear();
+}
+
+void VulkanCommandAllocator::BeginFrame(uint32_t frame)
+{
+    _currentFrame = frame;
+
+    FrameContext &context = _frames[frame];
+    context.pool->Reset();
+    context.used[0] = 0;
+    context.used[1] = 0;
+}
+
+VkCommandBuffer VulkanCommandAllocator::Allocate(VkCommandBufferLevel level)
+{
+    FrameContext &context = _frames[_currentFrame];
+
+    const size_t slot = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? 0 : 1;
+    auto &commandBuffers = context.commandBuffers[slot];
+    size_t &used = context.used[slot];
+
+    if (used < commandBuffers.size()) {
+        return commandBuffers[used++];
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = context.pool->Get();
+    allocInfo.level = level;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer)
+        != VK_SUCCESS) {
+        PSG::PrintError("分配帧命令缓冲区失败!");
+        return VK_NULL_HANDLE;
+    }
+
+    commandBuffers.push_back(commandBuffer);
+    ++used;
+    return commandBuffer;
+}
+
+std::vector<VkCommandPool> VulkanCommandAllocator::GetPools() const
+{
+    std::vector<VkCommandPool> pools;
+    for (const auto &frame : _frames) {
+        pools.push_back(frame.pool->Get());
+    }
+    return pools;
+}
+
+} // namespace VKB
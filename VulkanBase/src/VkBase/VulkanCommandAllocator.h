@@ -0,0 +1,82 @@
+﻿#ifndef VULKANCOMMANDALLOCATOR_H_
+#define VULKANCOMMANDALLOCATOR_H_
+
+#include "VulkanCommandPool.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanCommandAllocator
+ *
+ * 帧上下文命令分配器：
+ * - 每个在途帧一个 TRANSIENT 命令池，不单独 reset CommandBuffer
+ * - 帧栅栏完成后 vkResetCommandPool 整体重置
+ * - 重置后已分配的 CommandBuffer 回到空闲列表，之后的帧直接复用
+ */
+class VulkanCommandAllocator
+{
+public:
+    VulkanCommandAllocator();
+
+    ~VulkanCommandAllocator();
+
+public:
+    /**
+     * @brief 创建每帧的命令池
+     * @param framesInFlight 同时在途的帧数
+     */
+    bool Init(VkDevice device, uint32_t queueFamilyIndex,
+              uint32_t framesInFlight);
+
+    void Destroy();
+
+    /**
+     * @brief 开始一帧（该帧栅栏等待完成之后调用）
+     *
+     * 整体重置该帧的命令池，池中全部 CommandBuffer 回到初始状态
+     */
+    void BeginFrame(uint32_t frame);
+
+    /**
+     * @brief 从当前帧的空闲列表取一个 CommandBuffer
+     *
+     * 空闲列表用完时才真正分配，稳定后每帧不再有分配开销
+     * @return 失败返回 VK_NULL_HANDLE
+     */
+    VkCommandBuffer
+    Allocate(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    /**
+     * @brief 每帧的命令池（下标为帧序号）
+     */
+    std::vector<VkCommandPool> GetPools() const;
+
+    uint32_t GetFrameCount() const
+    {
+        return static_cast<uint32_t>(_frames.size());
+    }
+
+private:
+    struct FrameContext
+    {
+        VulkanCommandPool *pool = nullptr;
+
+        // 按级别（主 / 二级）保存已分配的 CommandBuffer
+        std::vector<VkCommandBuffer> commandBuffers[2];
+
+        // 本帧已取出的数量，其余为空闲
+        size_t used[2] = {0, 0};
+    };
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    std::vector<FrameContext> _frames;
+
+    uint32_t _currentFrame = 0;
+};
+
+} // namespace VKB
+
+#endif // !VULKANCOMMANDALLOCATOR_H_
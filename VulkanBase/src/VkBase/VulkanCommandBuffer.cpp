@@ -1,10 +1,48 @@
 ﻿#include "VulkanCommandBuffer.h"
 
+#include <algorithm>
+#include <array>
+
 #include "PrintMsg.h"
 
 namespace VKB
 {
 
+namespace
+{
+// 动态渲染没有 RenderPass 的隐式布局转换，需要手动插入屏障
+void imageBarrier(VkCommandBuffer cmd, VkImage image,
+                  VkImageAspectFlags aspect, VkImageLayout oldLayout,
+                  VkImageLayout newLayout, VkPipelineStageFlags srcStage,
+                  VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                  VkAccessFlags dstAccess)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr,
+                         1, &barrier);
+}
+
+bool hasStencil(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT
+           || format == VK_FORMAT_D24_UNORM_S8_UINT;
+}
+} // namespace
+
 VulkanCommandBuffer::VulkanCommandBuffer()
 {
 }
@@ -15,7 +53,7 @@ VulkanCommandBuffer::~VulkanCommandBuffer()
 }
 
 bool VulkanCommandBuffer::Init(VkDevice device, VkCommandPool commandPool,
-                               uint32_t count)
+                               uint32_t count, VkCommandBufferLevel level)
 {
     if (VK_NULL_HANDLE == device) {
         PSG::PrintError("分配命令缓冲区失败：逻辑设备为空!");
@@ -28,7 +66,7 @@ bool VulkanCommandBuffer::Init(VkDevice device, VkCommandPool commandPool,
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.level = level;
     allocInfo.commandBufferCount = count;
 
     // 分配命令缓冲区
@@ -44,6 +82,39 @@ bool VulkanCommandBuffer::Init(VkDevice device, VkCommandPool commandPool,
     return true;
 }
 
+bool VulkanCommandBuffer::Init(VkDevice device,
+                               const std::vector<VkCommandPool> &commandPools)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("分配命令缓冲区失败：逻辑设备为空!");
+        return false;
+    }
+
+    _device = device;
+
+    // 每个命令池分配一个，第 i 个 CommandBuffer 属于第 i 个命令池
+    for (VkCommandPool commandPool : commandPools) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkResult ret =
+            vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+        if (ret != VK_SUCCESS) {
+            PSG::PrintError("分配命令缓冲区失败!");
+            return false;
+        }
+
+        _commandBuffers.push_back(commandBuffer);
+        _commandPools.push_back(commandPool);
+    }
+
+    return true;
+}
+
 bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
                                  VkFramebuffer framebuffer, VkExtent2D extent,
                                  VkPipeline pipeline, VkBuffer vertexBuffer,
@@ -64,41 +135,27 @@ bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
 
     // 多个具有 VK_ATTACHMENT_LOAD_OP_CLEAR 的附件
     // 参数定义了用于 VK_ATTACHMENT_LOAD_OP_CLEAR 的清除值
-    std::vector<VkClearValue> clearValues(2);
+    std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = {{_backColor.x, _backColor.y, _backColor.z, 1.0f}};
     clearValues[1].depthStencil = {1.0f, 0};
-    renderPassInfo.clearValueCount = clearValues.size();
+    renderPassInfo.clearValueCount =
+        static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
     vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    _commandList.Reset(cmd, _stateCache);
+    _commandList.BindPipeline(pipeline);
 
     // 为此管线指定了视口和剪刀状态为动态 发出绘制命令之前在命令缓冲区中设置它们
-    VkViewport viewport{};
-    viewport.x = 0.0f; // 左上角 X 坐标
-    viewport.y = 0.0f; // 左上角 Y 坐标
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f; // 深度最小值
-    viewport.maxDepth = 1.0f; // 深度最大值
-
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0}; // 剪裁矩形左上角
-    scissor.extent = extent; // 宽高与交换链一致
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    _commandList.SetRenderArea(extent);
 
     // =========================
     // 绑定顶点缓冲
     // =========================
-    VkBuffer buffers[] = {vertexBuffer};
-    VkDeviceSize offsets[] = {0};
+    _commandList.BindVertexBuffer(0, vertexBuffer);
 
-    vkCmdBindVertexBuffers(cmd, 0, 1, buffers, offsets);
-
-    vkCmdDraw(cmd, vertexCount, 1, 0, 0);
+    _commandList.Draw(vertexCount);
 
     vkCmdEndRenderPass(cmd);
     vkEndCommandBuffer(cmd);
@@ -129,53 +186,38 @@ bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
 
     // 多个具有 VK_ATTACHMENT_LOAD_OP_CLEAR 的附件
     // 参数定义了用于 VK_ATTACHMENT_LOAD_OP_CLEAR 的清除值
-    std::vector<VkClearValue> clearValues(2);
+    std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = {{_backColor.x, _backColor.y, _backColor.z, 1.0f}};
     clearValues[1].depthStencil = {1.0f, 0};
-    renderPassInfo.clearValueCount = clearValues.size();
+    renderPassInfo.clearValueCount =
+        static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
     vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    _commandList.Reset(cmd, _stateCache);
+    _commandList.BindPipeline(pipeline);
 
     // 为此管线指定了视口和剪刀状态为动态 发出绘制命令之前在命令缓冲区中设置它们
-    VkViewport viewport{};
-    viewport.x = 0.0f; // 左上角 X 坐标
-    viewport.y = 0.0f; // 左上角 Y 坐标
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f; // 深度最小值
-    viewport.maxDepth = 1.0f; // 深度最大值
-
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0}; // 剪裁矩形左上角
-    scissor.extent = extent; // 宽高与交换链一致
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    _commandList.SetRenderArea(extent);
 
     // =========================
     // 绑定顶点缓冲
     // =========================
-    VkBuffer buffers[] = {vertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(cmd, 0, 1, buffers, offsets);
+    _commandList.BindVertexBuffer(0, vertexBuffer);
 
     // 绑定索引缓冲区
-    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    _commandList.BindIndexBuffer(indexBuffer);
 
     // 使用描述符集
     // 与顶点缓冲区和索引缓冲区不同，描述符集对于图形管线不是唯一的。
     // 因此，我们需要指定是否要将描述符集绑定到图形管线或计算管线。
     // 然后是开始索引 个数 绑定的描述符集合
 
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipelineLayout, 0, 1, &descriptorSets[index], 0,
-                            nullptr);
+    _commandList.BindDescriptorSet(pipelineLayout, 0, descriptorSets[index]);
 
     // 索引绘制
-    vkCmdDrawIndexed(cmd, indexCount, 1, 0, 0, 0);
+    _commandList.DrawIndexed(indexCount);
 
     vkCmdEndRenderPass(cmd);
     vkEndCommandBuffer(cmd);
@@ -183,14 +225,201 @@ bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
     return true;
 }
 
+bool VulkanCommandBuffer::Record(
+    uint32_t index, VkRenderPass renderPass, VkFramebuffer framebuffer,
+    VkExtent2D extent, VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+    std::vector<VkDescriptorSet> &descriptorSets, VkBuffer vertexBuffer,
+    VkBuffer indexBuffer, uint32_t indexCount,
+    std::vector<PushObject> &pushObjects,
+    const std::vector<DynamicDrawState> &drawStates)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    beginRenderPass(cmd, renderPass, framebuffer, extent,
+                    VK_SUBPASS_CONTENTS_INLINE);
+
+    recordDraws(cmd, extent, pipeline, pipelineLayout, descriptorSets[index],
+                vertexBuffer, indexBuffer, indexCount, pushObjects,
+                drawStates, 0, pushObjects.size());
+
+    vkCmdEndRenderPass(cmd);
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(
+    uint32_t index, const RenderingAttachments &attachments, VkExtent2D extent,
+    VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+    std::vector<VkDescriptorSet> &descriptorSets, VkBuffer vertexBuffer,
+    VkBuffer indexBuffer, uint32_t indexCount,
+    std::vector<PushObject> &pushObjects,
+    const std::vector<DynamicDrawState> &drawStates)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    beginRendering(cmd, attachments, extent, 0);
+
+    recordDraws(cmd, extent, pipeline, pipelineLayout, descriptorSets[index],
+                vertexBuffer, indexBuffer, indexCount, pushObjects,
+                drawStates, 0, pushObjects.size());
+
+    endRendering(cmd, attachments);
+
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
 bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
                                  VkFramebuffer framebuffer, VkExtent2D extent,
-                                 VkPipeline pipeline,
                                  VkPipelineLayout pipelineLayout,
-                                 std::vector<VkDescriptorSet> &descriptorSets,
-                                 VkBuffer vertexBuffer, VkBuffer indexBuffer,
-                                 uint32_t indexCount,
-                                 std::vector<PushObject> &pushObjects)
+                                 const VulkanRenderQueue &queue)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    beginRenderPass(cmd, renderPass, framebuffer, extent,
+                    VK_SUBPASS_CONTENTS_INLINE);
+
+    recordQueue(cmd, extent, pipelineLayout, queue, 0,
+                queue.GetBatchCount());
+
+    vkCmdEndRenderPass(cmd);
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(uint32_t index,
+                                 const RenderingAttachments &attachments,
+                                 VkExtent2D extent,
+                                 VkPipelineLayout pipelineLayout,
+                                 const VulkanRenderQueue &queue)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    beginRendering(cmd, attachments, extent, 0);
+
+    recordQueue(cmd, extent, pipelineLayout, queue, 0,
+                queue.GetBatchCount());
+
+    endRendering(cmd, attachments);
+
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(
+    uint32_t index, VkRenderPass renderPass, VkFramebuffer framebuffer,
+    VkExtent2D extent, VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+    VkDescriptorSet descriptorSet, VkBuffer vertexBuffer, VkBuffer indexBuffer,
+    const VulkanIndirectRenderer &indirect)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    // 计算剔除不能在 RenderPass 内录制
+    indirect.RecordCulling(cmd);
+
+    beginRenderPass(cmd, renderPass, framebuffer, extent,
+                    VK_SUBPASS_CONTENTS_INLINE);
+
+    recordIndirect(cmd, extent, pipeline, pipelineLayout, descriptorSet,
+                   vertexBuffer, indexBuffer, indirect);
+
+    vkCmdEndRenderPass(cmd);
+
+    indirect.RecordStats(cmd, index);
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(
+    uint32_t index, const RenderingAttachments &attachments, VkExtent2D extent,
+    VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+    VkDescriptorSet descriptorSet, VkBuffer vertexBuffer, VkBuffer indexBuffer,
+    const VulkanIndirectRenderer &indirect,
+    const VulkanDepthPyramid *depthPyramid)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    indirect.RecordCulling(cmd, 0);
+
+    if (depthPyramid) {
+        // 阶段 0：上一帧金字塔中可见的物体，保留附件内容
+        beginRendering(cmd, attachments, extent, 0, false, true);
+        recordIndirect(cmd, extent, pipeline, pipelineLayout, descriptorSet,
+                       vertexBuffer, indexBuffer, indirect, 0);
+        vkCmdEndRendering(cmd);
+
+        recordDepthPyramid(cmd, attachments, *depthPyramid);
+
+        // 阶段 1：用本帧深度重新测试，补画解除遮挡的物体
+        indirect.RecordCulling(cmd, 1);
+
+        beginRendering(cmd, attachments, extent, 0, true, false);
+        recordIndirect(cmd, extent, pipeline, pipelineLayout, descriptorSet,
+                       vertexBuffer, indexBuffer, indirect, 1);
+    } else {
+        beginRendering(cmd, attachments, extent, 0);
+        recordIndirect(cmd, extent, pipeline, pipelineLayout, descriptorSet,
+                       vertexBuffer, indexBuffer, indirect);
+    }
+
+    endRendering(cmd, attachments);
+
+    indirect.RecordStats(cmd, index);
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(
+    uint32_t index, VkRenderPass renderPass, VkFramebuffer framebuffer,
+    VkExtent2D extent, const std::vector<VkCommandBuffer> &secondaries)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    // 子通道内容全部来自二级命令缓冲
+    beginRenderPass(cmd, renderPass, framebuffer, extent,
+                    VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+    if (!secondaries.empty()) {
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()),
+                             secondaries.data());
+    }
+
+    vkCmdEndRenderPass(cmd);
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::Record(
+    uint32_t index, const RenderingAttachments &attachments, VkExtent2D extent,
+    const std::vector<VkCommandBuffer> &secondaries)
 {
     VkCommandBuffer cmd = _commandBuffers[index];
 
@@ -198,6 +427,70 @@ bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     vkBeginCommandBuffer(cmd, &beginInfo);
 
+    beginRendering(cmd, attachments, extent,
+                   VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+
+    if (!secondaries.empty()) {
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaries.size()),
+                             secondaries.data());
+    }
+
+    endRendering(cmd, attachments);
+
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+bool VulkanCommandBuffer::RecordSecondary(
+    uint32_t index, const SecondaryTarget &target, VkExtent2D extent,
+    VkPipelineLayout pipelineLayout, const VulkanRenderQueue &queue,
+    size_t first, size_t count, bool reusable)
+{
+    VkCommandBuffer cmd = _commandBuffers[index];
+
+    // 动态渲染：继承附件格式
+    VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+    renderingInfo.sType =
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &target.colorFormat;
+    renderingInfo.depthAttachmentFormat = target.depthFormat;
+    renderingInfo.rasterizationSamples = target.samples;
+
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = target.renderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = target.framebuffer;
+    if (VK_NULL_HANDLE == target.renderPass) {
+        inheritance.pNext = &renderingInfo;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    if (!reusable) {
+        beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    }
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) {
+        PSG::PrintError("开始录制二级命令缓冲区失败!");
+        return false;
+    }
+
+    recordQueue(cmd, extent, pipelineLayout, queue, first, count);
+
+    vkEndCommandBuffer(cmd);
+    return true;
+}
+
+void VulkanCommandBuffer::beginRenderPass(VkCommandBuffer cmd,
+                                          VkRenderPass renderPass,
+                                          VkFramebuffer framebuffer,
+                                          VkExtent2D extent,
+                                          VkSubpassContents contents)
+{
     // =========================
     // RenderPass Begin
     // =========================
@@ -210,70 +503,316 @@ bool VulkanCommandBuffer::Record(uint32_t index, VkRenderPass renderPass,
 
     // 多个具有 VK_ATTACHMENT_LOAD_OP_CLEAR 的附件
     // 参数定义了用于 VK_ATTACHMENT_LOAD_OP_CLEAR 的清除值
-    std::vector<VkClearValue> clearValues(2);
+    std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = {{_backColor.x, _backColor.y, _backColor.z, 1.0f}};
     clearValues[1].depthStencil = {1.0f, 0};
-    renderPassInfo.clearValueCount = clearValues.size();
+    renderPassInfo.clearValueCount =
+        static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(cmd, &renderPassInfo, contents);
+}
+
+void VulkanCommandBuffer::beginRendering(
+    VkCommandBuffer cmd, const RenderingAttachments &attachments,
+    VkExtent2D extent, VkRenderingFlags flags, bool loadContents,
+    bool storeContents)
+{
+    const bool useMsaa = attachments.msaaImageView != VK_NULL_HANDLE;
+
+    if (loadContents) {
+        // 附件已处于 ATTACHMENT 布局，只需等待上一次渲染的写入
+        // （深度由调用方转换布局时同步）
+        VkImage colorImage =
+            useMsaa ? attachments.msaaImage : attachments.swapImage;
+        imageBarrier(cmd, colorImage, VK_IMAGE_ASPECT_COLOR_BIT,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+                         | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    } else {
+        transitionAttachments(cmd, attachments);
+    }
+
+    // =========================
+    // Rendering Begin
+    // =========================
+    const VkAttachmentLoadOp loadOp =
+        loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+    VkRenderingAttachmentInfo colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = loadOp;
+    colorAttachment.clearValue.color = {
+        {_backColor.x, _backColor.y, _backColor.z, 1.0f}};
+
+    if (useMsaa && storeContents) {
+        // 后续渲染继续绘制，最后一次渲染时才解析
+        colorAttachment.imageView = attachments.msaaImageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    } else if (useMsaa) {
+        // 多重采样图像渲染后解析到交换链图像
+        colorAttachment.imageView = attachments.msaaImageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        colorAttachment.resolveImageView = attachments.swapImageView;
+        colorAttachment.resolveImageLayout =
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    } else {
+        colorAttachment.imageView = attachments.swapImageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+
+    VkRenderingAttachmentInfo depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthAttachment.imageView = attachments.depthImageView;
+    depthAttachment.imageLayout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = loadOp;
+    depthAttachment.storeOp = storeContents ? VK_ATTACHMENT_STORE_OP_STORE
+                                            : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue.depthStencil = {1.0f, 0};
+
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.flags = flags;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    vkCmdBeginRendering(cmd, &renderingInfo);
+}
+
+void VulkanCommandBuffer::transitionAttachments(
+    VkCommandBuffer cmd, const RenderingAttachments &attachments)
+{
+    const bool useMsaa = attachments.msaaImageView != VK_NULL_HANDLE;
+
+    // =========================
+    // 布局转换：UNDEFINED -> ATTACHMENT（内容每帧清除，无需保留）
+    // =========================
+    imageBarrier(cmd, attachments.swapImage, VK_IMAGE_ASPECT_COLOR_BIT,
+                 VK_IMAGE_LAYOUT_UNDEFINED,
+                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    if (useMsaa) {
+        imageBarrier(cmd, attachments.msaaImage, VK_IMAGE_ASPECT_COLOR_BIT,
+                     VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
+
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (hasStencil(attachments.depthFormat)) {
+        depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    imageBarrier(cmd, attachments.depthImage, depthAspect,
+                 VK_IMAGE_LAYOUT_UNDEFINED,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                     | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                     | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                     | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+}
+
+void VulkanCommandBuffer::recordDepthPyramid(
+    VkCommandBuffer cmd, const RenderingAttachments &attachments,
+    const VulkanDepthPyramid &depthPyramid)
+{
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (hasStencil(attachments.depthFormat)) {
+        depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    imageBarrier(cmd, attachments.depthImage, depthAspect,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                 VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_SHADER_READ_BIT);
+
+    depthPyramid.Record(cmd);
+
+    imageBarrier(cmd, attachments.depthImage, depthAspect,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                     | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                     | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+}
+
+void VulkanCommandBuffer::endRendering(VkCommandBuffer cmd,
+                                       const RenderingAttachments &attachments)
+{
+    vkCmdEndRendering(cmd);
+
+    // =========================
+    // 布局转换：ATTACHMENT -> PRESENT
+    // =========================
+    imageBarrier(cmd, attachments.swapImage, VK_IMAGE_ASPECT_COLOR_BIT,
+                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                 VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
+
+void VulkanCommandBuffer::recordDraws(
+    VkCommandBuffer cmd, VkExtent2D extent, VkPipeline pipeline,
+    VkPipelineLayout pipelineLayout, VkDescriptorSet descriptorSet,
+    VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t indexCount,
+    const std::vector<PushObject> &pushObjects,
+    const std::vector<DynamicDrawState> &drawStates, size_t first,
+    size_t count)
+{
+    // 新的命令缓冲中绑定状态和动态状态均未定义
+    _commandList.Reset(cmd, _stateCache);
 
     // =========================
     // Pipeline
     // =========================
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    _commandList.BindPipeline(pipeline);
 
     // =========================
     // Dynamic viewport & scissor
     // =========================
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = extent;
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
+    _commandList.SetRenderArea(extent);
 
     // =========================
     // DescriptorSet（每帧）
     // =========================
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipelineLayout, 0, 1, &descriptorSets[index], 0,
-                            nullptr);
+    _commandList.BindDescriptorSet(pipelineLayout, 0, descriptorSet);
 
     // =========================
     // Vertex / Index Buffer
     // =========================
-    VkBuffer buffers[] = {vertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(cmd, 0, 1, buffers, offsets);
-    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    _commandList.BindVertexBuffer(0, vertexBuffer);
+    _commandList.BindIndexBuffer(indexBuffer);
 
     // =========================
     // Draw Objects（Push Constant）
     // =========================
-    for (const auto &obj : pushObjects) {
-        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
-                           sizeof(PushObject),
-                           &obj // ✅ 正确
-        );
+    const size_t last = std::min(first + count, pushObjects.size());
+    for (size_t i = first; i < last; ++i) {
+        // 逐 Draw 设置动态状态（未提供时使用默认状态）
+        _commandList.SetDrawState(i < drawStates.size() ? drawStates[i]
+                                                        : DynamicDrawState{});
+
+        _commandList.PushConstants(pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+                                   0, sizeof(PushObject), &pushObjects[i]);
 
-        vkCmdDrawIndexed(cmd, indexCount, 1, 0, 0, 0);
+        _commandList.DrawIndexed(indexCount);
     }
+}
 
-    vkCmdEndRenderPass(cmd);
-    vkEndCommandBuffer(cmd);
-    return true;
+void VulkanCommandBuffer::recordIndirect(
+    VkCommandBuffer cmd, VkExtent2D extent, VkPipeline pipeline,
+    VkPipelineLayout pipelineLayout, VkDescriptorSet descriptorSet,
+    VkBuffer vertexBuffer, VkBuffer indexBuffer,
+    const VulkanIndirectRenderer &indirect, uint32_t phase)
+{
+    _commandList.Reset(cmd, _stateCache);
+
+    _commandList.BindPipeline(pipeline);
+    _commandList.SetRenderArea(extent);
+    _commandList.BindDescriptorSet(pipelineLayout, 0, descriptorSet);
+    _commandList.BindVertexBuffer(0, vertexBuffer);
+    _commandList.BindIndexBuffer(indexBuffer);
+
+    // 所有物体共用默认绘制状态
+    _commandList.SetDrawState(DynamicDrawState{});
+
+    indirect.RecordDraw(cmd, phase);
+}
+
+void VulkanCommandBuffer::recordQueue(VkCommandBuffer cmd, VkExtent2D extent,
+                                      VkPipelineLayout pipelineLayout,
+                                      const VulkanRenderQueue &queue,
+                                      size_t first, size_t count)
+{
+    // 新的命令缓冲中绑定状态和动态状态均未定义
+    _commandList.Reset(cmd, _stateCache);
+
+    // =========================
+    // Dynamic viewport & scissor
+    // =========================
+    _commandList.SetRenderArea(extent);
+
+    // Bindless 纹理表整帧不变，只绑定一次
+    if (VK_NULL_HANDLE != queue.GetBindlessSet()) {
+        _commandList.BindDescriptorSet(pipelineLayout, 1,
+                                       queue.GetBindlessSet());
+    }
+
+    // 排序后相邻 Draw 的状态大多相同，由命令列表过滤重复绑定
+    const size_t last = std::min(first + count, queue.GetBatchCount());
+    for (size_t i = first; i < last; ++i) {
+        const DrawBatch &batch = queue.GetBatch(i);
+        const DrawPacket &packet = queue.Get(batch.first);
+
+        _commandList.BindPipeline(batch.instanced ? packet.instancedPipeline
+                                                  : packet.pipeline);
+        _commandList.BindDescriptorSet(pipelineLayout, 0,
+                                       packet.descriptorSet);
+        _commandList.BindVertexBuffer(0, packet.vertexBuffer);
+        _commandList.BindIndexBuffer(packet.indexBuffer);
+        _commandList.SetDrawState(packet.drawState);
+
+        // 逐物体数据在描述符集的存储缓冲中，按 firstInstance 寻址
+        if (queue.UsesObjectBuffer()) {
+            _commandList.DrawIndexed(packet.indexCount, batch.count,
+                                     packet.firstIndex, 0,
+                                     batch.firstInstance);
+            continue;
+        }
+
+        if (batch.instanced) {
+            // 逐实例数据整帧共用一个缓冲，按 firstInstance 寻址
+            _commandList.BindVertexBuffer(1, queue.GetInstanceBuffer());
+            _commandList.DrawIndexed(packet.indexCount, batch.count,
+                                     packet.firstIndex, 0,
+                                     batch.firstInstance);
+            continue;
+        }
+
+        _commandList.PushConstants(pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+                                   0, sizeof(PushObject), &packet.pushObject);
+
+        _commandList.DrawIndexed(packet.indexCount, 1, packet.firstIndex);
+    }
 }
 
 void VulkanCommandBuffer::Destroy()
 {
+    // 按命令池分配的逐个归还
+    if (!_commandPools.empty()) {
+        for (size_t i = 0; i < _commandBuffers.size(); ++i) {
+            vkFreeCommandBuffers(_device, _commandPools[i], 1,
+                                 &_commandBuffers[i]);
+        }
+
+        _commandBuffers.clear();
+        _commandPools.clear();
+    }
+
     // 销毁命令缓冲区
     if (!_commandBuffers.empty()) {
         vkFreeCommandBuffers(_device, _commandPool,
@@ -1,16 +1,57 @@
 ﻿#ifndef VULKANCOMMANDBUFFER_H_
 #define VULKANCOMMANDBUFFER_H_
 
+#include "VulkanCommandList.h"
+#include "VulkanDynamicState.h"
 #include "VulkanHead.h"
+#include "VulkanIndirectRenderer.h"
+#include "VulkanRenderQueue.h"
 
 namespace VKB
 {
 
+/**
+ * @brief 动态渲染附件（VK_KHR_dynamic_rendering）
+ *
+ * 不需要 Framebuffer，录制时直接引用图像
+ */
+struct RenderingAttachments
+{
+    // 交换链图像（MSAA 时作为解析目标）
+    VkImage swapImage = VK_NULL_HANDLE;
+    VkImageView swapImageView = VK_NULL_HANDLE;
+
+    // 多重采样颜色图像（为空表示不使用 MSAA）
+    VkImage msaaImage = VK_NULL_HANDLE;
+    VkImageView msaaImageView = VK_NULL_HANDLE;
+
+    // 深度图像
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkImageView depthImageView = VK_NULL_HANDLE;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+};
+
+/**
+ * @brief 二级命令缓冲继承的渲染目标
+ *
+ * renderPass 为空时按动态渲染的附件格式继承
+ */
+struct SecondaryTarget
+{
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+};
+
 /**
  * @brief VulkanCommandBuffer
  *
  * 封装 VkCommandBuffer：
- * - 按 Swapchain Image 数量分配
+ * - 每个并行帧（MAX_FRAMES_IN_FLIGHT）一个，按帧下标访问
+ * - 从每帧的瞬态命令池分配，帧开始时整体重置命令池
  * - 支持基础的 RenderPass 录制
  */
 
@@ -26,9 +67,19 @@ public:
      * @brief 分配 CommandBuffer
      * @param device 逻辑设备
      * @param commandPool CommandPool
-     * @param count CommandBuffer 数量（通常 = Swapchain Image 数）
+     * @param count CommandBuffer 数量（通常 = 并行帧数）
+     * @param level 主 / 二级命令缓冲
+     */
+    bool Init(VkDevice device, VkCommandPool commandPool, uint32_t count,
+              VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    /**
+     * @brief 从每帧的命令池各分配一个主 CommandBuffer
+     *
+     * 由命令池整体重置，录制前不需要 vkResetCommandBuffer
+     * @param commandPools 每帧的命令池（下标即帧序号）
      */
-    bool Init(VkDevice device, VkCommandPool commandPool, uint32_t count);
+    bool Init(VkDevice device, const std::vector<VkCommandPool> &commandPools);
 
     /**
      * @brief 录制基础 RenderPass 命令
@@ -55,7 +106,89 @@ public:
                 VkPipeline pipeline, VkPipelineLayout pipelineLayout,
                 std::vector<VkDescriptorSet> &descriptorSets,
                 VkBuffer vertexBuffer, VkBuffer indexBuffer,
-                uint32_t indexCount, std::vector<PushObject> &pushObjects);
+                uint32_t indexCount, std::vector<PushObject> &pushObjects,
+                const std::vector<DynamicDrawState> &drawStates = {});
+
+    /**
+     * @brief 使用动态渲染录制（vkCmdBeginRendering，无 RenderPass）
+     * @param attachments 本帧使用的附件图像
+     * @param drawStates 每个 Draw 的动态状态（与 pushObjects 一一对应）
+     */
+    bool Record(uint32_t index, const RenderingAttachments &attachments,
+                VkExtent2D extent, VkPipeline pipeline,
+                VkPipelineLayout pipelineLayout,
+                std::vector<VkDescriptorSet> &descriptorSets,
+                VkBuffer vertexBuffer, VkBuffer indexBuffer,
+                uint32_t indexCount, std::vector<PushObject> &pushObjects,
+                const std::vector<DynamicDrawState> &drawStates = {});
+
+    /**
+     * @brief 按渲染队列的排序结果录制，状态未变化时不重复绑定
+     * @param queue 已排序的渲染队列
+     */
+    bool Record(uint32_t index, VkRenderPass renderPass,
+                VkFramebuffer framebuffer, VkExtent2D extent,
+                VkPipelineLayout pipelineLayout,
+                const VulkanRenderQueue &queue);
+
+    bool Record(uint32_t index, const RenderingAttachments &attachments,
+                VkExtent2D extent, VkPipelineLayout pipelineLayout,
+                const VulkanRenderQueue &queue);
+
+    /**
+     * @brief GPU 驱动录制：先剔除（计算），再间接绘制全部物体
+     * @param pipeline 使用 SHADER_FEATURE_GPU_DRIVEN 变体的管线
+     * @param descriptorSet 绑定了物体存储缓冲的 DescriptorSet
+     *
+     * 剔除统计复制到 index 对应的回读槽位
+     */
+    bool Record(uint32_t index, VkRenderPass renderPass,
+                VkFramebuffer framebuffer, VkExtent2D extent,
+                VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+                VkDescriptorSet descriptorSet, VkBuffer vertexBuffer,
+                VkBuffer indexBuffer, const VulkanIndirectRenderer &indirect);
+
+    /**
+     * @param depthPyramid 非空时两阶段遮挡剔除：阶段 0 绘制后由深度缓冲
+     *                     生成金字塔，阶段 1 补画解除遮挡的物体
+     */
+    bool Record(uint32_t index, const RenderingAttachments &attachments,
+                VkExtent2D extent, VkPipeline pipeline,
+                VkPipelineLayout pipelineLayout, VkDescriptorSet descriptorSet,
+                VkBuffer vertexBuffer, VkBuffer indexBuffer,
+                const VulkanIndirectRenderer &indirect,
+                const VulkanDepthPyramid *depthPyramid = nullptr);
+
+    /**
+     * @brief 录制主命令缓冲，绘制内容全部来自二级命令缓冲
+     */
+    bool Record(uint32_t index, VkRenderPass renderPass,
+                VkFramebuffer framebuffer, VkExtent2D extent,
+                const std::vector<VkCommandBuffer> &secondaries);
+
+    bool Record(uint32_t index, const RenderingAttachments &attachments,
+                VkExtent2D extent,
+                const std::vector<VkCommandBuffer> &secondaries);
+
+    /**
+     * @brief 录制二级命令缓冲：队列中 [first, first + count) 的批次
+     * @param target 继承的 RenderPass / 附件格式
+     * @param reusable 录制一次多次执行（否则为 ONE_TIME_SUBMIT）
+     */
+    bool RecordSecondary(uint32_t index, const SecondaryTarget &target,
+                         VkExtent2D extent, VkPipelineLayout pipelineLayout,
+                         const VulkanRenderQueue &queue, size_t first,
+                         size_t count, bool reusable = false);
+
+    /**
+     * @brief 设置动态状态缓存
+     *
+     * 管线启用扩展动态状态时必须设置，录制时逐 Draw 提交状态
+     */
+    void SetDynamicStateCache(VulkanDynamicStateCache *stateCache)
+    {
+        _stateCache = stateCache;
+    }
 
     void Destroy();
 
@@ -75,6 +208,77 @@ public:
         return static_cast<uint32_t>(_commandBuffers.size());
     }
 
+    /**
+     * @brief 最近一次录制绘制命令时的调用 / 过滤统计
+     */
+    const CommandListStats &GetCommandStats() const
+    {
+        return _commandList.GetStats();
+    }
+
+private:
+    void beginRenderPass(VkCommandBuffer cmd, VkRenderPass renderPass,
+                         VkFramebuffer framebuffer, VkExtent2D extent,
+                         VkSubpassContents contents);
+
+    /**
+     * @brief 附件布局转换 + vkCmdBeginRendering
+     * @param loadContents 接着上一次渲染继续绘制（不清除、不转换布局）
+     * @param storeContents 保留内容供下一次渲染继续绘制（MSAA 时暂不解析）
+     */
+    void beginRendering(VkCommandBuffer cmd,
+                        const RenderingAttachments &attachments,
+                        VkExtent2D extent, VkRenderingFlags flags,
+                        bool loadContents = false, bool storeContents = false);
+
+    /**
+     * @brief 附件布局转换：UNDEFINED -> ATTACHMENT
+     */
+    void transitionAttachments(VkCommandBuffer cmd,
+                               const RenderingAttachments &attachments);
+
+    /**
+     * @brief vkCmdEndRendering + 交换链图像转换到 PRESENT
+     */
+    void endRendering(VkCommandBuffer cmd,
+                      const RenderingAttachments &attachments);
+
+    /**
+     * @brief 录制 [first, first + count) 的绘制命令（主 / 二级命令缓冲共用）
+     */
+    void recordDraws(VkCommandBuffer cmd, VkExtent2D extent,
+                     VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+                     VkDescriptorSet descriptorSet, VkBuffer vertexBuffer,
+                     VkBuffer indexBuffer, uint32_t indexCount,
+                     const std::vector<PushObject> &pushObjects,
+                     const std::vector<DynamicDrawState> &drawStates,
+                     size_t first, size_t count);
+
+    /**
+     * @brief 绑定状态并录制一个阶段的间接绘制（剔除已在渲染开始前录制）
+     */
+    void recordIndirect(VkCommandBuffer cmd, VkExtent2D extent,
+                        VkPipeline pipeline, VkPipelineLayout pipelineLayout,
+                        VkDescriptorSet descriptorSet, VkBuffer vertexBuffer,
+                        VkBuffer indexBuffer,
+                        const VulkanIndirectRenderer &indirect,
+                        uint32_t phase = 0);
+
+    /**
+     * @brief 深度缓冲转换为只读并生成 Hi-Z 金字塔，之后恢复为深度附件
+     */
+    void recordDepthPyramid(VkCommandBuffer cmd,
+                            const RenderingAttachments &attachments,
+                            const VulkanDepthPyramid &depthPyramid);
+
+    /**
+     * @brief 按队列顺序录制批次 [first, first + count)，只在变化时重新绑定
+     */
+    void recordQueue(VkCommandBuffer cmd, VkExtent2D extent,
+                     VkPipelineLayout pipelineLayout,
+                     const VulkanRenderQueue &queue, size_t first,
+                     size_t count);
+
 private:
     glm::vec3 _backColor = glm::vec3(1.0f);
 
@@ -84,8 +288,17 @@ private:
     // 命令池
     VkCommandPool _commandPool = VK_NULL_HANDLE;
 
+    // 每个 CommandBuffer 所属的命令池（按帧分配时使用）
+    std::vector<VkCommandPool> _commandPools;
+
     // 命令缓冲区
     std::vector<VkCommandBuffer> _commandBuffers;
+
+    // 动态状态缓存（可为空）
+    VulkanDynamicStateCache *_stateCache = nullptr;
+
+    // 带状态影子的录制接口，过滤重复绑定
+    VulkanCommandList _commandList;
 };
 
 } // namespace VKB
@@ -0,0 +1,118 @@
+﻿#include "VulkanCommandCache.h"
+
+#include "MacroHead.h"
+#include "PrintMsg.h"
+#include "VulkanUtils.h"
+
+namespace VKB
+{
+
+VulkanCommandCache::VulkanCommandCache()
+{
+}
+
+VulkanCommandCache::~VulkanCommandCache()
+{
+    Destroy();
+}
+
+bool VulkanCommandCache::Init(VkDevice device, uint32_t queueFamilyIndex,
+                              uint32_t framesInFlight)
+{
+    // 缓存的命令缓冲需要单独重新录制
+    _commandPool = new VulkanCommandPool();
+    if (!_commandPool->Init(device, queueFamilyIndex,
+                            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT)) {
+        Destroy();
+        return false;
+    }
+
+    _commandBuffer = new VulkanCommandBuffer();
+    if (!_commandBuffer->Init(device, _commandPool->Get(), framesInFlight,
+                              VK_COMMAND_BUFFER_LEVEL_SECONDARY)) {
+        Destroy();
+        return false;
+    }
+
+    _signatures.assign(framesInFlight, 0);
+    _valid.assign(framesInFlight, false);
+    return true;
+}
+
+void VulkanCommandCache::Destroy()
+{
+    // 先释放 CommandBuffer，再销毁所属命令池
+    SDelete(_commandBuffer);
+    SDelete(_commandPool);
+
+    _signatures.clear();
+    _valid.clear();
+}
+
+void VulkanCommandCache::SetDynamicStates(
+    uint32_t dynamicStates, PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode)
+{
+    _stateCache.Init(dynamicStates, cmdSetPolygonMode);
+    if (_commandBuffer && dynamicStates != DYNAMIC_STATE_NONE) {
+        _commandBuffer->SetDynamicStateCache(&_stateCache);
+    }
+
+    // 录制方式变化，已有缓存不再适用
+    Invalidate();
+}
+
+VkCommandBuffer VulkanCommandCache::Acquire(uint32_t frame,
+                                            const SecondaryTarget &target,
+                                            VkExtent2D extent,
+                                            VkPipelineLayout pipelineLayout,
+                                            const VulkanRenderQueue &queue)
+{
+    if (!_commandBuffer || frame >= _valid.size()) {
+        return VK_NULL_HANDLE;
+    }
+
+    const size_t inputs = signature(target, extent, pipelineLayout, queue);
+    if (_valid[frame] && _signatures[frame] == inputs) {
+        return _commandBuffer->Get(frame);
+    }
+
+    // 不继承 Framebuffer，交换链图像切换时无需重新录制
+    SecondaryTarget cachedTarget = target;
+    cachedTarget.framebuffer = VK_NULL_HANDLE;
+
+    _valid[frame] = false;
+    if (!_commandBuffer->RecordSecondary(frame, cachedTarget, extent,
+                                         pipelineLayout, queue, 0,
+                                         queue.GetBatchCount(), true)) {
+        PSG::PrintError("录制缓存命令缓冲区失败!");
+        return VK_NULL_HANDLE;
+    }
+
+    _signatures[frame] = inputs;
+    _valid[frame] = true;
+    ++_recordCount;
+    return _commandBuffer->Get(frame);
+}
+
+void VulkanCommandCache::Invalidate()
+{
+    _valid.assign(_valid.size(), false);
+}
+
+size_t VulkanCommandCache::signature(const SecondaryTarget &target,
+                                     VkExtent2D extent,
+                                     VkPipelineLayout pipelineLayout,
+                                     const VulkanRenderQueue &queue)
+{
+    size_t seed = queue.Hash();
+    HashCombine(seed, target.renderPass);
+    HashCombine(seed, static_cast<uint32_t>(target.colorFormat));
+    HashCombine(seed, static_cast<uint32_t>(target.depthFormat));
+    HashCombine(seed, static_cast<uint32_t>(target.samples));
+    HashCombine(seed, extent.width);
+    HashCombine(seed, extent.height);
+    HashCombine(seed, pipelineLayout);
+    return seed;
+}
+
+} // namespace VKB
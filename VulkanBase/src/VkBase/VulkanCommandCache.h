@@ -0,0 +1,88 @@
+﻿#ifndef VULKANCOMMANDCACHE_H_
+#define VULKANCOMMANDCACHE_H_
+
+#include "VulkanCommandBuffer.h"
+#include "VulkanCommandPool.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanCommandCache
+ *
+ * 静态内容的录制一次模式：
+ * - 每个在途帧一个可重复执行的二级命令缓冲（不带 ONE_TIME_SUBMIT）
+ * - 按输入签名判断是否失效：网格、材质、管线、Push Constant、
+ *   渲染目标格式与尺寸；签名不变时直接复用上次录制结果
+ * - 每帧变化的数据通过 Uniform / 实例缓冲传递，不进入签名
+ * - 命令池独立于每帧整体重置的池，缓存跨帧保留
+ */
+class VulkanCommandCache
+{
+public:
+    VulkanCommandCache();
+
+    ~VulkanCommandCache();
+
+public:
+    /**
+     * @brief 创建命令池和每帧的二级命令缓冲
+     * @param framesInFlight 同时在途的帧数
+     */
+    bool Init(VkDevice device, uint32_t queueFamilyIndex,
+              uint32_t framesInFlight);
+
+    void Destroy();
+
+    /**
+     * @brief 设置动态状态（缓存持有独立的 VulkanDynamicStateCache）
+     */
+    void SetDynamicStates(uint32_t dynamicStates,
+                          PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode);
+
+    /**
+     * @brief 取得本帧可执行的二级命令缓冲，输入变化时重新录制
+     *
+     * 重新录制前该帧的栅栏必须已经等待完成；
+     * 录制时不继承 Framebuffer，同一缓存可用于任意交换链图像
+     * @param queue 已排序的渲染队列
+     * @return 录制失败时返回 VK_NULL_HANDLE
+     */
+    VkCommandBuffer Acquire(uint32_t frame, const SecondaryTarget &target,
+                            VkExtent2D extent, VkPipelineLayout pipelineLayout,
+                            const VulkanRenderQueue &queue);
+
+    /**
+     * @brief 使全部缓存失效（渲染目标重建等）
+     */
+    void Invalidate();
+
+    /// 累计录制次数（稳定状态下不再增长）
+    uint32_t GetRecordCount() const
+    {
+        return _recordCount;
+    }
+
+private:
+    static size_t signature(const SecondaryTarget &target, VkExtent2D extent,
+                            VkPipelineLayout pipelineLayout,
+                            const VulkanRenderQueue &queue);
+
+private:
+    VulkanCommandPool *_commandPool = nullptr;
+
+    VulkanCommandBuffer *_commandBuffer = nullptr;
+
+    VulkanDynamicStateCache _stateCache;
+
+    // 每帧上次录制时的输入签名
+    std::vector<size_t> _signatures;
+
+    std::vector<bool> _valid;
+
+    uint32_t _recordCount = 0;
+};
+
+} // namespace VKB
+
+#endif // !VULKANCOMMANDCACHE_H_
@@ -0,0 +1,211 @@
+﻿#include "VulkanCommandList.h"
+
+#include <cstring>
+
+namespace VKB
+{
+
+void VulkanCommandList::Reset(VkCommandBuffer cmd,
+                              VulkanDynamicStateCache *stateCache)
+{
+    _cmd = cmd;
+    _stateCache = stateCache;
+
+    _pipeline = VK_NULL_HANDLE;
+    _layout = VK_NULL_HANDLE;
+    _descriptorSets.fill(VK_NULL_HANDLE);
+    _vertexBuffers.fill(VK_NULL_HANDLE);
+    _vertexOffsets.fill(0);
+    _indexBuffer = VK_NULL_HANDLE;
+    _indexOffset = 0;
+    _indexType = VK_INDEX_TYPE_UINT32;
+
+    _pushLayout = VK_NULL_HANDLE;
+    _pushStages = 0;
+    _pushOffset = 0;
+    _pushSize = 0;
+
+    _viewportValid = false;
+    _scissorValid = false;
+
+    _stats = {};
+
+    // 新的命令缓冲中动态状态未定义
+    if (_stateCache) {
+        _stateCache->Reset();
+    }
+}
+
+void VulkanCommandList::BindPipeline(VkPipeline pipeline)
+{
+    if (changed(pipeline != _pipeline)) {
+        vkCmdBindPipeline(_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        _pipeline = pipeline;
+    }
+}
+
+void VulkanCommandList::BindDescriptorSet(VkPipelineLayout layout,
+                                          uint32_t slot,
+                                          VkDescriptorSet descriptorSet)
+{
+    // 不同 PipelineLayout 之间不保证兼容，全部重新绑定
+    if (layout != _layout) {
+        _layout = layout;
+        _descriptorSets.fill(VK_NULL_HANDLE);
+    }
+
+    const bool shadowed = slot < MAX_DESCRIPTOR_SETS;
+    if (changed(!shadowed || descriptorSet != _descriptorSets[slot])) {
+        vkCmdBindDescriptorSets(_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+                                slot, 1, &descriptorSet, 0, nullptr);
+        if (shadowed) {
+            _descriptorSets[slot] = descriptorSet;
+        }
+    }
+}
+
+void VulkanCommandList::BindVertexBuffer(uint32_t binding, VkBuffer buffer,
+                                         VkDeviceSize offset)
+{
+    const bool shadowed = binding < MAX_VERTEX_BINDINGS;
+    if (changed(!shadowed || buffer != _vertexBuffers[binding]
+                || offset != _vertexOffsets[binding])) {
+        vkCmdBindVertexBuffers(_cmd, binding, 1, &buffer, &offset);
+        if (shadowed) {
+            _vertexBuffers[binding] = buffer;
+            _vertexOffsets[binding] = offset;
+        }
+    }
+}
+
+void VulkanCommandList::BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset,
+                                        VkIndexType indexType)
+{
+    if (changed(buffer != _indexBuffer || offset != _indexOffset
+                || indexType != _indexType)) {
+        vkCmdBindIndexBuffer(_cmd, buffer, offset, indexType);
+        _indexBuffer = buffer;
+        _indexOffset = offset;
+        _indexType = indexType;
+    }
+}
+
+void VulkanCommandList::PushConstants(VkPipelineLayout layout,
+                                      VkShaderStageFlags stages,
+                                      uint32_t offset, uint32_t size,
+                                      const void *data)
+{
+    const bool same = 0 != _pushSize && layout == _pushLayout
+                      && stages == _pushStages && offset == _pushOffset
+                      && size == _pushSize
+                      && 0 == memcmp(_pushData.data(), data, size);
+    if (!changed(!same)) {
+        return;
+    }
+
+    vkCmdPushConstants(_cmd, layout, stages, offset, size, data);
+
+    // 超出影子容量的内容不记录，下次一定重新提交
+    if (size <= MAX_PUSH_CONSTANT_SIZE) {
+        memcpy(_pushData.data(), data, size);
+        _pushLayout = layout;
+        _pushStages = stages;
+        _pushOffset = offset;
+        _pushSize = size;
+    } else {
+        _pushSize = 0;
+    }
+}
+
+void VulkanCommandList::SetViewport(const VkViewport &viewport)
+{
+    const bool same = _viewportValid && viewport.x == _viewport.x
+                      && viewport.y == _viewport.y
+                      && viewport.width == _viewport.width
+                      && viewport.height == _viewport.height
+                      && viewport.minDepth == _viewport.minDepth
+                      && viewport.maxDepth == _viewport.maxDepth;
+    if (changed(!same)) {
+        vkCmdSetViewport(_cmd, 0, 1, &viewport);
+        _viewport = viewport;
+        _viewportValid = true;
+    }
+}
+
+void VulkanCommandList::SetScissor(const VkRect2D &scissor)
+{
+    const bool same = _scissorValid && scissor.offset.x == _scissor.offset.x
+                      && scissor.offset.y == _scissor.offset.y
+                      && scissor.extent.width == _scissor.extent.width
+                      && scissor.extent.height == _scissor.extent.height;
+    if (changed(!same)) {
+        vkCmdSetScissor(_cmd, 0, 1, &scissor);
+        _scissor = scissor;
+        _scissorValid = true;
+    }
+}
+
+void VulkanCommandList::SetRenderArea(VkExtent2D extent)
+{
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    SetViewport(viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = extent;
+    SetScissor(scissor);
+}
+
+void VulkanCommandList::SetDrawState(const DynamicDrawState &state)
+{
+    if (!_stateCache) {
+        return;
+    }
+
+    // 动态状态由缓存逐项过滤，这里只汇总它的计数
+    const uint32_t setCount = _stateCache->GetSetCount();
+    const uint32_t skipCount = _stateCache->GetSkipCount();
+
+    _stateCache->Apply(_cmd, state);
+
+    _stats.issued += _stateCache->GetSetCount() - setCount;
+    _stats.filtered += _stateCache->GetSkipCount() - skipCount;
+}
+
+void VulkanCommandList::Draw(uint32_t vertexCount, uint32_t instanceCount,
+                             uint32_t firstVertex, uint32_t firstInstance)
+{
+    vkCmdDraw(_cmd, vertexCount, instanceCount, firstVertex, firstInstance);
+    ++_stats.issued;
+    ++_stats.draws;
+}
+
+void VulkanCommandList::DrawIndexed(uint32_t indexCount,
+                                    uint32_t instanceCount,
+                                    uint32_t firstIndex, int32_t vertexOffset,
+                                    uint32_t firstInstance)
+{
+    vkCmdDrawIndexed(_cmd, indexCount, instanceCount, firstIndex, vertexOffset,
+                     firstInstance);
+    ++_stats.issued;
+    ++_stats.draws;
+}
+
+bool VulkanCommandList::changed(bool differs)
+{
+    if (differs) {
+        ++_stats.issued;
+        return true;
+    }
+
+    ++_stats.filtered;
+    return false;
+}
+
+} // namespace VKB
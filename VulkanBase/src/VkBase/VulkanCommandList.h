@@ -0,0 +1,155 @@
+﻿#ifndef VULKANCOMMANDLIST_H_
+#define VULKANCOMMANDLIST_H_
+
+#include <array>
+
+#include "VulkanDynamicState.h"
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 命令列表的调用统计
+ */
+struct CommandListStats
+{
+    // 实际调用的 vkCmd*（含 Draw）
+    uint32_t issued = 0;
+
+    // 与已绑定状态相同而被过滤的调用
+    uint32_t filtered = 0;
+
+    uint32_t draws = 0;
+
+    bool operator==(const CommandListStats &other) const = default;
+};
+
+/**
+ * @brief VulkanCommandList
+ *
+ * 带状态影子的录制接口：
+ * - 记录当前命令缓冲已绑定的管线、各槽位 DescriptorSet、
+ *   顶点 / 索引缓冲及偏移、Push Constant、视口 / 剪裁、动态状态
+ * - 与已绑定状态相同的调用直接过滤，并统计调用 / 过滤次数
+ * - 状态全部存放在定长数组中，录制路径上没有堆分配
+ * - 不负责 vkBegin / vkEndCommandBuffer，每次开始录制时 Reset
+ */
+class VulkanCommandList
+{
+public:
+    VulkanCommandList() = default;
+
+    ~VulkanCommandList() = default;
+
+public:
+    static constexpr uint32_t MAX_DESCRIPTOR_SETS = 4;
+    static constexpr uint32_t MAX_VERTEX_BINDINGS = 4;
+
+    // Vulkan 保证的 Push Constant 最小上限
+    static constexpr uint32_t MAX_PUSH_CONSTANT_SIZE = 128;
+
+    /**
+     * @brief 开始录制新的命令缓冲，之前的影子状态和统计全部失效
+     * @param stateCache 动态状态缓存（可为空）
+     */
+    void Reset(VkCommandBuffer cmd,
+               VulkanDynamicStateCache *stateCache = nullptr);
+
+    void BindPipeline(VkPipeline pipeline);
+
+    /**
+     * @brief 绑定一个槽位的 DescriptorSet
+     *
+     * PipelineLayout 变化时所有槽位的影子状态失效
+     */
+    void BindDescriptorSet(VkPipelineLayout layout, uint32_t slot,
+                           VkDescriptorSet descriptorSet);
+
+    void BindVertexBuffer(uint32_t binding, VkBuffer buffer,
+                          VkDeviceSize offset = 0);
+
+    void BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset = 0,
+                         VkIndexType indexType = VK_INDEX_TYPE_UINT32);
+
+    /**
+     * @brief 更新 Push Constant（内容与上次相同时过滤）
+     */
+    void PushConstants(VkPipelineLayout layout, VkShaderStageFlags stages,
+                       uint32_t offset, uint32_t size, const void *data);
+
+    void SetViewport(const VkViewport &viewport);
+
+    void SetScissor(const VkRect2D &scissor);
+
+    /**
+     * @brief 视口和剪裁都覆盖整个渲染区域
+     */
+    void SetRenderArea(VkExtent2D extent);
+
+    /**
+     * @brief 设置动态绘制状态（未设置动态状态缓存时忽略）
+     */
+    void SetDrawState(const DynamicDrawState &state);
+
+    void Draw(uint32_t vertexCount, uint32_t instanceCount = 1,
+              uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+
+    void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1,
+                     uint32_t firstIndex = 0, int32_t vertexOffset = 0,
+                     uint32_t firstInstance = 0);
+
+    VkCommandBuffer Get() const
+    {
+        return _cmd;
+    }
+
+    const CommandListStats &GetStats() const
+    {
+        return _stats;
+    }
+
+private:
+    /// 状态未变化时计入过滤，返回 false
+    bool changed(bool differs);
+
+private:
+    VkCommandBuffer _cmd = VK_NULL_HANDLE;
+
+    VulkanDynamicStateCache *_stateCache = nullptr;
+
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+
+    VkPipelineLayout _layout = VK_NULL_HANDLE;
+
+    std::array<VkDescriptorSet, MAX_DESCRIPTOR_SETS> _descriptorSets{};
+
+    std::array<VkBuffer, MAX_VERTEX_BINDINGS> _vertexBuffers{};
+
+    std::array<VkDeviceSize, MAX_VERTEX_BINDINGS> _vertexOffsets{};
+
+    VkBuffer _indexBuffer = VK_NULL_HANDLE;
+
+    VkDeviceSize _indexOffset = 0;
+
+    VkIndexType _indexType = VK_INDEX_TYPE_UINT32;
+
+    // 上一次 Push Constant 的范围和内容（size 为 0 表示未知）
+    VkPipelineLayout _pushLayout = VK_NULL_HANDLE;
+    VkShaderStageFlags _pushStages = 0;
+    uint32_t _pushOffset = 0;
+    uint32_t _pushSize = 0;
+    std::array<uint8_t, MAX_PUSH_CONSTANT_SIZE> _pushData{};
+
+    VkViewport _viewport{};
+    bool _viewportValid = false;
+
+    VkRect2D _scissor{};
+    bool _scissorValid = false;
+
+    CommandListStats _stats;
+};
+
+} // namespace VKB
+
+#endif // !VULKANCOMMANDLIST_H_
@@ -26,11 +26,19 @@ public:
      * @brief 初始化 CommandPool
      * @param device 逻辑设备
      * @param queueFamilyIndex 队列族索引（通常 Graphics）
+     * @param flags 创建标志（每帧整体重置的池可用 TRANSIENT 且不需单独 reset）
      */
-    bool Init(VkDevice device, uint32_t queueFamilyIndex);
+    bool Init(VkDevice device, uint32_t queueFamilyIndex,
+              VkCommandPoolCreateFlags flags =
+                  VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
 
     void Destroy();
 
+    /**
+     * @brief 重置整个命令池（池中所有 CommandBuffer 回到初始状态）
+     */
+    void Reset();
+
     /**
      * @brief 获取命令池
      */
@@ -11,13 +11,31 @@ VulkanDepthBuffer::~VulkanDepthBuffer()
 }
 
 bool VulkanDepthBuffer::Init(VkPhysicalDevice physicalDevice, VkDevice device,
-                             VkExtent2D extent, VkSampleCountFlagBits samples)
+                             VkExtent2D extent, VkSampleCountFlagBits samples,
+                             bool sampled)
 {
     _format = FindDepthFormat(physicalDevice);
+    _extent = extent;
+    _samples = samples;
+
+    // 采样深度需要格式支持 SAMPLED_IMAGE，多重采样时还受采样数限制
+    VkFormatProperties formatProps;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, _format, &formatProps);
+    VkPhysicalDeviceProperties deviceProps;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProps);
+
+    _sampled = sampled
+               && (formatProps.optimalTilingFeatures
+                   & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)
+               && (deviceProps.limits.sampledImageDepthSampleCounts & samples);
+
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (_sampled) {
+        usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    }
 
     return _image.Init(physicalDevice, device, extent.width, extent.height,
-                       _format, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                       VK_IMAGE_ASPECT_DEPTH_BIT, samples);
+                       _format, usage, VK_IMAGE_ASPECT_DEPTH_BIT, samples);
 }
 
 void VulkanDepthBuffer::Destroy()
@@ -24,13 +24,21 @@ public:
 
     /**
      * @brief 创建深度缓冲
+     * @param sampled 是否允许着色器采样（如生成 Hi-Z 金字塔），
+     *                格式或采样数不支持时忽略，见 IsSampled
      */
     bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
               VkExtent2D extent,
-              VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+              VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+              bool sampled = false);
 
     void Destroy();
 
+    VkImage GetImage() const
+    {
+        return _image.GetImage();
+    }
+
     VkImageView GetImageView() const
     {
         return _image.GetImageView();
@@ -41,10 +49,31 @@ public:
         return _format;
     }
 
+    VkExtent2D GetExtent() const
+    {
+        return _extent;
+    }
+
+    VkSampleCountFlagBits GetSamples() const
+    {
+        return _samples;
+    }
+
+    bool IsSampled() const
+    {
+        return _sampled;
+    }
+
 private:
     VulkanImage _image;
 
     VkFormat _format = VK_FORMAT_UNDEFINED;
+
+    VkExtent2D _extent{};
+
+    VkSampleCountFlagBits _samples = VK_SAMPLE_COUNT_1_BIT;
+
+    bool _sampled = false;
 };
 
 } // namespace VKB
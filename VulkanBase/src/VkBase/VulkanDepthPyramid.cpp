@@ -0,0 +1,407 @@
+﻿#include "VulkanDepthPyramid.h"
+
+#include <algorithm>
+
+#include "PrintMsg.h"
+#include "VulkanUtils.h"
+
+namespace VKB
+{
+
+namespace
+{
+// Hi-Z 生成计算着色器（多重采样深度使用 MULTISAMPLE 变体）
+const char *HIZ_SHADER = "Res\\Shaders\\HiZ.spv";
+const char *HIZ_MS_SHADER = "Res\\Shaders\\HiZ_MS.spv";
+
+constexpr VkFormat PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+void computeBarrier(VkCommandBuffer cmd)
+{
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier,
+                         0, nullptr, 0, nullptr);
+}
+} // namespace
+
+VulkanDepthPyramid::~VulkanDepthPyramid()
+{
+    Destroy();
+}
+
+bool VulkanDepthPyramid::Init(VkPhysicalDevice physicalDevice, VkDevice device,
+                              VkCommandPool commandPool, VkQueue queue,
+                              const VulkanDepthBuffer &depthBuffer)
+{
+    _device = device;
+    _hasSource = depthBuffer.IsSampled();
+    _depthExtent = depthBuffer.GetExtent();
+    _depthSamples = static_cast<int32_t>(depthBuffer.GetSamples());
+
+    // 第 0 级为深度的一半，逐级减半直到 1x1
+    const uint32_t size = std::max(_depthExtent.width, _depthExtent.height);
+    _levelCount = 1;
+    while ((1u << _levelCount) < size && _levelCount < MAX_LEVELS) {
+        ++_levelCount;
+    }
+
+    if (!createImage(physicalDevice, commandPool, queue)) {
+        return false;
+    }
+
+    if (!createPipelines(depthBuffer.GetSamples())) {
+        return false;
+    }
+
+    return createSets(depthBuffer.GetImageView());
+}
+
+bool VulkanDepthPyramid::InitPlaceholder(VkPhysicalDevice physicalDevice,
+                                         VkDevice device,
+                                         VkCommandPool commandPool,
+                                         VkQueue queue)
+{
+    _device = device;
+    _hasSource = false;
+    _depthExtent = {1, 1};
+    _depthSamples = 1;
+    _levelCount = 1;
+
+    return createImage(physicalDevice, commandPool, queue);
+}
+
+void VulkanDepthPyramid::Destroy()
+{
+    if (_reducePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_device, _reducePipeline, nullptr);
+        _reducePipeline = VK_NULL_HANDLE;
+    }
+    if (_depthPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_device, _depthPipeline, nullptr);
+        _depthPipeline = VK_NULL_HANDLE;
+    }
+
+    _reduceShader.Destroy();
+    _depthShader.Destroy();
+    _layout.Destroy();
+
+    // DescriptorSet 随池一起释放
+    SDelete(_pool);
+    SDelete(_setLayout);
+    _sets.fill(VK_NULL_HANDLE);
+
+    if (_sampler != VK_NULL_HANDLE) {
+        vkDestroySampler(_device, _sampler, nullptr);
+        _sampler = VK_NULL_HANDLE;
+    }
+
+    for (VkImageView &view : _levelViews) {
+        if (view != VK_NULL_HANDLE) {
+            vkDestroyImageView(_device, view, nullptr);
+            view = VK_NULL_HANDLE;
+        }
+    }
+    if (_imageView != VK_NULL_HANDLE) {
+        vkDestroyImageView(_device, _imageView, nullptr);
+        _imageView = VK_NULL_HANDLE;
+    }
+    if (_image != VK_NULL_HANDLE) {
+        vkDestroyImage(_device, _image, nullptr);
+        _image = VK_NULL_HANDLE;
+    }
+    if (_memory != VK_NULL_HANDLE) {
+        vkFreeMemory(_device, _memory, nullptr);
+        _memory = VK_NULL_HANDLE;
+    }
+
+    _levelCount = 0;
+    _hasSource = false;
+}
+
+void VulkanDepthPyramid::Record(VkCommandBuffer cmd) const
+{
+    if (!_hasSource) {
+        return;
+    }
+
+    // 上一帧的剔除读取完成后才能覆盖金字塔
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier,
+                         0, nullptr, 0, nullptr);
+
+    VkExtent2D source = _depthExtent;
+    for (uint32_t level = 0; level < _levelCount; ++level) {
+        const VkExtent2D target = levelExtent(level);
+
+        VkPipeline pipeline = (0 == level && _depthPipeline != VK_NULL_HANDLE)
+                                  ? _depthPipeline
+                                  : _reducePipeline;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                _layout.Get(), 0, 1, &_sets[level], 0,
+                                nullptr);
+
+        ReduceParams params{};
+        params.sourceWidth = static_cast<int32_t>(source.width);
+        params.sourceHeight = static_cast<int32_t>(source.height);
+        params.targetWidth = static_cast<int32_t>(target.width);
+        params.targetHeight = static_cast<int32_t>(target.height);
+        params.sampleCount = 0 == level ? _depthSamples : 1;
+        vkCmdPushConstants(cmd, _layout.Get(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(ReduceParams), &params);
+
+        const uint32_t groupsX =
+            (target.width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE;
+        const uint32_t groupsY =
+            (target.height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE;
+        vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+        // 下一级（以及之后的剔除）读取本级
+        computeBarrier(cmd);
+        source = target;
+    }
+}
+
+bool VulkanDepthPyramid::createImage(VkPhysicalDevice physicalDevice,
+                                     VkCommandPool commandPool, VkQueue queue)
+{
+    const VkExtent2D extent = levelExtent(0);
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {extent.width, extent.height, 1};
+    imageInfo.mipLevels = _levelCount;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = PYRAMID_FORMAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage =
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(_device, &imageInfo, nullptr, &_image) != VK_SUCCESS) {
+        PSG::PrintError("创建 Hi-Z 金字塔图像失败!");
+        return false;
+    }
+
+    VkMemoryRequirements memReq{};
+    vkGetImageMemoryRequirements(_device, _image, &memReq);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memReq.size;
+    allocInfo.memoryTypeIndex =
+        FindMemoryType(physicalDevice, memReq.memoryTypeBits,
+                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    if (vkAllocateMemory(_device, &allocInfo, nullptr, &_memory)
+        != VK_SUCCESS) {
+        PSG::PrintError("分配 Hi-Z 金字塔内存失败!");
+        return false;
+    }
+    vkBindImageMemory(_device, _image, _memory, 0);
+
+    // 全部层级一个视图，另外每级一个视图
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = _image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = PYRAMID_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = _levelCount;
+    viewInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(_device, &viewInfo, nullptr, &_imageView)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建 Hi-Z 金字塔视图失败!");
+        return false;
+    }
+
+    viewInfo.subresourceRange.levelCount = 1;
+    for (uint32_t level = 0; level < _levelCount; ++level) {
+        viewInfo.subresourceRange.baseMipLevel = level;
+        if (vkCreateImageView(_device, &viewInfo, nullptr, &_levelViews[level])
+            != VK_SUCCESS) {
+            PSG::PrintError("创建 Hi-Z 金字塔视图失败!");
+            return false;
+        }
+    }
+
+    // 只取整数纹素（texelFetch），过滤方式无关
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(_device, &samplerInfo, nullptr, &_sampler)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建 Hi-Z 采样器失败!");
+        return false;
+    }
+
+    // 一次性转换到 GENERAL，之后不再改变布局（剔除的描述符始终有效）
+    VkCommandBuffer cmd = BeginSingleTimeCommand(_device, commandPool);
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = _image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = _levelCount;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+
+    EndSingleTimeCommand(_device, commandPool, queue, cmd);
+    return true;
+}
+
+bool VulkanDepthPyramid::createPipelines(VkSampleCountFlagBits depthSamples)
+{
+    _setLayout = new VulkanDescriptorSetLayout();
+    std::vector<VkDescriptorSetLayoutBinding> bindings = {
+        _setLayout->Make(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                         VK_SHADER_STAGE_COMPUTE_BIT),
+        _setLayout->Make(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                         VK_SHADER_STAGE_COMPUTE_BIT)};
+    if (!_setLayout->Init(_device, bindings)) {
+        return false;
+    }
+
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(ReduceParams);
+    if (!_layout.Init(_device, {_setLayout->Get()}, {pushRange})) {
+        return false;
+    }
+
+    if (!_reduceShader.Init(_device, HIZ_SHADER, VK_SHADER_STAGE_COMPUTE_BIT)) {
+        return false;
+    }
+    _reducePipeline = createPipeline(_reduceShader);
+    if (VK_NULL_HANDLE == _reducePipeline) {
+        return false;
+    }
+
+    // 单采样深度直接按普通层级缩减
+    if (!_hasSource || VK_SAMPLE_COUNT_1_BIT == depthSamples) {
+        return true;
+    }
+
+    if (!_depthShader.Init(_device, HIZ_MS_SHADER,
+                           VK_SHADER_STAGE_COMPUTE_BIT)) {
+        return false;
+    }
+    _depthPipeline = createPipeline(_depthShader);
+    return _depthPipeline != VK_NULL_HANDLE;
+}
+
+bool VulkanDepthPyramid::createSets(VkImageView depthView)
+{
+    std::vector<VkDescriptorPoolSize> poolSizes(2);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = _levelCount;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = _levelCount;
+
+    _pool = new VulkanDescriptorPool();
+    if (!_pool->Init(_device, _levelCount, poolSizes)) {
+        PSG::PrintError("创建 Hi-Z 描述符池失败!");
+        return false;
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(_levelCount,
+                                               _setLayout->Get());
+    std::vector<VkDescriptorSet> sets;
+    if (!_pool->AllocateDescriptorSets(layouts, sets)) {
+        PSG::PrintError("分配 Hi-Z 描述符集失败!");
+        return false;
+    }
+
+    // 第 0 级读深度缓冲，之后每级读上一级
+    VkDescriptorUpdateTemplate updateTemplate =
+        _setLayout->GetUpdateTemplate(0x3);
+    if (VK_NULL_HANDLE == updateTemplate) {
+        return false;
+    }
+
+    for (uint32_t level = 0; level < _levelCount; ++level) {
+        _sets[level] = sets[level];
+
+        // 没有可采样的深度时第 0 级只写目标，不会被录制
+        if (0 == level && !_hasSource) {
+            continue;
+        }
+
+        DescriptorInfo infos[2]{};
+        infos[0].image.sampler = _sampler;
+        if (0 == level) {
+            infos[0].image.imageView = depthView;
+            infos[0].image.imageLayout =
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        } else {
+            infos[0].image.imageView = _levelViews[level - 1];
+            infos[0].image.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+        infos[1].image.imageView = _levelViews[level];
+        infos[1].image.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        vkUpdateDescriptorSetWithTemplate(_device, _sets[level],
+                                          updateTemplate, infos);
+    }
+
+    return true;
+}
+
+VkPipeline
+VulkanDepthPyramid::createPipeline(const VulkanShaderModule &shader) const
+{
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shader.GetStageInfo();
+    pipelineInfo.layout = _layout.Get();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateComputePipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                                 nullptr, &pipeline)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建 Hi-Z 计算管线失败!");
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+VkExtent2D VulkanDepthPyramid::levelExtent(uint32_t level) const
+{
+    // 向上取整：源图像的每个纹素都落在下一级的某个纹素内
+    VkExtent2D extent = _depthExtent;
+    for (uint32_t i = 0; i <= level; ++i) {
+        extent.width = std::max(1u, (extent.width + 1) / 2);
+        extent.height = std::max(1u, (extent.height + 1) / 2);
+    }
+    return extent;
+}
+
+} // namespace VKB
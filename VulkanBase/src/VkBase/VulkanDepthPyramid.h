@@ -0,0 +1,158 @@
+﻿#ifndef VULKANDEPTHPYRAMID_H_
+#define VULKANDEPTHPYRAMID_H_
+
+#include <array>
+
+#include "VulkanDepthBuffer.h"
+#include "VulkanDescriptorPool.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "VulkanPipelineLayout.h"
+#include "VulkanShaderModule.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanDepthPyramid
+ *
+ * 层级深度（Hi-Z）金字塔，用于 GPU 遮挡剔除：
+ * - 第 0 级为深度缓冲的 1/2（向上取整），之后逐级减半直到 1x1
+ * - 每个纹素保存所覆盖区域内最远的深度（max），遮挡测试保守
+ * - 由计算着色器逐级生成（HiZ.comp），多重采样深度取全部采样的最大值
+ * - 金字塔始终处于 GENERAL 布局：生成时作为存储图像写入，剔除时采样
+ * - 与深度缓冲大小绑定，交换链重建时随深度缓冲一起重建
+ */
+class VulkanDepthPyramid
+{
+public:
+    static constexpr uint32_t MAX_LEVELS = 16;
+
+    VulkanDepthPyramid() = default;
+
+    ~VulkanDepthPyramid();
+
+public:
+    /**
+     * @brief 创建金字塔图像和生成管线
+     * @param commandPool / queue 初始布局转换使用
+     * @param depthBuffer 源深度缓冲，不可采样时金字塔只作为占位
+     *                    （HasSource 为 false，不能生成）
+     */
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
+              VkCommandPool commandPool, VkQueue queue,
+              const VulkanDepthBuffer &depthBuffer);
+
+    /**
+     * @brief 只创建 1x1 的占位图像（不加载着色器，HasSource 为 false）
+     *
+     * 没有可用的金字塔时保证剔除描述符有效
+     */
+    bool InitPlaceholder(VkPhysicalDevice physicalDevice, VkDevice device,
+                         VkCommandPool commandPool, VkQueue queue);
+
+    void Destroy();
+
+    /**
+     * @brief 录制生成
+     *
+     * 深度缓冲需已转换为 DEPTH_STENCIL_READ_ONLY_OPTIMAL，
+     * 并对计算着色器可见；返回时金字塔对后续计算着色器可见
+     */
+    void Record(VkCommandBuffer cmd) const;
+
+    bool HasSource() const
+    {
+        return _hasSource;
+    }
+
+    /// 全部层级的视图（剔除时采样）
+    VkImageView GetImageView() const
+    {
+        return _imageView;
+    }
+
+    VkSampler GetSampler() const
+    {
+        return _sampler;
+    }
+
+    uint32_t GetLevelCount() const
+    {
+        return _levelCount;
+    }
+
+    /// 源深度缓冲的大小（像素）
+    VkExtent2D GetDepthExtent() const
+    {
+        return _depthExtent;
+    }
+
+private:
+    // 与 HiZ.comp 的 push constant 一致
+    struct ReduceParams
+    {
+        int32_t sourceWidth = 0;
+        int32_t sourceHeight = 0;
+        int32_t targetWidth = 0;
+        int32_t targetHeight = 0;
+        int32_t sampleCount = 1;
+    };
+
+    // 与 HiZ.comp 的 local_size 一致
+    static constexpr uint32_t REDUCE_GROUP_SIZE = 8;
+
+    bool createImage(VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
+                     VkQueue queue);
+
+    bool createPipelines(VkSampleCountFlagBits depthSamples);
+
+    bool createSets(VkImageView depthView);
+
+    VkPipeline createPipeline(const VulkanShaderModule &shader) const;
+
+    VkExtent2D levelExtent(uint32_t level) const;
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    bool _hasSource = false;
+
+    VkExtent2D _depthExtent{};
+
+    uint32_t _levelCount = 0;
+
+    int32_t _depthSamples = 1;
+
+    VkImage _image = VK_NULL_HANDLE;
+
+    VkDeviceMemory _memory = VK_NULL_HANDLE;
+
+    VkImageView _imageView = VK_NULL_HANDLE;
+
+    // 逐级视图（存储图像写入 / 下一级读取）
+    std::array<VkImageView, MAX_LEVELS> _levelViews{};
+
+    VkSampler _sampler = VK_NULL_HANDLE;
+
+    // binding 0：源（深度或上一级），1：目标层级
+    VulkanDescriptorSetLayout *_setLayout = nullptr;
+
+    VulkanDescriptorPool *_pool = nullptr;
+
+    std::array<VkDescriptorSet, MAX_LEVELS> _sets{};
+
+    VulkanPipelineLayout _layout;
+
+    VulkanShaderModule _reduceShader;
+
+    VulkanShaderModule _depthShader;
+
+    // 逐级缩减（也用于单采样深度），多重采样深度使用单独的管线
+    VkPipeline _reducePipeline = VK_NULL_HANDLE;
+
+    VkPipeline _depthPipeline = VK_NULL_HANDLE;
+};
+
+} // namespace VKB
+
+#endif // !VULKANDEPTHPYRAMID_H_
@@ -1,5 +1,13 @@
 ﻿#include "VulkanDescriptorSet.h"
 
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "PrintMsg.h"
+
 namespace VKB
 {
 VulkanDescriptorSet::~VulkanDescriptorSet()
@@ -7,60 +15,164 @@ VulkanDescriptorSet::~VulkanDescriptorSet()
     // DescriptorSet 本身不销毁 Pool 的资源
 }
 
-void VulkanDescriptorSet::Init(VkDevice device, VkDescriptorSet set)
+void VulkanDescriptorSet::Init(VkDevice device, VkDescriptorSet set,
+                               VulkanDescriptorSetLayout *layout)
 {
     _device = device;
     _set = set;
+    _layout = layout;
+    _pending = 0;
 }
 
 void VulkanDescriptorSet::UpdateBuffer(uint32_t binding, const VkBuffer &buffer,
-                                       uint32_t bufferSize)
+                                       uint32_t bufferSize,
+                                       VkDescriptorType type)
 {
-    VkDescriptorBufferInfo bufferInfo{};
+    if (binding >= MAX_BINDINGS) {
+        PSG::PrintError("描述符绑定号超出范围!");
+        return;
+    }
+
+    VkDescriptorBufferInfo &bufferInfo = _infos[binding].buffer;
     bufferInfo.buffer = buffer;
     bufferInfo.offset = 0;
     bufferInfo.range = bufferSize;
 
-    VkWriteDescriptorSet descriptorWrite{};
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.dstSet = _set;
-    descriptorWrite.dstBinding = binding;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.pBufferInfo = &bufferInfo;
-
-    vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+    _types[binding] = type;
+    _pending |= 1u << binding;
 }
 
 void VulkanDescriptorSet::UpdateBuffer(uint32_t binding,
                                        VkImageView textureImageView,
                                        VkSampler textureSampler)
 {
+    if (binding >= MAX_BINDINGS) {
+        PSG::PrintError("描述符绑定号超出范围!");
+        return;
+    }
+
     // 图像信息
-    VkDescriptorImageInfo imageInfo{};
+    VkDescriptorImageInfo &imageInfo = _infos[binding].image;
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     imageInfo.imageView = textureImageView;
     imageInfo.sampler = textureSampler;
 
+    // 描述符类型：组合图像采样器
+    _types[binding] = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    _pending |= 1u << binding;
+}
+
+void VulkanDescriptorSet::Flush()
+{
+    if (0 == _pending) {
+        return;
+    }
+
+    // 模板按 binding 号从 _infos 中读取，一次写入全部待写绑定
+    VkDescriptorUpdateTemplate updateTemplate =
+        _layout ? _layout->GetUpdateTemplate(_pending) : VK_NULL_HANDLE;
+    if (updateTemplate != VK_NULL_HANDLE) {
+        vkUpdateDescriptorSetWithTemplate(_device, _set, updateTemplate,
+                                          _infos.data());
+        _pending = 0;
+        return;
+    }
+
+    // 没有模板时合并为一次 vkUpdateDescriptorSets
+    std::array<VkWriteDescriptorSet, MAX_BINDINGS> writes{};
+    uint32_t writeCount = 0;
+    for (uint32_t binding = 0; binding < MAX_BINDINGS; ++binding) {
+        if (0 == (_pending & (1u << binding))) {
+            continue;
+        }
+
+        writes[writeCount++] = makeWrite(binding);
+    }
+
+    vkUpdateDescriptorSets(_device, writeCount, writes.data(), 0, nullptr);
+    _pending = 0;
+}
+
+void VulkanDescriptorSet::Benchmark(uint32_t iterations)
+{
+    const uint32_t mask = _pending;
+    VkDescriptorUpdateTemplate updateTemplate =
+        _layout ? _layout->GetUpdateTemplate(mask) : VK_NULL_HANDLE;
+    if (0 == mask || VK_NULL_HANDLE == updateTemplate || 0 == iterations) {
+        PSG::PrintError("描述符基准需要暂存的写入和可生成模板的布局!");
+        return;
+    }
+
+    std::array<VkWriteDescriptorSet, MAX_BINDINGS> writes{};
+    uint32_t writeCount = 0;
+    for (uint32_t binding = 0; binding < MAX_BINDINGS; ++binding) {
+        if (mask & (1u << binding)) {
+            writes[writeCount++] = makeWrite(binding);
+        }
+    }
+
+    // 每次更新整个 set 的平均耗时（微秒）
+    auto measure = [&](auto &&update) {
+        update();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            update();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(elapsed).count()
+               / iterations;
+    };
+
+    // 修改前的做法：每个绑定一次调用
+    const double perWriteTime = measure([&]() {
+        for (uint32_t i = 0; i < writeCount; ++i) {
+            vkUpdateDescriptorSets(_device, 1, &writes[i], 0, nullptr);
+        }
+    });
+
+    const double batchedTime = measure([&]() {
+        vkUpdateDescriptorSets(_device, writeCount, writes.data(), 0, nullptr);
+    });
+
+    const double templateTime = measure([&]() {
+        vkUpdateDescriptorSetWithTemplate(_device, _set, updateTemplate,
+                                          _infos.data());
+    });
+    _pending = 0;
+
+    auto formatUs = [](double us) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(3) << us << " us";
+        return stream.str();
+    };
+
+    PSG::PrintMsg("描述符更新基准",
+                  std::to_string(std::popcount(mask)) + " 个绑定, "
+                      + std::to_string(iterations) + " 次");
+    PSG::PrintMsg("  逐个写入", formatUs(perWriteTime));
+    PSG::PrintMsg("  合并写入", formatUs(batchedTime));
+    PSG::PrintMsg("  更新模板", formatUs(templateTime));
+}
+
+VkWriteDescriptorSet VulkanDescriptorSet::makeWrite(uint32_t binding) const
+{
     VkWriteDescriptorSet descriptorWrite{};
     descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 
-    // 目标描述符集
+    // 目标描述符集，对应 shader 中的 binding = X
     descriptorWrite.dstSet = _set;
-
-    // 对应 shader 中的 binding = X
     descriptorWrite.dstBinding = binding;
     descriptorWrite.dstArrayElement = 0;
-
-    // 描述符类型：组合图像采样器
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorType = _types[binding];
     descriptorWrite.descriptorCount = 1;
 
-    // 指向纹理采样器信息
-    descriptorWrite.pImageInfo = &imageInfo;
-
-    vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+    if (VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER == _types[binding]) {
+        descriptorWrite.pImageInfo = &_infos[binding].image;
+    } else {
+        descriptorWrite.pBufferInfo = &_infos[binding].buffer;
+    }
+    return descriptorWrite;
 }
 
 } // namespace VKB
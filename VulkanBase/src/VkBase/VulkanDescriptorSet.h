@@ -1,12 +1,22 @@
 ﻿#ifndef VULKANDESCRIPTORSET_H_
 #define VULKANDESCRIPTORSET_H_
 
+#include <array>
+
 #include "VulkanBuffer.h"
+#include "VulkanDescriptorSetLayout.h"
 #include <vulkan/vulkan.h>
 
 namespace VKB
 {
 
+/**
+ * @brief VulkanDescriptorSet
+ *
+ * - UpdateBuffer 只暂存写入，Flush 时一次调用全部提交
+ * - 指定了布局时用布局生成的更新模板（vkUpdateDescriptorSetWithTemplate），
+ *   否则合并为一次 vkUpdateDescriptorSets
+ */
 class VulkanDescriptorSet
 {
 public:
@@ -14,27 +24,63 @@ public:
 
     ~VulkanDescriptorSet();
 
-    void Init(VkDevice device, VkDescriptorSet set);
+    /**
+     * @brief 指向新的 DescriptorSet（未 Flush 的写入被丢弃）
+     * @param layout 分配 set 时使用的布局（可为空，为空时不使用模板）
+     */
+    void Init(VkDevice device, VkDescriptorSet set,
+              VulkanDescriptorSetLayout *layout = nullptr);
 
-    // 更新 uniform buffer
-    void UpdateBuffer(uint32_t binding, const VkBuffer &buffer,
-                      uint32_t bufferSize);
+    // 更新 uniform buffer（存储缓冲传入 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER）
+    void
+    UpdateBuffer(uint32_t binding, const VkBuffer &buffer, uint32_t bufferSize,
+                 VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
 
     // 更新 uniform buffer
     void UpdateBuffer(uint32_t binding, VkImageView textureImageView,
                       VkSampler textureSampler);
 
+    /**
+     * @brief 一次提交全部暂存的写入
+     */
+    void Flush();
+
+    /**
+     * @brief 描述符更新微基准：用当前暂存的写入比较
+     *        逐个 vkUpdateDescriptorSets / 合并一次调用 / 更新模板
+     *
+     * 结束时暂存的写入已提交（与 Flush 结果相同）
+     */
+    void Benchmark(uint32_t iterations = 100000);
+
     VkDescriptorSet Get() const
     {
         return _set;
     }
 
 private:
+    // 暂存的 binding 对应的 VkWriteDescriptorSet
+    VkWriteDescriptorSet makeWrite(uint32_t binding) const;
+
+private:
+    static constexpr uint32_t MAX_BINDINGS =
+        VulkanDescriptorSetLayout::MAX_TEMPLATE_BINDINGS;
+
     VkDevice _device = VK_NULL_HANDLE;
 
     VkDescriptorSet _set = VK_NULL_HANDLE;
+
+    VulkanDescriptorSetLayout *_layout = nullptr;
+
+    // 按 binding 号排列的暂存数据（即模板数据）
+    std::array<DescriptorInfo, MAX_BINDINGS> _infos{};
+
+    std::array<VkDescriptorType, MAX_BINDINGS> _types{};
+
+    // 待写入的绑定
+    uint32_t _pending = 0;
 };
 
 } // namespace VKB
 
-#endif // !VULKANDESCRIPTORSET_H_
\ No newline at end of file
+#endif // !VULKANDESCRIPTORSET_H_
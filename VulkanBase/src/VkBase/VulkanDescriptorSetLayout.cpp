@@ -1,10 +1,21 @@
 ﻿#include "VulkanDescriptorSetLayout.h"
 
+#include "PrintMsg.h"
+
 namespace VKB
 {
 
 VulkanDescriptorSetLayout::~VulkanDescriptorSetLayout()
 {
+    for (auto &[mask, updateTemplate] : _templates) {
+        vkDestroyDescriptorUpdateTemplate(_device, updateTemplate, nullptr);
+    }
+    _templates.clear();
+
+    if (_pushTemplate != VK_NULL_HANDLE) {
+        vkDestroyDescriptorUpdateTemplate(_device, _pushTemplate, nullptr);
+    }
+
     if (_layout != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(_device, _layout, nullptr);
     }
@@ -34,18 +45,126 @@ VulkanDescriptorSetLayout::Make(uint32_t binding, VkDescriptorType type,
 }
 
 bool VulkanDescriptorSetLayout::Init(
-    VkDevice device, const std::vector<VkDescriptorSetLayoutBinding> &bindings)
+    VkDevice device, const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+    bool pushDescriptor)
 {
     _device = device;
+    _bindings = bindings;
+    _pushDescriptor = pushDescriptor;
 
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
     layoutInfo.pBindings = bindings.data();
+    if (pushDescriptor) {
+        layoutInfo.flags =
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
 
     VkResult ret =
         vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &_layout);
     return ret == VK_SUCCESS;
 }
 
+VkDescriptorUpdateTemplate
+VulkanDescriptorSetLayout::GetUpdateTemplate(uint32_t bindingMask)
+{
+    if (0 == bindingMask || _pushDescriptor) {
+        return VK_NULL_HANDLE;
+    }
+
+    auto it = _templates.find(bindingMask);
+    if (it != _templates.end()) {
+        return it->second;
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    createInfo.descriptorSetLayout = _layout;
+
+    VkDescriptorUpdateTemplate updateTemplate =
+        createTemplate(bindingMask, createInfo);
+    if (updateTemplate != VK_NULL_HANDLE) {
+        _templates.emplace(bindingMask, updateTemplate);
+    }
+    return updateTemplate;
+}
+
+VkDescriptorUpdateTemplate
+VulkanDescriptorSetLayout::GetPushTemplate(VkPipelineBindPoint bindPoint,
+                                           VkPipelineLayout pipelineLayout,
+                                           uint32_t set)
+{
+    if (!_pushDescriptor) {
+        return VK_NULL_HANDLE;
+    }
+
+    if (_pushTemplate != VK_NULL_HANDLE) {
+        return _pushTemplate;
+    }
+
+    uint32_t bindingMask = 0;
+    for (const VkDescriptorSetLayoutBinding &binding : _bindings) {
+        if (binding.binding < MAX_TEMPLATE_BINDINGS) {
+            bindingMask |= 1u << binding.binding;
+        }
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    createInfo.templateType =
+        VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+    createInfo.pipelineBindPoint = bindPoint;
+    createInfo.pipelineLayout = pipelineLayout;
+    createInfo.set = set;
+
+    _pushTemplate = createTemplate(bindingMask, createInfo);
+    return _pushTemplate;
+}
+
+VkDescriptorUpdateTemplate VulkanDescriptorSetLayout::createTemplate(
+    uint32_t bindingMask,
+    const VkDescriptorUpdateTemplateCreateInfo &createInfo)
+{
+    // 每个绑定一项，数据按 binding 号在 DescriptorInfo 数组中定位
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+    for (const VkDescriptorSetLayoutBinding &binding : _bindings) {
+        if (binding.binding >= MAX_TEMPLATE_BINDINGS
+            || 0 == (bindingMask & (1u << binding.binding))) {
+            continue;
+        }
+
+        VkDescriptorUpdateTemplateEntry entry{};
+        entry.dstBinding = binding.binding;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = 1;
+        entry.descriptorType = binding.descriptorType;
+        entry.offset = binding.binding * sizeof(DescriptorInfo);
+        entry.stride = sizeof(DescriptorInfo);
+        entries.push_back(entry);
+
+        bindingMask &= ~(1u << binding.binding);
+    }
+
+    // 掩码中还有布局里不存在的绑定
+    if (bindingMask != 0 || entries.empty()) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo info = createInfo;
+    info.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+    info.pDescriptorUpdateEntries = entries.data();
+
+    VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+    if (vkCreateDescriptorUpdateTemplate(_device, &info, nullptr,
+                                         &updateTemplate)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建描述符更新模板失败!");
+        return VK_NULL_HANDLE;
+    }
+
+    return updateTemplate;
+}
+
 } // namespace VKB
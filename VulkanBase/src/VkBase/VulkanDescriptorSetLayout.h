@@ -1,14 +1,38 @@
 ﻿#ifndef VULKANDESCRIPTORSETLAYOUT_H_
 #define VULKANDESCRIPTORSETLAYOUT_H_
 
+#include <unordered_map>
+
 #include "VulkanHead.h"
 
 namespace VKB
 {
 
+/**
+ * @brief 更新模板的数据单元
+ *
+ * 模板数据是按 binding 号排列的 DescriptorInfo 数组，
+ * 第 binding 个元素存放该绑定的缓冲或图像信息
+ */
+union DescriptorInfo
+{
+    VkDescriptorBufferInfo buffer;
+    VkDescriptorImageInfo image;
+};
+
+/**
+ * @brief VulkanDescriptorSetLayout
+ *
+ * - 记录布局的全部绑定，按需生成 DescriptorUpdateTemplate
+ * - 普通模板按要写入的绑定集合（位掩码）缓存，一次调用写入整个集合
+ * - 推送描述符布局（pushDescriptor）生成推送模板，直接录制进命令缓冲
+ * - 模板只写数组的第 0 个元素，binding 号需小于 MAX_TEMPLATE_BINDINGS
+ */
 class VulkanDescriptorSetLayout
 {
 public:
+    static constexpr uint32_t MAX_TEMPLATE_BINDINGS = 32;
+
     VulkanDescriptorSetLayout() = default;
 
     ~VulkanDescriptorSetLayout();
@@ -18,18 +42,63 @@ public:
                                       VkShaderStageFlags stageFlags,
                                       uint32_t count = 1);
 
+    /**
+     * @brief 创建布局
+     * @param pushDescriptor 是否为推送描述符布局
+     *                       （需要 VK_KHR_push_descriptor，不能从池中分配）
+     */
     bool Init(VkDevice device,
-              const std::vector<VkDescriptorSetLayoutBinding> &bindings);
+              const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+              bool pushDescriptor = false);
+
+    /**
+     * @brief 写入 bindingMask 中各绑定的更新模板（首次使用时创建）
+     * @return 掩码为空、包含布局外的绑定或创建失败时返回空
+     */
+    VkDescriptorUpdateTemplate GetUpdateTemplate(uint32_t bindingMask);
+
+    /**
+     * @brief 推送全部绑定的模板（首次使用时创建）
+     * @param pipelineLayout 推送时使用的管线布局
+     * @param set 本布局在管线布局中的集合序号
+     */
+    VkDescriptorUpdateTemplate
+    GetPushTemplate(VkPipelineBindPoint bindPoint,
+                    VkPipelineLayout pipelineLayout, uint32_t set);
 
     VkDescriptorSetLayout Get() const
     {
         return _layout;
     }
 
+    bool IsPushDescriptor() const
+    {
+        return _pushDescriptor;
+    }
+
+    const std::vector<VkDescriptorSetLayoutBinding> &GetBindings() const
+    {
+        return _bindings;
+    }
+
+private:
+    VkDescriptorUpdateTemplate
+    createTemplate(uint32_t bindingMask,
+                   const VkDescriptorUpdateTemplateCreateInfo &createInfo);
+
 private:
     VkDevice _device = VK_NULL_HANDLE;
 
     VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+
+    std::vector<VkDescriptorSetLayoutBinding> _bindings;
+
+    bool _pushDescriptor = false;
+
+    // 绑定掩码 -> 普通更新模板
+    std::unordered_map<uint32_t, VkDescriptorUpdateTemplate> _templates;
+
+    VkDescriptorUpdateTemplate _pushTemplate = VK_NULL_HANDLE;
 };
 
 } // namespace VKB
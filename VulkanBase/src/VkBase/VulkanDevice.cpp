@@ -56,19 +56,102 @@ bool VulkanDevice::Init(const VulkanPhysicalDevice *physicalDevice)
         static_cast<uint32_t>(queueCreateInfo.size());
     createInfo.pQueueCreateInfos = queueCreateInfo.data();
 
-    // 扩展启用信息
-    createInfo.enabledExtensionCount =
-        static_cast<uint32_t>(_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = _deviceExtensions.data();
+    // 可选特性：物理设备支持才启用
+    _enabledFeatures = physicalDevice->GetFeatureSupport();
+
+    // 扩展启用信息（必需扩展 + 已支持的可选扩展）
+    std::vector<const char *> extensions = _deviceExtensions;
+    if (_enabledFeatures.extendedDynamicState3PolygonMode) {
+        extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    }
+    if (_enabledFeatures.graphicsPipelineLibrary) {
+        extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+    if (_enabledFeatures.presentWait) {
+        extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+    if (_enabledFeatures.pushDescriptor) {
+        extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     // 特性(Feature可根据需要加)
-    VkPhysicalDeviceFeatures deviceFeatures{};
+    VkPhysicalDeviceFeatures2 deviceFeatures{};
+    deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     // 各向异性过滤实际上是一个可选的设备特性
-    deviceFeatures.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.features.samplerAnisotropy = VK_TRUE;
     // 为设备启用样本着色功能
-    deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.features.sampleRateShading = VK_TRUE;
+    // 间接绘制（GPU 驱动渲染）
+    deviceFeatures.features.drawIndirectFirstInstance =
+        _enabledFeatures.drawIndirectFirstInstance;
+    deviceFeatures.features.multiDrawIndirect =
+        _enabledFeatures.multiDrawIndirect;
+
+    // 特性启用链：deviceFeatures -> 1.2 -> 1.3 -> 已支持扩展的特性结构体
+    void **next = &deviceFeatures.pNext;
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.drawIndirectCount = _enabledFeatures.drawIndirectCount;
+    if (_enabledFeatures.descriptorIndexing) {
+        features12.runtimeDescriptorArray = VK_TRUE;
+        features12.descriptorBindingPartiallyBound = VK_TRUE;
+        features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    }
 
-    createInfo.pEnabledFeatures = &deviceFeatures;
+    VkPhysicalDeviceVulkan13Features features13{};
+    features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    features13.dynamicRendering = _enabledFeatures.dynamicRendering;
+    if (physicalDevice->GetProperties().apiVersion >= VK_API_VERSION_1_3) {
+        *next = &features12;
+        next = &features12.pNext;
+        *next = &features13;
+        next = &features13.pNext;
+    }
+
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3Features{};
+    eds3Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    eds3Features.extendedDynamicState3PolygonMode = VK_TRUE;
+    if (_enabledFeatures.extendedDynamicState3PolygonMode) {
+        *next = &eds3Features;
+        next = &eds3Features.pNext;
+    }
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT gplFeatures{};
+    gplFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    gplFeatures.graphicsPipelineLibrary = VK_TRUE;
+    if (_enabledFeatures.graphicsPipelineLibrary) {
+        *next = &gplFeatures;
+        next = &gplFeatures.pNext;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.presentId = VK_TRUE;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitFeatures.presentWait = VK_TRUE;
+    if (_enabledFeatures.presentWait) {
+        *next = &presentIdFeatures;
+        next = &presentIdFeatures.pNext;
+        *next = &presentWaitFeatures;
+        next = &presentWaitFeatures.pNext;
+    }
+
+    // 使用 pNext 链启用特性时 pEnabledFeatures 必须为空
+    createInfo.pNext = &deviceFeatures;
+    createInfo.pEnabledFeatures = nullptr;
 
     // 创建逻辑设备
     VkResult ret = vkCreateDevice(phyDevice, &createInfo, nullptr, &_device);
@@ -81,6 +164,25 @@ bool VulkanDevice::Init(const VulkanPhysicalDevice *physicalDevice)
     vkGetDeviceQueue(_device, graphicsFamily, 0, &_graphicsQueue);
     vkGetDeviceQueue(_device, presentFamily, 0, &_presentQueue);
 
+    // 扩展函数需要通过 vkGetDeviceProcAddr 获取
+    if (_enabledFeatures.extendedDynamicState3PolygonMode) {
+        _cmdSetPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+            vkGetDeviceProcAddr(_device, "vkCmdSetPolygonModeEXT"));
+    }
+    if (_enabledFeatures.presentWait) {
+        _waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(_device, "vkWaitForPresentKHR"));
+        _enabledFeatures.presentWait = _waitForPresent != nullptr;
+    }
+    if (_enabledFeatures.pushDescriptor) {
+        _cmdPushDescriptorSetWithTemplate =
+            reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+                vkGetDeviceProcAddr(_device,
+                                    "vkCmdPushDescriptorSetWithTemplateKHR"));
+        _enabledFeatures.pushDescriptor =
+            _cmdPushDescriptorSetWithTemplate != nullptr;
+    }
+
     return true;
 }
 
@@ -92,6 +194,9 @@ void VulkanDevice::Destroy()
         _device = VK_NULL_HANDLE;
         _graphicsQueue = VK_NULL_HANDLE;
         _presentQueue = VK_NULL_HANDLE;
+        _cmdSetPolygonMode = nullptr;
+        _waitForPresent = nullptr;
+        _cmdPushDescriptorSetWithTemplate = nullptr;
     }
 }
 
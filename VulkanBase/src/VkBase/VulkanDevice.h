@@ -58,6 +58,39 @@ public:
         return _presentQueue;
     }
 
+    /**
+     * @brief 获取已启用的可选特性
+     */
+    const DeviceFeatureSupport &GetEnabledFeatures() const
+    {
+        return _enabledFeatures;
+    }
+
+    /**
+     * @brief vkCmdSetPolygonModeEXT（未启用 EDS3 时为空）
+     */
+    PFN_vkCmdSetPolygonModeEXT GetCmdSetPolygonMode() const
+    {
+        return _cmdSetPolygonMode;
+    }
+
+    /**
+     * @brief vkWaitForPresentKHR（未启用 present_wait 时为空）
+     */
+    PFN_vkWaitForPresentKHR GetWaitForPresent() const
+    {
+        return _waitForPresent;
+    }
+
+    /**
+     * @brief vkCmdPushDescriptorSetWithTemplateKHR（未启用推送描述符时为空）
+     */
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR
+    GetCmdPushDescriptorSetWithTemplate() const
+    {
+        return _cmdPushDescriptorSetWithTemplate;
+    }
+
 private:
     // 逻辑设备
     VkDevice _device = VK_NULL_HANDLE;
@@ -68,6 +101,17 @@ private:
     // 呈现队列
     VkQueue _presentQueue = VK_NULL_HANDLE;
 
+    // 已启用的可选特性
+    DeviceFeatureSupport _enabledFeatures;
+
+    // 扩展函数
+    PFN_vkCmdSetPolygonModeEXT _cmdSetPolygonMode = nullptr;
+
+    PFN_vkWaitForPresentKHR _waitForPresent = nullptr;
+
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR
+        _cmdPushDescriptorSetWithTemplate = nullptr;
+
 private:
     // 物理设备必需支持扩展
     const std::vector<const char *> _deviceExtensions = {
@@ -0,0 +1,128 @@
+﻿#include "VulkanDynamicState.h"
+
+#include "VulkanUtils.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 拓扑类别代表值
+VkPrimitiveTopology topologyClass(VkPrimitiveTopology topology)
+{
+    switch (topology) {
+    case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+        return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+    default:
+        return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+}
+} // namespace
+
+size_t DynamicDrawState::Hash() const
+{
+    size_t seed = 0;
+    HashCombine(seed, static_cast<uint32_t>(topology));
+    HashCombine(seed, cullMode);
+    HashCombine(seed, static_cast<uint32_t>(frontFace));
+    HashCombine(seed, static_cast<uint32_t>(polygonMode));
+    HashCombine(seed, depthTestEnable);
+    HashCombine(seed, depthWriteEnable);
+    HashCombine(seed, static_cast<uint32_t>(depthCompareOp));
+    return seed;
+}
+
+DynamicDrawState DynamicDrawState::StaticPart(uint32_t dynamicStates) const
+{
+    DynamicDrawState state = *this;
+
+    if (dynamicStates & DYNAMIC_STATE_EXTENDED) {
+        DynamicDrawState defaults{};
+        state.topology = topologyClass(topology);
+        state.cullMode = defaults.cullMode;
+        state.frontFace = defaults.frontFace;
+        state.depthTestEnable = defaults.depthTestEnable;
+        state.depthWriteEnable = defaults.depthWriteEnable;
+        state.depthCompareOp = defaults.depthCompareOp;
+    }
+
+    if (dynamicStates & DYNAMIC_STATE_POLYGON_MODE) {
+        state.polygonMode = VK_POLYGON_MODE_FILL;
+    }
+
+    return state;
+}
+
+void VulkanDynamicStateCache::Init(uint32_t dynamicStates,
+                                   PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode)
+{
+    _dynamicStates = dynamicStates;
+    _cmdSetPolygonMode = cmdSetPolygonMode;
+
+    // 没有函数指针时不能动态设置多边形模式
+    if (nullptr == _cmdSetPolygonMode) {
+        _dynamicStates &= ~DYNAMIC_STATE_POLYGON_MODE;
+    }
+
+    Reset();
+}
+
+void VulkanDynamicStateCache::Reset()
+{
+    _valid = false;
+    _setCount = 0;
+    _skipCount = 0;
+}
+
+void VulkanDynamicStateCache::Apply(VkCommandBuffer cmd,
+                                    const DynamicDrawState &state)
+{
+    // 每个状态单独比较，只提交变化的部分
+    auto changed = [&](bool differs) {
+        if (!_valid || differs) {
+            ++_setCount;
+            return true;
+        }
+        ++_skipCount;
+        return false;
+    };
+
+    if (_dynamicStates & DYNAMIC_STATE_EXTENDED) {
+        if (changed(state.topology != _current.topology)) {
+            vkCmdSetPrimitiveTopology(cmd, state.topology);
+        }
+        if (changed(state.cullMode != _current.cullMode)) {
+            vkCmdSetCullMode(cmd, state.cullMode);
+        }
+        if (changed(state.frontFace != _current.frontFace)) {
+            vkCmdSetFrontFace(cmd, state.frontFace);
+        }
+        if (changed(state.depthTestEnable != _current.depthTestEnable)) {
+            vkCmdSetDepthTestEnable(cmd, state.depthTestEnable);
+        }
+        if (changed(state.depthWriteEnable != _current.depthWriteEnable)) {
+            vkCmdSetDepthWriteEnable(cmd, state.depthWriteEnable);
+        }
+        if (changed(state.depthCompareOp != _current.depthCompareOp)) {
+            vkCmdSetDepthCompareOp(cmd, state.depthCompareOp);
+        }
+    }
+
+    if (_dynamicStates & DYNAMIC_STATE_POLYGON_MODE) {
+        if (changed(state.polygonMode != _current.polygonMode)) {
+            _cmdSetPolygonMode(cmd, state.polygonMode);
+        }
+    }
+
+    _current = state;
+    _valid = true;
+}
+
+} // namespace VKB
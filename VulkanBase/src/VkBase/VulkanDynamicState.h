@@ -0,0 +1,120 @@
+﻿#ifndef VULKANDYNAMICSTATE_H_
+#define VULKANDYNAMICSTATE_H_
+
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 动态状态模式位
+ *
+ * 启用后对应状态不再参与管线创建，而是在录制时逐 Draw 设置
+ */
+enum DynamicStateBits : uint32_t
+{
+    DYNAMIC_STATE_NONE = 0,
+
+    // VK_EXT_extended_dynamic_state（Vulkan 1.3 核心）：
+    // 剔除、正面朝向、图元拓扑、深度测试 / 写入 / 比较
+    DYNAMIC_STATE_EXTENDED = 1 << 0,
+
+    // VK_EXT_extended_dynamic_state3：多边形模式
+    DYNAMIC_STATE_POLYGON_MODE = 1 << 1,
+};
+
+/**
+ * @brief 可动态设置的绘制状态
+ */
+struct DynamicDrawState
+{
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkBool32 depthTestEnable = VK_TRUE;
+    VkBool32 depthWriteEnable = VK_TRUE;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+
+    bool operator==(const DynamicDrawState &other) const = default;
+
+    size_t Hash() const;
+
+    /**
+     * @brief 清除动态部分，得到管线缓存使用的静态状态
+     *
+     * 动态拓扑要求管线中的拓扑与实际使用的属于同一类（点 / 线 / 三角形），
+     * 所以拓扑只归一化到同类的代表值
+     */
+    DynamicDrawState StaticPart(uint32_t dynamicStates) const;
+};
+
+/**
+ * @brief VulkanDynamicStateCache
+ *
+ * 录制期间的动态状态缓存：
+ * - 只在状态变化时调用 vkCmdSet*（冗余过滤）
+ * - 每个 CommandBuffer 开始录制时 Reset
+ */
+class VulkanDynamicStateCache
+{
+public:
+    VulkanDynamicStateCache() = default;
+
+    ~VulkanDynamicStateCache() = default;
+
+public:
+    /**
+     * @brief 初始化
+     * @param dynamicStates 启用的 DynamicStateBits
+     * @param cmdSetPolygonMode EDS3 函数指针（未启用时为空）
+     */
+    void Init(uint32_t dynamicStates,
+              PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode = nullptr);
+
+    /**
+     * @brief 开始新的录制，之前设置的状态全部失效
+     */
+    void Reset();
+
+    /**
+     * @brief 设置一次 Draw 的动态状态（只提交变化部分）
+     */
+    void Apply(VkCommandBuffer cmd, const DynamicDrawState &state);
+
+    uint32_t GetDynamicStates() const
+    {
+        return _dynamicStates;
+    }
+
+    /// 实际调用 vkCmdSet* 的次数
+    uint32_t GetSetCount() const
+    {
+        return _setCount;
+    }
+
+    /// 被过滤掉的冗余设置次数
+    uint32_t GetSkipCount() const
+    {
+        return _skipCount;
+    }
+
+private:
+    uint32_t _dynamicStates = DYNAMIC_STATE_NONE;
+
+    PFN_vkCmdSetPolygonModeEXT _cmdSetPolygonMode = nullptr;
+
+    // 当前命令缓冲中的状态
+    DynamicDrawState _current;
+
+    // 首次 Apply 之前状态未定义，必须全部设置
+    bool _valid = false;
+
+    uint32_t _setCount = 0;
+
+    uint32_t _skipCount = 0;
+};
+
+} // namespace VKB
+
+#endif // !VULKANDYNAMICSTATE_H_
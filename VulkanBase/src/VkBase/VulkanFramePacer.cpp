@@ -0,0 +1,157 @@
+﻿#include "VulkanFramePacer.h"
+
+#include <algorithm>
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+namespace
+{
+// present_wait 的等待上限（纳秒），避免窗口被遮挡时永久阻塞
+constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100000000;
+} // namespace
+
+VulkanFramePacer::VulkanFramePacer()
+{
+}
+
+VulkanFramePacer::~VulkanFramePacer()
+{
+    Destroy();
+}
+
+bool VulkanFramePacer::Init(VkDevice device,
+                            PFN_vkWaitForPresentKHR waitForPresent,
+                            uint32_t framesInFlight)
+{
+    if (VK_NULL_HANDLE == device || 0 == framesInFlight
+        || framesInFlight >= HISTORY_SIZE) {
+        PSG::PrintError("初始化帧节拍失败：参数无效!");
+        return false;
+    }
+
+    _device = device;
+    _waitForPresent = waitForPresent;
+    _framesInFlight = framesInFlight;
+    _slotStarts.assign(framesInFlight, Clock::time_point());
+    _slotPending.assign(framesInFlight, false);
+    return true;
+}
+
+void VulkanFramePacer::Destroy()
+{
+    _device = VK_NULL_HANDLE;
+    _swapchain = VK_NULL_HANDLE;
+    _waitForPresent = nullptr;
+    _slotStarts.clear();
+    _slotPending.clear();
+}
+
+void VulkanFramePacer::SetSwapchain(VkSwapchainKHR swapchain,
+                                    VkPresentModeKHR presentMode)
+{
+    // 新交换链的 presentId 重新计数，之前未确认的呈现不再等待
+    _swapchain = swapchain;
+    _presentMode = presentMode;
+    _presentId = 0;
+    _displayedId = 0;
+    _pendingId = 0;
+
+    // 不同模式的延迟分开统计
+    _sampleCount = 0;
+    _latencySum = 0.0;
+    _latencyMax = 0.0;
+}
+
+void VulkanFramePacer::FrameRetired(uint32_t frame)
+{
+    if (IsUsingPresentWait() || !_slotPending[frame]) {
+        return;
+    }
+
+    _slotPending[frame] = false;
+    addSample(_slotStarts[frame]);
+}
+
+void VulkanFramePacer::BeginFrame(uint32_t frame)
+{
+    // 最多允许 framesInFlight - 1 个呈现排队，更早的必须已经显示
+    if (IsUsingPresentWait() && _presentId >= _framesInFlight) {
+        const uint64_t target = _presentId - (_framesInFlight - 1);
+        if (target > _displayedId) {
+            VkResult ret = _waitForPresent(_device, _swapchain, target,
+                                           PRESENT_WAIT_TIMEOUT);
+            if (VK_SUCCESS == ret) {
+                _displayedId = target;
+                addSample(_presentStarts[target % HISTORY_SIZE]);
+            }
+        }
+    }
+
+    _frameStart = Clock::now();
+    _slotStarts[frame] = _frameStart;
+    _slotPending[frame] = true;
+}
+
+void VulkanFramePacer::PreparePresent(VkPresentInfoKHR &presentInfo)
+{
+    if (!IsUsingPresentWait() || VK_NULL_HANDLE == _swapchain) {
+        return;
+    }
+
+    _pendingId = ++_presentId;
+    _presentStarts[_pendingId % HISTORY_SIZE] = _frameStart;
+
+    _presentIdInfo = {};
+    _presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    _presentIdInfo.swapchainCount = 1;
+    _presentIdInfo.pPresentIds = &_pendingId;
+    presentInfo.pNext = &_presentIdInfo;
+}
+
+void VulkanFramePacer::addSample(Clock::time_point start)
+{
+    const double ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count();
+
+    ++_sampleCount;
+    _latencySum += ms;
+    _latencyMax = std::max(_latencyMax, ms);
+
+    if (_sampleCount < REPORT_FRAMES) {
+        return;
+    }
+
+    _averageLatency = static_cast<float>(_latencySum / _sampleCount);
+    PSG::PrintMsg(
+        "呈现延迟",
+        PresentModeName(_presentMode) + " / " + std::to_string(_framesInFlight)
+            + " 帧, 平均 " + std::to_string(_averageLatency) + " ms, 最大 "
+            + std::to_string(_latencyMax) + " ms"
+            + (IsUsingPresentWait() ? " (显示)" : " (GPU 完成)"));
+
+    _sampleCount = 0;
+    _latencySum = 0.0;
+    _latencyMax = 0.0;
+}
+
+std::string PresentModeName(VkPresentModeKHR mode)
+{
+    switch (mode) {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "IMMEDIATE";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "MAILBOX";
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "FIFO";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "FIFO_RELAXED";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+} // namespace VKB
@@ -0,0 +1,132 @@
+﻿#ifndef VULKANFRAMEPACER_H_
+#define VULKANFRAMEPACER_H_
+
+#include <chrono>
+#include <string>
+
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanFramePacer
+ *
+ * 帧节拍与延迟统计：
+ * - 支持 VK_KHR_present_wait 时，每次呈现带递增的 presentId，
+ *   开始新一帧（采样输入）之前等待更早的呈现真正显示，
+ *   只允许 framesInFlight - 1 帧排队，减少输入到显示的延迟
+ * - 延迟 = 帧开始（采样输入）到显示（present_wait）
+ *   或到 GPU 完成（不支持时，以帧栅栏近似）
+ * - 每 REPORT_FRAMES 帧按当前呈现模式输出平均 / 最大延迟
+ */
+class VulkanFramePacer
+{
+public:
+    VulkanFramePacer();
+
+    ~VulkanFramePacer();
+
+public:
+    /**
+     * @brief 初始化
+     * @param waitForPresent vkWaitForPresentKHR，为空时只统计 GPU 完成延迟
+     * @param framesInFlight 并行帧数
+     */
+    bool Init(VkDevice device, PFN_vkWaitForPresentKHR waitForPresent,
+              uint32_t framesInFlight);
+
+    void Destroy();
+
+    /**
+     * @brief 设置交换链（创建 / 重建后调用）
+     */
+    void SetSwapchain(VkSwapchainKHR swapchain, VkPresentModeKHR presentMode);
+
+    /**
+     * @brief 该帧栅栏已等待：记录上次使用该帧槽位的 GPU 完成延迟
+     */
+    void FrameRetired(uint32_t frame);
+
+    /**
+     * @brief 开始一帧（采样输入之前调用）
+     *
+     * 启用 present_wait 时等待排队的呈现显示，再记录帧开始时间
+     */
+    void BeginFrame(uint32_t frame);
+
+    /**
+     * @brief 为本次呈现填写 presentId（未启用 present_wait 时不修改）
+     * @param presentInfo 呈现信息，pNext 指向内部的 VkPresentIdKHR
+     */
+    void PreparePresent(VkPresentInfoKHR &presentInfo);
+
+    /// 是否按 present_wait 节拍
+    bool IsUsingPresentWait() const
+    {
+        return _waitForPresent != nullptr;
+    }
+
+    /// 上一个统计周期的平均延迟（毫秒）
+    float GetAverageLatency() const
+    {
+        return _averageLatency;
+    }
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    // 每多少个采样输出一次统计
+    static constexpr uint32_t REPORT_FRAMES = 240;
+
+    // 按 presentId 记录帧开始时间的环形缓冲（需大于最大并行帧数）
+    static constexpr uint32_t HISTORY_SIZE = 8;
+
+    void addSample(Clock::time_point start);
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VkSwapchainKHR _swapchain = VK_NULL_HANDLE;
+
+    VkPresentModeKHR _presentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+    PFN_vkWaitForPresentKHR _waitForPresent = nullptr;
+
+    uint32_t _framesInFlight = 1;
+
+    // 当前帧的开始时间（呈现时按 presentId 保存）
+    Clock::time_point _frameStart;
+
+    // 每个帧槽位的开始时间（GPU 完成延迟使用）
+    std::vector<Clock::time_point> _slotStarts;
+
+    std::vector<bool> _slotPending;
+
+    // 按 presentId 保存的帧开始时间
+    Clock::time_point _presentStarts[HISTORY_SIZE];
+
+    // 已呈现的最大 presentId / 已确认显示的最大 presentId
+    uint64_t _presentId = 0;
+    uint64_t _displayedId = 0;
+
+    // 本次呈现使用的 presentId（PreparePresent 时挂到 pNext）
+    uint64_t _pendingId = 0;
+    VkPresentIdKHR _presentIdInfo{};
+
+    // 当前统计周期
+    uint32_t _sampleCount = 0;
+    double _latencySum = 0.0;
+    double _latencyMax = 0.0;
+
+    float _averageLatency = 0.0f;
+};
+
+/**
+ * @brief 呈现模式名称（日志使用）
+ */
+std::string PresentModeName(VkPresentModeKHR mode);
+
+} // namespace VKB
+
+#endif // !VULKANFRAMEPACER_H_
@@ -0,0 +1,63 @@
+﻿#include "VulkanFramePacket.h"
+
+namespace VKB
+{
+
+FramePacketBuffer::FramePacketBuffer()
+{
+}
+
+FramePacketBuffer::~FramePacketBuffer()
+{
+    Stop();
+}
+
+FramePacket &FramePacketBuffer::BeginWrite()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this]() { return _stopped || _reading != _writing; });
+    return _packets[_writing];
+}
+
+void FramePacketBuffer::EndWrite()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ready = _writing;
+        _writing = (_writing + 1) % SLOT_COUNT;
+    }
+    _changed.notify_all();
+}
+
+const FramePacket *FramePacketBuffer::AcquireRead()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this]() { return _stopped || _ready >= 0; });
+    if (_stopped) {
+        return nullptr;
+    }
+
+    _reading = _ready;
+    _ready = -1;
+    return &_packets[_reading];
+}
+
+void FramePacketBuffer::ReleaseRead()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reading = -1;
+    }
+    _changed.notify_all();
+}
+
+void FramePacketBuffer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _changed.notify_all();
+}
+
+} // namespace VKB
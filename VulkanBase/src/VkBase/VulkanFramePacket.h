@@ -0,0 +1,106 @@
+﻿#ifndef VULKANFRAMEPACKET_H_
+#define VULKANFRAMEPACKET_H_
+
+#include <condition_variable>
+#include <mutex>
+
+#include "VulkanDynamicState.h"
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 一帧的模拟结果（模拟线程写，渲染线程只读）
+ */
+struct FramePacket
+{
+    // 模拟步序号
+    uint64_t tick = 0;
+
+    // 窗口帧缓冲大小（GLFW 只能在主线程查询）
+    int width = 0;
+    int height = 0;
+
+    // 相机
+    PTF_3D cameraPos = PTF_3D(0.0f);
+    MAT_4 viewProj = MAT_4(1.0f);
+
+    // 每帧 Uniform 数据
+    MvpMatrix mvp{};
+    AlphaColor color{};
+    LightInfo light{};
+
+    // 可见物体及其变换
+    std::vector<PushObject> objects;
+
+    // 逐物体绘制状态（与 objects 一一对应）
+    std::vector<DynamicDrawState> drawStates;
+};
+
+/**
+ * @brief FramePacketBuffer
+ *
+ * 模拟线程与渲染线程之间的双缓冲：
+ * - 模拟线程写一个槽位，渲染线程读另一个，互不阻塞
+ * - 写入的槽位正在被渲染时模拟线程等待（最多领先一帧）
+ * - 渲染线程总是取最新发布的数据包，未读的旧数据包被覆盖
+ */
+class FramePacketBuffer
+{
+public:
+    FramePacketBuffer();
+
+    ~FramePacketBuffer();
+
+public:
+    /**
+     * @brief 取得可写的数据包（该槽位正在渲染时等待）
+     */
+    FramePacket &BeginWrite();
+
+    /**
+     * @brief 发布 BeginWrite 取得的数据包
+     */
+    void EndWrite();
+
+    /**
+     * @brief 等待新发布的数据包
+     * @return 停止后返回 nullptr
+     */
+    const FramePacket *AcquireRead();
+
+    /**
+     * @brief 渲染完成，释放 AcquireRead 取得的数据包
+     */
+    void ReleaseRead();
+
+    /**
+     * @brief 停止：唤醒等待中的渲染线程
+     */
+    void Stop();
+
+private:
+    static constexpr int SLOT_COUNT = 2;
+
+    FramePacket _packets[SLOT_COUNT];
+
+    // 模拟线程正在写的槽位
+    int _writing = 0;
+
+    // 已发布未读取的槽位（-1 表示没有）
+    int _ready = -1;
+
+    // 渲染线程正在读的槽位（-1 表示没有）
+    int _reading = -1;
+
+    bool _stopped = false;
+
+    std::mutex _mutex;
+
+    std::condition_variable _changed;
+};
+
+} // namespace VKB
+
+#endif // !VULKANFRAMEPACKET_H_
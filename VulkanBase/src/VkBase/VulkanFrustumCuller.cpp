@@ -0,0 +1,400 @@
+﻿#include "VulkanFrustumCuller.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "PrintMsg.h"
+#include "VulkanSimd.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 一次测试的物体数
+#if defined(VKB_SIMD_AVX2)
+constexpr size_t SIMD_WIDTH = 8;
+#elif defined(VKB_SIMD_SSE2)
+constexpr size_t SIMD_WIDTH = 4;
+#else
+constexpr size_t SIMD_WIDTH = 1;
+#endif
+
+// 把一组测试结果的位掩码展开为下标
+inline void appendVisible(uint32_t bits, size_t base,
+                          std::vector<uint32_t> &visible)
+{
+    while (bits != 0) {
+        visible.push_back(static_cast<uint32_t>(base + std::countr_zero(bits)));
+        bits &= bits - 1;
+    }
+}
+} // namespace
+
+Frustum Frustum::FromViewProj(const MAT_4 &viewProj)
+{
+    auto row = [&](int i) {
+        return PTF_4D(viewProj[0][i], viewProj[1][i], viewProj[2][i],
+                      viewProj[3][i]);
+    };
+
+    const PTF_4D r0 = row(0);
+    const PTF_4D r1 = row(1);
+    const PTF_4D r2 = row(2);
+    const PTF_4D r3 = row(3);
+
+    Frustum frustum{};
+    PTF_4D *planes = frustum.planes;
+    planes[0] = r3 + r0; // 左
+    planes[1] = r3 - r0; // 右
+    planes[2] = r3 + r1; // 下
+    planes[3] = r3 - r1; // 上
+    planes[4] = r2;      // 近
+    planes[5] = r3 - r2; // 远
+
+    // 归一化后点到平面的值即为距离，可直接与半径比较
+    for (int i = 0; i < 6; ++i) {
+        const float length = glm::length(PTF_3D(planes[i]));
+        if (length > 0.0f) {
+            planes[i] /= length;
+        }
+    }
+
+    return frustum;
+}
+
+void VulkanFrustumCuller::Clear()
+{
+    _centerX.clear();
+    _centerY.clear();
+    _centerZ.clear();
+    _extentX.clear();
+    _extentY.clear();
+    _extentZ.clear();
+    _radius.clear();
+    _visible.clear();
+}
+
+void VulkanFrustumCuller::Reserve(size_t count)
+{
+    _centerX.reserve(count);
+    _centerY.reserve(count);
+    _centerZ.reserve(count);
+    _extentX.reserve(count);
+    _extentY.reserve(count);
+    _extentZ.reserve(count);
+    _radius.reserve(count);
+}
+
+uint32_t VulkanFrustumCuller::Add(const PTF_3D &center, const PTF_3D &extent,
+                                  float radius)
+{
+    const uint32_t index = static_cast<uint32_t>(_radius.size());
+
+    _centerX.push_back(center.x);
+    _centerY.push_back(center.y);
+    _centerZ.push_back(center.z);
+    _extentX.push_back(extent.x);
+    _extentY.push_back(extent.y);
+    _extentZ.push_back(extent.z);
+    _radius.push_back(radius);
+
+    return index;
+}
+
+uint32_t VulkanFrustumCuller::Add(const MAT_4 &model,
+                                  const PTF_3D &localCenter,
+                                  const PTF_3D &localExtent)
+{
+    const PTF_3D center = PTF_3D(model * PTF_4D(localCenter, 1.0f));
+
+    // 世界轴 i 上的半边长 = sum_j |M[j][i]| * e_j
+    const PTF_3D extent = glm::abs(PTF_3D(model[0])) * localExtent.x
+                          + glm::abs(PTF_3D(model[1])) * localExtent.y
+                          + glm::abs(PTF_3D(model[2])) * localExtent.z;
+
+    // 局部包围盒的外接球按最大缩放变换（旋转时比世界包围盒更紧）
+    const float scale = std::max({glm::length(PTF_3D(model[0])),
+                                  glm::length(PTF_3D(model[1])),
+                                  glm::length(PTF_3D(model[2]))});
+    const float radius = glm::length(localExtent) * scale;
+
+    return Add(center, extent, radius);
+}
+
+const std::vector<uint32_t> &
+VulkanFrustumCuller::Cull(const Frustum &frustum, uint32_t threadCount)
+{
+    _visible.clear();
+
+    const size_t count = GetCount();
+    if (0 == count) {
+        return _visible;
+    }
+
+    if (count < PARALLEL_CULL_THRESHOLD || nullptr == _jobSystem) {
+        threadCount = 1;
+    } else if (0 == threadCount) {
+        threadCount = _jobSystem->GetConcurrency();
+    }
+
+    if (1 == threadCount) {
+        _visible.reserve(count);
+        cullRange(frustum, 0, count, _visible);
+        return _visible;
+    }
+
+    // 段长取 SIMD 宽度的整数倍，只有最后一段有标量尾部
+    size_t chunk = (count + threadCount - 1) / threadCount;
+    chunk = (chunk + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+
+    _sliceVisible.resize(threadCount);
+
+    PSG::JobCounter counter;
+    _jobSystem->ParallelFor(
+        threadCount, threadCount,
+        [&](uint32_t first, uint32_t last) {
+            for (uint32_t t = first; t < last; ++t) {
+                const size_t begin = std::min(count, t * chunk);
+                const size_t end = std::min(count, begin + chunk);
+
+                std::vector<uint32_t> &visible = _sliceVisible[t];
+                visible.clear();
+                visible.reserve(end - begin);
+                cullRange(frustum, begin, end, visible);
+            }
+        },
+        counter);
+    _jobSystem->Wait(counter);
+
+    // 各段按顺序拼接，结果与单线程一致
+    size_t total = 0;
+    for (const auto &visible : _sliceVisible) {
+        total += visible.size();
+    }
+    _visible.reserve(total);
+    for (const auto &visible : _sliceVisible) {
+        _visible.insert(_visible.end(), visible.begin(), visible.end());
+    }
+
+    return _visible;
+}
+
+const char *VulkanFrustumCuller::GetSimdName()
+{
+#if defined(VKB_SIMD_AVX2)
+    return "AVX2";
+#elif defined(VKB_SIMD_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+void VulkanFrustumCuller::Benchmark(uint32_t objectCount,
+                                    PSG::JobSystem *jobSystem)
+{
+    constexpr int ITERATIONS = 20;
+
+    // 物体随机分布在 [-100, 100]^3 中，相机位于原点看向 +X
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+    VulkanFrustumCuller culler;
+    culler.Reserve(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        const PTF_3D center(position(rng), position(rng), position(rng));
+        const PTF_3D extent(size(rng), size(rng), size(rng));
+        culler.Add(center, extent, glm::length(extent));
+    }
+
+    const MAT_4 proj =
+        glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    const MAT_4 view = glm::lookAt(PTF_3D(0.0f), PTF_3D(1.0f, 0.0f, 0.0f),
+                                   PTF_3D(0.0f, 0.0f, 1.0f));
+    const Frustum frustum = Frustum::FromViewProj(proj * view);
+
+    // 返回平均耗时（毫秒），先预热一次
+    auto measure = [&](bool simd, PSG::JobSystem *scheduler) {
+        culler.SetSimd(simd);
+        culler.SetJobSystem(scheduler);
+        culler.Cull(frustum);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            culler.Cull(frustum);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::milli>(elapsed).count()
+               / ITERATIONS;
+    };
+
+    const double scalarTime = measure(false, nullptr);
+    const std::vector<uint32_t> reference = culler.GetVisible();
+
+    const double simdTime = measure(true, nullptr);
+    if (culler.GetVisible() != reference) {
+        PSG::PrintError("SIMD 剔除结果与标量路径不一致!");
+    }
+
+    auto formatMs = [](double ms) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(3) << ms << " ms";
+        return stream.str();
+    };
+
+    const std::string simdName = GetSimdName();
+    PSG::PrintMsg("视锥体剔除基准",
+                  std::to_string(objectCount) + " 个物体, 可见 "
+                      + std::to_string(reference.size()));
+    PSG::PrintMsg("  标量", formatMs(scalarTime));
+    PSG::PrintMsg("  " + simdName + " 单线程", formatMs(simdTime));
+
+    if (jobSystem != nullptr) {
+        const double parallelTime = measure(true, jobSystem);
+        if (culler.GetVisible() != reference) {
+            PSG::PrintError("并行剔除结果与标量路径不一致!");
+        }
+
+        PSG::PrintMsg("  " + simdName + " "
+                          + std::to_string(jobSystem->GetConcurrency())
+                          + " 线程",
+                      formatMs(parallelTime));
+    }
+}
+
+void VulkanFrustumCuller::cullRange(const Frustum &frustum, size_t begin,
+                                    size_t end,
+                                    std::vector<uint32_t> &visible) const
+{
+    if (_simd) {
+        cullSimd(frustum, begin, end, visible);
+    } else {
+        cullScalar(frustum, begin, end, visible);
+    }
+}
+
+void VulkanFrustumCuller::cullScalar(const Frustum &frustum, size_t begin,
+                                     size_t end,
+                                     std::vector<uint32_t> &visible) const
+{
+    for (size_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (const PTF_4D &plane : frustum.planes) {
+            const float distance = plane.x * _centerX[i]
+                                   + plane.y * _centerY[i]
+                                   + plane.z * _centerZ[i] + plane.w;
+
+            // 包围盒在法线方向上的投影半径
+            const float boxReach = std::abs(plane.x) * _extentX[i]
+                                   + std::abs(plane.y) * _extentY[i]
+                                   + std::abs(plane.z) * _extentZ[i];
+
+            // 包围球和包围盒都要与平面内侧相交，取较小的投影半径
+            if (distance + std::min(_radius[i], boxReach) < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+
+        if (inside) {
+            visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void VulkanFrustumCuller::cullSimd(const Frustum &frustum, size_t begin,
+                                   size_t end,
+                                   std::vector<uint32_t> &visible) const
+{
+    size_t i = begin;
+
+#if defined(VKB_SIMD_AVX2)
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= end; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(&_centerX[i]);
+        const __m256 cy = _mm256_loadu_ps(&_centerY[i]);
+        const __m256 cz = _mm256_loadu_ps(&_centerZ[i]);
+        const __m256 ex = _mm256_loadu_ps(&_extentX[i]);
+        const __m256 ey = _mm256_loadu_ps(&_extentY[i]);
+        const __m256 ez = _mm256_loadu_ps(&_extentZ[i]);
+        const __m256 radius = _mm256_loadu_ps(&_radius[i]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const PTF_4D &plane : frustum.planes) {
+            const __m256 nx = _mm256_set1_ps(plane.x);
+            const __m256 ny = _mm256_set1_ps(plane.y);
+            const __m256 nz = _mm256_set1_ps(plane.z);
+
+            // 运算顺序与标量路径一致，两者结果逐位相同
+            __m256 distance =
+                _mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, cz));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+
+            __m256 boxReach = _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)),
+                                            ex);
+            boxReach = _mm256_add_ps(
+                boxReach, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), ey));
+            boxReach = _mm256_add_ps(
+                boxReach, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), ez));
+
+            const __m256 reach = _mm256_min_ps(radius, boxReach);
+            inside = _mm256_and_ps(
+                inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero,
+                                      _CMP_GE_OQ));
+        }
+
+        appendVisible(static_cast<uint32_t>(_mm256_movemask_ps(inside)), i,
+                      visible);
+    }
+#elif defined(VKB_SIMD_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&_centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&_centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&_centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&_extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&_extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&_extentZ[i]);
+        const __m128 radius = _mm_loadu_ps(&_radius[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const PTF_4D &plane : frustum.planes) {
+            const __m128 nx = _mm_set1_ps(plane.x);
+            const __m128 ny = _mm_set1_ps(plane.y);
+            const __m128 nz = _mm_set1_ps(plane.z);
+
+            // 运算顺序与标量路径一致，两者结果逐位相同
+            __m128 distance =
+                _mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+            __m128 boxReach = _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex);
+            boxReach = _mm_add_ps(
+                boxReach, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey));
+            boxReach = _mm_add_ps(
+                boxReach, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+
+            const __m128 reach = _mm_min_ps(radius, boxReach);
+            inside = _mm_and_ps(
+                inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), zero));
+        }
+
+        appendVisible(static_cast<uint32_t>(_mm_movemask_ps(inside)), i,
+                      visible);
+    }
+#endif
+
+    // 不足一组的尾部
+    cullScalar(frustum, i, end, visible);
+}
+
+} // namespace VKB
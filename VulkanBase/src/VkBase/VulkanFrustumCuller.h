@@ -0,0 +1,155 @@
+﻿#ifndef VULKANFRUSTUMCULLER_H_
+#define VULKANFRUSTUMCULLER_H_
+
+#include "JobSystem.h"
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 视锥体的 6 个平面（左 / 右 / 下 / 上 / 近 / 远）
+ *
+ * 平面 xyz 为指向视锥体内部的单位法线，w 为距离，
+ * dot(n, p) + w 即点到平面的有符号距离
+ */
+struct Frustum
+{
+    PTF_4D planes[6];
+
+    /**
+     * @brief Gribb-Hartmann：从裁剪矩阵的行组合出 6 个平面（深度范围 [0, 1]）
+     * @param viewProj 投影矩阵 * 观察矩阵
+     */
+    static Frustum FromViewProj(const MAT_4 &viewProj);
+};
+
+/**
+ * @brief VulkanFrustumCuller
+ *
+ * CPU 视锥体剔除：
+ * - 世界空间包围盒（中心 + 半边长）与包围球按结构数组（SoA）存放
+ * - AVX2 一次测试 8 个、SSE2 一次测试 4 个，其余用标量路径
+ *   （编译期选择，见 CMake 选项 VKB_ENABLE_AVX2）
+ * - 包围球与包围盒都在 6 个平面内侧（或相交）时可见
+ * - 物体较多时按段在调度器上并行，输出按下标升序的紧凑可见列表
+ */
+class VulkanFrustumCuller
+{
+public:
+    VulkanFrustumCuller() = default;
+
+    ~VulkanFrustumCuller() = default;
+
+public:
+    /**
+     * @brief 清空全部包围体（容量保留）
+     */
+    void Clear();
+
+    void Reserve(size_t count);
+
+    /**
+     * @brief 添加一个物体的世界空间包围体
+     * @param center / extent 包围盒中心和半边长
+     * @param radius 包围球半径（球心与包围盒中心相同）
+     * @return 物体下标（可见列表中的值）
+     */
+    uint32_t Add(const PTF_3D &center, const PTF_3D &extent, float radius);
+
+    /**
+     * @brief 由局部包围盒和模型矩阵添加物体
+     *
+     * 包围盒按模型矩阵变换后重新求轴对齐包围盒，包围球取其外接球
+     */
+    uint32_t Add(const MAT_4 &model, const PTF_3D &localCenter,
+                 const PTF_3D &localExtent);
+
+    /**
+     * @brief 剔除
+     * @param threadCount 并行分段数，0 表示调度器的并发线程数
+     * @return 可见物体下标（升序），下次 Cull / Clear 前有效
+     */
+    const std::vector<uint32_t> &Cull(const Frustum &frustum,
+                                      uint32_t threadCount = 0);
+
+    /**
+     * @brief 设置并行剔除使用的调度器（为空时单线程剔除）
+     */
+    void SetJobSystem(PSG::JobSystem *jobSystem)
+    {
+        _jobSystem = jobSystem;
+    }
+
+    /**
+     * @brief 是否使用 SIMD 路径（关闭时强制标量，用于对比）
+     */
+    void SetSimd(bool enable)
+    {
+        _simd = enable;
+    }
+
+    size_t GetCount() const
+    {
+        return _radius.size();
+    }
+
+    const std::vector<uint32_t> &GetVisible() const
+    {
+        return _visible;
+    }
+
+    /**
+     * @brief 当前编译的 SIMD 路径名称（"AVX2" / "SSE2" / "Scalar"）
+     */
+    static const char *GetSimdName();
+
+    /**
+     * @brief 剔除微基准：随机分布 objectCount 个物体，
+     *        分别统计标量、SIMD 单线程、SIMD 多线程的平均耗时并输出
+     * @param jobSystem 多线程测试使用的调度器（为空时跳过）
+     */
+    static void Benchmark(uint32_t objectCount = 1000000,
+                          PSG::JobSystem *jobSystem = nullptr);
+
+private:
+    // 物体数量低于此值时单线程剔除
+    static constexpr size_t PARALLEL_CULL_THRESHOLD = 16384;
+
+    // 把 [begin, end) 中可见物体的下标追加到 visible
+    void cullRange(const Frustum &frustum, size_t begin, size_t end,
+                   std::vector<uint32_t> &visible) const;
+
+    void cullScalar(const Frustum &frustum, size_t begin, size_t end,
+                    std::vector<uint32_t> &visible) const;
+
+    void cullSimd(const Frustum &frustum, size_t begin, size_t end,
+                  std::vector<uint32_t> &visible) const;
+
+private:
+    // 包围盒中心
+    std::vector<float> _centerX;
+    std::vector<float> _centerY;
+    std::vector<float> _centerZ;
+
+    // 包围盒半边长
+    std::vector<float> _extentX;
+    std::vector<float> _extentY;
+    std::vector<float> _extentZ;
+
+    // 包围球半径
+    std::vector<float> _radius;
+
+    std::vector<uint32_t> _visible;
+
+    // 并行时每段的可见列表，合并后按段顺序拼接
+    std::vector<std::vector<uint32_t>> _sliceVisible;
+
+    bool _simd = true;
+
+    PSG::JobSystem *_jobSystem = nullptr;
+};
+
+} // namespace VKB
+
+#endif // !VULKANFRUSTUMCULLER_H_
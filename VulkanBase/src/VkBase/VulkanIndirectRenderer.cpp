@@ -0,0 +1,508 @@
+﻿#include "VulkanIndirectRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "PrintMsg.h"
+#include "VulkanFrustumCuller.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 剔除计算着色器
+const char *GPU_CULL_SHADER = "Res\\Shaders\\GpuCull.spv";
+
+void memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags srcStage,
+                   VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                   VkAccessFlags dstAccess)
+{
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 1, &barrier, 0, nullptr,
+                         0, nullptr);
+}
+} // namespace
+
+VulkanIndirectRenderer::VulkanIndirectRenderer()
+{
+}
+
+VulkanIndirectRenderer::~VulkanIndirectRenderer()
+{
+    Destroy();
+}
+
+bool VulkanIndirectRenderer::Init(VkPhysicalDevice physicalDevice,
+                                  VkDevice device, VkCommandPool commandPool,
+                                  VkQueue queue,
+                                  const DeviceFeatureSupport &features,
+                                  const std::vector<GpuObject> &objects,
+                                  const VulkanDepthPyramid *depthPyramid,
+                                  uint32_t framesInFlight,
+                                  PFN_vkCmdPushDescriptorSetWithTemplateKHR
+                                      pushDescriptorSet)
+{
+    // 顶点着色器通过 gl_InstanceIndex（= firstInstance）读取物体数据
+    if (!features.drawIndirectFirstInstance) {
+        PSG::PrintError("GPU 驱动渲染需要 drawIndirectFirstInstance 特性!");
+        return false;
+    }
+
+    if (objects.empty()) {
+        PSG::PrintError("创建间接绘制失败：物体列表为空!");
+        return false;
+    }
+
+    _device = device;
+    _useDrawCount = features.drawIndirectCount;
+    _multiDrawIndirect = features.multiDrawIndirect;
+    _objectCount = static_cast<uint32_t>(objects.size());
+    _pushDescriptorSet = features.pushDescriptor ? pushDescriptorSet : nullptr;
+    _depthPyramid = depthPyramid;
+    _pyramidReady = false;
+
+    _cullData.objectCount = _objectCount;
+    _cullData.compact = _useDrawCount ? 1 : 0;
+
+    if (!uploadObjects(physicalDevice, commandPool, queue, objects)) {
+        return false;
+    }
+
+    // 间接命令：计算着色器写入，间接绘制读取（每个阶段一段）
+    const VkDeviceSize commandSize =
+        sizeof(VkDrawIndexedIndirectCommand) * _objectCount * CULL_PHASES;
+    if (!_drawCommands.Init(physicalDevice, device, commandSize,
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建间接命令缓冲失败!");
+        return false;
+    }
+
+    // 每个阶段的可见数量：每帧先清零
+    if (!_drawCount.Init(physicalDevice, device,
+                         sizeof(uint32_t) * CULL_PHASES,
+                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                             | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                             | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建间接绘制数量缓冲失败!");
+        return false;
+    }
+
+    if (!createFrameBuffers(physicalDevice, framesInFlight)) {
+        return false;
+    }
+
+    if (!_placeholderPyramid.InitPlaceholder(physicalDevice, device,
+                                             commandPool, queue)) {
+        PSG::PrintError("创建 Hi-Z 占位图像失败!");
+        return false;
+    }
+
+    return createCullPipeline();
+}
+
+void VulkanIndirectRenderer::Destroy()
+{
+    if (_cullPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_device, _cullPipeline, nullptr);
+        _cullPipeline = VK_NULL_HANDLE;
+    }
+
+    _cullShader.Destroy();
+    _cullLayout.Destroy();
+
+    // DescriptorSet 随池一起释放，推送模板随布局一起销毁
+    SDelete(_cullPool);
+    SDelete(_cullSetLayout);
+    _cullSet = VK_NULL_HANDLE;
+    _cullPushTemplate = VK_NULL_HANDLE;
+    _pushDescriptorSet = nullptr;
+
+    // 回读缓冲随内存释放一起解除映射
+    _mappedStats = nullptr;
+    _statsSlots = 0;
+    _statsReadback.Destroy();
+    _stats.Destroy();
+    _visibility.Destroy();
+    _cullUniform.Destroy();
+    _depthPyramid = nullptr;
+    _pyramidReady = false;
+    _occlusionCulling = false;
+    _placeholderPyramid.Destroy();
+
+    _drawCount.Destroy();
+    _drawCommands.Destroy();
+    _objectBuffer.Destroy();
+
+    _objectCount = 0;
+}
+
+void VulkanIndirectRenderer::SetDepthPyramid(
+    const VulkanDepthPyramid *depthPyramid)
+{
+    _depthPyramid = depthPyramid;
+    _pyramidReady = false;
+    if (!_depthPyramid) {
+        _occlusionCulling = false;
+    }
+
+    setPyramidInfo();
+
+    // 推送描述符每次录制时读取 _cullInfos，描述符集需要重写
+    if (_cullSet != VK_NULL_HANDLE) {
+        VkDescriptorUpdateTemplate updateTemplate =
+            _cullSetLayout->GetUpdateTemplate(1u << CULL_PYRAMID);
+        if (updateTemplate != VK_NULL_HANDLE) {
+            vkUpdateDescriptorSetWithTemplate(_device, _cullSet,
+                                              updateTemplate,
+                                              _cullInfos.data());
+        }
+    }
+}
+
+void VulkanIndirectRenderer::SetOcclusionCulling(bool enable)
+{
+    _occlusionCulling = enable && _depthPyramid && _depthPyramid->HasSource();
+    _pyramidReady = false;
+}
+
+void VulkanIndirectRenderer::SetFrustum(const MAT_4 &viewProj)
+{
+    // 与 CPU 剔除使用相同的平面（归一化，可直接与包围球半径比较）
+    const Frustum frustum = Frustum::FromViewProj(viewProj);
+    std::copy(std::begin(frustum.planes), std::end(frustum.planes),
+              _cullData.planes);
+
+    // 上一帧的金字塔按生成它时的 viewProj 投影
+    _cullData.prevViewProj = _cullData.viewProj;
+    _cullData.viewProj = viewProj;
+
+    _cullData.occlusion = _occlusionCulling && _pyramidReady ? 1 : 0;
+    if (_depthPyramid) {
+        _cullData.depthWidth = _depthPyramid->GetDepthExtent().width;
+        _cullData.depthHeight = _depthPyramid->GetDepthExtent().height;
+        _cullData.pyramidLevels = _depthPyramid->GetLevelCount();
+    }
+
+    // 本帧录制会在两个阶段之间生成金字塔，下一帧即可使用
+    _pyramidReady = _occlusionCulling;
+}
+
+void VulkanIndirectRenderer::RecordCulling(VkCommandBuffer cmd,
+                                           uint32_t phase) const
+{
+    if (0 == phase) {
+        // 上一帧的剔除和间接绘制读取完成后才能覆盖参数、命令和计数
+        memoryBarrier(cmd,
+                      VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                          | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                          | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      0,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT
+                          | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      0);
+
+        // 本帧参数随命令缓冲上传，并行帧之间互不覆盖
+        vkCmdUpdateBuffer(cmd, _cullUniform.Get(), 0, sizeof(CullData),
+                          &_cullData);
+        vkCmdFillBuffer(cmd, _drawCount.Get(), 0, VK_WHOLE_SIZE, 0);
+        vkCmdFillBuffer(cmd, _stats.Get(), 0, VK_WHOLE_SIZE, 0);
+
+        memoryBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+                          | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipeline);
+    if (_cullPushTemplate != VK_NULL_HANDLE) {
+        _pushDescriptorSet(cmd, _cullPushTemplate, _cullLayout.Get(), 0,
+                           _cullInfos.data());
+    } else {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                _cullLayout.Get(), 0, 1, &_cullSet, 0,
+                                nullptr);
+    }
+    vkCmdPushConstants(cmd, _cullLayout.Get(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(uint32_t), &phase);
+
+    const uint32_t groupCount =
+        (_objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+    vkCmdDispatch(cmd, groupCount, 1, 1);
+
+    // 剔除结果作为间接绘制参数；阶段 0 的结果（可见性）供阶段 1 读取
+    memoryBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                  VK_ACCESS_SHADER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                      | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                  VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+                      | VK_ACCESS_SHADER_READ_BIT
+                      | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void VulkanIndirectRenderer::RecordDraw(VkCommandBuffer cmd,
+                                        uint32_t phase) const
+{
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    const VkDeviceSize first =
+        static_cast<VkDeviceSize>(phase) * _objectCount * stride;
+
+    if (_useDrawCount) {
+        // 可见数量由 GPU 决定
+        vkCmdDrawIndexedIndirectCount(cmd, _drawCommands.Get(), first,
+                                      _drawCount.Get(),
+                                      phase * sizeof(uint32_t), _objectCount,
+                                      stride);
+    } else if (_multiDrawIndirect) {
+        vkCmdDrawIndexedIndirect(cmd, _drawCommands.Get(), first,
+                                 _objectCount, stride);
+    } else {
+        // 不支持多重间接绘制时只能逐条提交
+        for (uint32_t i = 0; i < _objectCount; ++i) {
+            vkCmdDrawIndexedIndirect(
+                cmd, _drawCommands.Get(),
+                first + static_cast<VkDeviceSize>(i) * stride, 1, stride);
+        }
+    }
+}
+
+void VulkanIndirectRenderer::RecordStats(VkCommandBuffer cmd,
+                                         uint32_t frame) const
+{
+    if (frame >= _statsSlots) {
+        return;
+    }
+
+    memoryBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                  VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_ACCESS_TRANSFER_READ_BIT);
+
+    VkBufferCopy region{};
+    region.dstOffset = sizeof(GpuCullStats) * frame;
+    region.size = sizeof(GpuCullStats);
+    vkCmdCopyBuffer(cmd, _stats.Get(), _statsReadback.Get(), 1, &region);
+
+    // 栅栏等待后主机可见
+    memoryBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                  VK_ACCESS_HOST_READ_BIT);
+}
+
+GpuCullStats VulkanIndirectRenderer::GetStats(uint32_t frame) const
+{
+    if (!_mappedStats || frame >= _statsSlots) {
+        return GpuCullStats{};
+    }
+    return _mappedStats[frame];
+}
+
+bool VulkanIndirectRenderer::uploadObjects(
+    VkPhysicalDevice physicalDevice, VkCommandPool commandPool, VkQueue queue,
+    const std::vector<GpuObject> &objects)
+{
+    const VkDeviceSize size = sizeof(GpuObject) * objects.size();
+
+    VulkanBuffer staging;
+    if (!staging.Init(physicalDevice, _device, size,
+                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        PSG::PrintError("创建物体数据暂存缓冲失败!");
+        return false;
+    }
+
+    void *data = staging.Map();
+    memcpy(data, objects.data(), static_cast<size_t>(size));
+    staging.Unmap();
+
+    if (!_objectBuffer.Init(physicalDevice, _device, size,
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建物体数据缓冲失败!");
+        return false;
+    }
+
+    _objectBuffer.CopyFrom(staging, commandPool, queue);
+
+    staging.Destroy();
+    return true;
+}
+
+bool VulkanIndirectRenderer::createFrameBuffers(
+    VkPhysicalDevice physicalDevice, uint32_t framesInFlight)
+{
+    // 剔除参数：每帧由 vkCmdUpdateBuffer 写入
+    if (!_cullUniform.Init(physicalDevice, _device, sizeof(CullData),
+                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+                               | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建剔除参数缓冲失败!");
+        return false;
+    }
+
+    // 阶段 0 的结果，只在一帧内使用
+    if (!_visibility.Init(physicalDevice, _device,
+                          sizeof(uint32_t) * _objectCount,
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建剔除可见性缓冲失败!");
+        return false;
+    }
+
+    if (!_stats.Init(physicalDevice, _device, sizeof(GpuCullStats),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                         | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+                         | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        PSG::PrintError("创建剔除统计缓冲失败!");
+        return false;
+    }
+
+    _statsSlots = std::max(framesInFlight, 1u);
+    if (!_statsReadback.Init(physicalDevice, _device,
+                             sizeof(GpuCullStats) * _statsSlots,
+                             VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                 | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        PSG::PrintError("创建剔除统计回读缓冲失败!");
+        return false;
+    }
+
+    void *data = _statsReadback.Map();
+    memset(data, 0, sizeof(GpuCullStats) * _statsSlots);
+    _mappedStats = static_cast<const GpuCullStats *>(data);
+    return true;
+}
+
+bool VulkanIndirectRenderer::createCullPipeline()
+{
+    // 见 CullBinding：物体、间接命令、可见数量、阶段 0 结果、统计、
+    // Hi-Z 金字塔、剔除参数
+    _cullSetLayout = new VulkanDescriptorSetLayout();
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (uint32_t binding = 0; binding < CULL_PYRAMID; ++binding) {
+        bindings.push_back(
+            _cullSetLayout->Make(binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                 VK_SHADER_STAGE_COMPUTE_BIT));
+    }
+    bindings.push_back(_cullSetLayout->Make(
+        CULL_PYRAMID, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_SHADER_STAGE_COMPUTE_BIT));
+    bindings.push_back(
+        _cullSetLayout->Make(CULL_DATA, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                             VK_SHADER_STAGE_COMPUTE_BIT));
+    const bool pushDescriptor = _pushDescriptorSet != nullptr;
+    if (!_cullSetLayout->Init(_device, bindings, pushDescriptor)) {
+        return false;
+    }
+
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(uint32_t);
+    if (!_cullLayout.Init(_device, {_cullSetLayout->Get()}, {pushRange})) {
+        return false;
+    }
+
+    const VulkanBuffer *buffers[] = {&_objectBuffer, &_drawCommands,
+                                     &_drawCount,   &_visibility,
+                                     &_stats,       nullptr,
+                                     &_cullUniform};
+    for (uint32_t binding = 0; binding < CULL_BINDING_COUNT; ++binding) {
+        if (CULL_PYRAMID == binding) {
+            continue;
+        }
+        _cullInfos[binding].buffer.buffer = buffers[binding]->Get();
+        _cullInfos[binding].buffer.offset = 0;
+        _cullInfos[binding].buffer.range = buffers[binding]->GetSize();
+    }
+
+    setPyramidInfo();
+
+    // 推送描述符：每次剔除时随命令录制，不需要描述符池
+    if (pushDescriptor) {
+        _cullPushTemplate = _cullSetLayout->GetPushTemplate(
+            VK_PIPELINE_BIND_POINT_COMPUTE, _cullLayout.Get(), 0);
+        if (_cullPushTemplate == VK_NULL_HANDLE) {
+            return false;
+        }
+    } else if (!createCullSet()) {
+        return false;
+    }
+
+    if (!_cullShader.Init(_device, GPU_CULL_SHADER,
+                          VK_SHADER_STAGE_COMPUTE_BIT)) {
+        return false;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = _cullShader.GetStageInfo();
+    pipelineInfo.layout = _cullLayout.Get();
+
+    if (vkCreateComputePipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                                 nullptr, &_cullPipeline)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建剔除计算管线失败!");
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanIndirectRenderer::setPyramidInfo()
+{
+    const VulkanDepthPyramid &pyramid =
+        _depthPyramid ? *_depthPyramid : _placeholderPyramid;
+
+    DescriptorInfo &info = _cullInfos[CULL_PYRAMID];
+    info.image.sampler = pyramid.GetSampler();
+    info.image.imageView = pyramid.GetImageView();
+    info.image.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+}
+
+bool VulkanIndirectRenderer::createCullSet()
+{
+    std::vector<VkDescriptorPoolSize> poolSizes(3);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = CULL_PYRAMID;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = 1;
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[2].descriptorCount = 1;
+
+    _cullPool = new VulkanDescriptorPool();
+    if (!_cullPool->Init(_device, 1, poolSizes)) {
+        return false;
+    }
+
+    std::vector<VkDescriptorSet> sets;
+    if (!_cullPool->AllocateDescriptorSets({_cullSetLayout->Get()}, sets)) {
+        return false;
+    }
+    _cullSet = sets[0];
+
+    // 与推送描述符使用同一份模板数据，一次写入
+    const uint32_t bindingMask = (1u << _cullInfos.size()) - 1;
+    VkDescriptorUpdateTemplate updateTemplate =
+        _cullSetLayout->GetUpdateTemplate(bindingMask);
+    if (updateTemplate == VK_NULL_HANDLE) {
+        return false;
+    }
+    vkUpdateDescriptorSetWithTemplate(_device, _cullSet, updateTemplate,
+                                      _cullInfos.data());
+
+    return true;
+}
+
+} // namespace VKB
@@ -0,0 +1,279 @@
+﻿#ifndef VULKANINDIRECTRENDERER_H_
+#define VULKANINDIRECTRENDERER_H_
+
+#include <array>
+
+#include "VulkanBuffer.h"
+#include "VulkanDepthPyramid.h"
+#include "VulkanDescriptorPool.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanPipelineLayout.h"
+#include "VulkanShaderModule.h"
+
+namespace VKB
+{
+
+/**
+ * @brief GPU 驱动渲染的逐物体数据（std430，与 GpuCull.comp / Uber.vert 一致）
+ */
+struct GpuObject
+{
+    alignas(16) MAT_4 model;
+    alignas(16) PTF_4D color;
+
+    // 世界空间包围球：xyz 球心，w 半径
+    alignas(16) PTF_4D sphere;
+
+    // 网格在顶点 / 索引缓冲中的位置
+    uint32_t indexCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    uint32_t reserved = 0;
+};
+
+/**
+ * @brief 一帧的 GPU 剔除统计（与 GpuCull.comp 的 StatsBuffer 一致）
+ */
+struct GpuCullStats
+{
+    uint32_t frustumCulled = 0;
+
+    // 两个阶段都未通过遮挡测试
+    uint32_t occlusionCulled = 0;
+
+    // 阶段 0 绘制（上一帧金字塔中可见）
+    uint32_t earlyDrawn = 0;
+
+    // 阶段 1 补画（解除遮挡）
+    uint32_t lateDrawn = 0;
+
+    bool operator==(const GpuCullStats &other) const = default;
+};
+
+/**
+ * @brief VulkanIndirectRenderer
+ *
+ * GPU 驱动的间接绘制：
+ * - 物体数据一次性上传到存储缓冲（静态场景）
+ * - 计算着色器做视锥体剔除，写 VkDrawIndexedIndirectCommand + 数量
+ * - 支持 DrawIndirectCount 时压缩输出，一次调用绘制全部可见物体；
+ *   否则按物体下标输出（不可见的实例数为 0），用多重间接绘制代替
+ * - 每帧 CPU 只录制固定数量的命令，与物体数量无关
+ * - 支持推送描述符时剔除的描述符直接录制进命令缓冲，不分配描述符池
+ * - 启用遮挡剔除时分两个阶段（见 GpuCull.comp）：
+ *   阶段 0 用上一帧的 Hi-Z 金字塔测试并绘制，阶段 1 用本帧阶段 0 的深度
+ *   重新生成金字塔，补画解除遮挡的物体；两个阶段各有一段间接命令
+ * - 剔除统计每帧复制到按帧序号划分的回读缓冲，该帧栅栏等待后读取
+ */
+class VulkanIndirectRenderer
+{
+public:
+    VulkanIndirectRenderer();
+
+    ~VulkanIndirectRenderer();
+
+public:
+    /**
+     * @brief 上传物体数据并创建剔除管线
+     * @param commandPool / queue 上传物体数据使用
+     * @param features 设备已启用的特性（需要 drawIndirectFirstInstance）
+     * @param depthPyramid 遮挡测试采样的 Hi-Z 金字塔（为空时只做视锥体剔除）
+     * @param framesInFlight 剔除统计的回读槽位数
+     * @param pushDescriptorSet 推送描述符函数（为空时使用描述符池）
+     */
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
+              VkCommandPool commandPool, VkQueue queue,
+              const DeviceFeatureSupport &features,
+              const std::vector<GpuObject> &objects,
+              const VulkanDepthPyramid *depthPyramid, uint32_t framesInFlight,
+              PFN_vkCmdPushDescriptorSetWithTemplateKHR pushDescriptorSet =
+                  nullptr);
+
+    void Destroy();
+
+    /**
+     * @brief 更换金字塔（交换链重建后，GPU 空闲时调用）
+     *
+     * 新金字塔尚未生成，下一帧阶段 0 不做遮挡测试；
+     * 为空时关闭遮挡剔除，描述符改为指向占位图像
+     */
+    void SetDepthPyramid(const VulkanDepthPyramid *depthPyramid);
+
+    /**
+     * @brief 是否两阶段遮挡剔除（调用方每帧负责在两个阶段之间生成金字塔）
+     */
+    void SetOcclusionCulling(bool enable);
+
+    bool IsOcclusionCulling() const
+    {
+        return _occlusionCulling;
+    }
+
+    /**
+     * @brief 设置本帧视锥体（每帧调用一次）
+     * @param viewProj 投影矩阵 * 观察矩阵
+     */
+    void SetFrustum(const MAT_4 &viewProj);
+
+    /**
+     * @brief 录制一个阶段的剔除（必须在 RenderPass / 动态渲染之外）
+     *
+     * 阶段 0 同时清零计数并上传本帧剔除参数
+     */
+    void RecordCulling(VkCommandBuffer cmd, uint32_t phase = 0) const;
+
+    /**
+     * @brief 录制一个阶段的间接绘制
+     *
+     * 调用方已绑定图形管线、DescriptorSet、顶点 / 索引缓冲
+     */
+    void RecordDraw(VkCommandBuffer cmd, uint32_t phase = 0) const;
+
+    /**
+     * @brief 全部阶段绘制后，把本帧统计复制到 frame 的回读槽位
+     */
+    void RecordStats(VkCommandBuffer cmd, uint32_t frame) const;
+
+    /**
+     * @brief frame 槽位上一次提交的统计（该帧栅栏等待后读取）
+     */
+    GpuCullStats GetStats(uint32_t frame) const;
+
+    /// 物体存储缓冲（绑定到顶点着色器的 binding = 4）
+    VkBuffer GetObjectBuffer() const
+    {
+        return _objectBuffer.Get();
+    }
+
+    VkDeviceSize GetObjectBufferSize() const
+    {
+        return _objectBuffer.GetSize();
+    }
+
+    uint32_t GetObjectCount() const
+    {
+        return _objectCount;
+    }
+
+    /// 是否使用 vkCmdDrawIndexedIndirectCount
+    bool IsUsingDrawCount() const
+    {
+        return _useDrawCount;
+    }
+
+private:
+    // 与 GpuCull.comp 的 CullData 一致（std140）
+    struct CullData
+    {
+        PTF_4D planes[6];
+        MAT_4 viewProj = MAT_4(1.0f);
+        MAT_4 prevViewProj = MAT_4(1.0f);
+        uint32_t depthWidth = 0;
+        uint32_t depthHeight = 0;
+        uint32_t objectCount = 0;
+        uint32_t compact = 0;
+        uint32_t occlusion = 0;
+        uint32_t pyramidLevels = 0;
+        uint32_t reserved[2] = {};
+    };
+
+    // 剔除描述符的 binding 号（与 GpuCull.comp 一致）
+    enum CullBinding : uint32_t
+    {
+        CULL_OBJECTS = 0,
+        CULL_COMMANDS,
+        CULL_COUNT,
+        CULL_VISIBILITY,
+        CULL_STATS,
+        CULL_PYRAMID,
+        CULL_DATA,
+        CULL_BINDING_COUNT
+    };
+
+    // 间接命令分两段，阶段 i 使用第 i 段
+    static constexpr uint32_t CULL_PHASES = 2;
+
+    // 与 GpuCull.comp 的 local_size_x 一致
+    static constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+    bool uploadObjects(VkPhysicalDevice physicalDevice,
+                       VkCommandPool commandPool, VkQueue queue,
+                       const std::vector<GpuObject> &objects);
+
+    bool createCullPipeline();
+
+    // 每帧剔除使用的缓冲：参数、阶段 0 结果、统计及其回读
+    bool createFrameBuffers(VkPhysicalDevice physicalDevice,
+                            uint32_t framesInFlight);
+
+    // binding 5 指向当前金字塔（没有时为占位图像）
+    void setPyramidInfo();
+
+    // 不支持推送描述符时分配并写入剔除的 DescriptorSet
+    bool createCullSet();
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    bool _useDrawCount = false;
+
+    bool _multiDrawIndirect = false;
+
+    uint32_t _objectCount = 0;
+
+    CullData _cullData;
+
+    const VulkanDepthPyramid *_depthPyramid = nullptr;
+
+    // 没有金字塔时剔除描述符的 binding 5 指向它
+    VulkanDepthPyramid _placeholderPyramid;
+
+    bool _occlusionCulling = false;
+
+    // 金字塔已在之前的帧中生成，阶段 0 可以做遮挡测试
+    bool _pyramidReady = false;
+
+    VulkanBuffer _objectBuffer;
+
+    VulkanBuffer _drawCommands;
+
+    VulkanBuffer _drawCount;
+
+    VulkanBuffer _cullUniform;
+
+    VulkanBuffer _visibility;
+
+    VulkanBuffer _stats;
+
+    // 每帧一个 GpuCullStats 槽位（HOST_VISIBLE）
+    VulkanBuffer _statsReadback;
+
+    // 回读缓冲持久映射
+    const GpuCullStats *_mappedStats = nullptr;
+
+    uint32_t _statsSlots = 0;
+
+    VulkanDescriptorSetLayout *_cullSetLayout = nullptr;
+
+    VulkanDescriptorPool *_cullPool = nullptr;
+
+    VkDescriptorSet _cullSet = VK_NULL_HANDLE;
+
+    // 推送描述符：函数、模板以及按 binding 号排列的模板数据
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR _pushDescriptorSet = nullptr;
+
+    VkDescriptorUpdateTemplate _cullPushTemplate = VK_NULL_HANDLE;
+
+    std::array<DescriptorInfo, CULL_BINDING_COUNT> _cullInfos{};
+
+    VulkanPipelineLayout _cullLayout;
+
+    VulkanShaderModule _cullShader;
+
+    VkPipeline _cullPipeline = VK_NULL_HANDLE;
+};
+
+} // namespace VKB
+
+#endif // !VULKANINDIRECTRENDERER_H_
@@ -0,0 +1,70 @@
+﻿#include "VulkanInstanceBuffer.h"
+#include "PrintMsg.h"
+
+#include <algorithm>
+
+namespace VKB
+{
+
+VulkanInstanceBuffer::~VulkanInstanceBuffer()
+{
+    Destroy();
+}
+
+bool VulkanInstanceBuffer::Init(VkPhysicalDevice physicalDevice,
+                                VkDevice device, uint32_t capacity)
+{
+    _physicalDevice = physicalDevice;
+    _device = device;
+    return createBuffer(std::max(1u, capacity));
+}
+
+bool VulkanInstanceBuffer::Update(const std::vector<InstanceData> &instances)
+{
+    if (instances.empty()) {
+        return true;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(instances.size());
+    if (count > _capacity) {
+        uint32_t capacity = std::max(1u, _capacity);
+        while (capacity < count) {
+            capacity *= 2;
+        }
+
+        _buffer.Destroy();
+        if (!createBuffer(capacity)) {
+            PSG::PrintError("实例缓冲扩容失败!");
+            return false;
+        }
+    }
+
+    void *mapped = _buffer.Map();
+    memcpy(mapped, instances.data(), sizeof(InstanceData) * instances.size());
+    _buffer.Unmap();
+
+    return true;
+}
+
+void VulkanInstanceBuffer::Destroy()
+{
+    _buffer.Destroy();
+    _capacity = 0;
+}
+
+bool VulkanInstanceBuffer::createBuffer(uint32_t capacity)
+{
+    if (!_buffer.Init(_physicalDevice, _device,
+                      sizeof(InstanceData) * capacity,
+                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        _capacity = 0;
+        return false;
+    }
+
+    _capacity = capacity;
+    return true;
+}
+
+} // namespace VKB
@@ -0,0 +1,60 @@
+﻿#ifndef VULKANINSTANCEBUFFER_H_
+#define VULKANINSTANCEBUFFER_H_
+
+#include "VulkanBuffer.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanInstanceBuffer
+ *
+ * 逐实例顶点流（InstanceData，绑定 1），主机可见，每帧整体重写
+ * - 每个在途帧一个，写入前该帧的栅栏必须已等待
+ * - 容量不足时按 2 倍扩容
+ */
+class VulkanInstanceBuffer
+{
+public:
+    VulkanInstanceBuffer() = default;
+
+    ~VulkanInstanceBuffer();
+
+    /**
+     * @brief 初始化
+     * @param capacity 初始容量（实例个数）
+     */
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
+              uint32_t capacity);
+
+    // 写入实例数据（必要时扩容，扩容后 Get 返回新缓冲）
+    bool Update(const std::vector<InstanceData> &instances);
+
+    void Destroy();
+
+    VkBuffer Get() const
+    {
+        return _buffer.Get();
+    }
+
+    uint32_t GetCapacity() const
+    {
+        return _capacity;
+    }
+
+private:
+    bool createBuffer(uint32_t capacity);
+
+private:
+    VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
+
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VulkanBuffer _buffer;
+
+    uint32_t _capacity = 0;
+};
+
+} // namespace VKB
+
+#endif // !VULKANINSTANCEBUFFER_H_
@@ -0,0 +1,544 @@
+﻿#include "VulkanMeshLod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 烘焙文件头，格式变化时递增版本号，旧文件直接重新生成
+const char MESH_MAGIC[4] = {'V', 'K', 'B', 'M'};
+constexpr uint32_t MESH_VERSION = 1;
+
+struct MeshFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t lodCount;
+    uint32_t reserved;
+};
+
+// 下一级的三角形数减少不足该比例时停止生成
+constexpr float MIN_LOD_REDUCTION = 0.1f;
+
+// 三角形少于此数时不再简化
+constexpr size_t MIN_LOD_TRIANGLES = 8;
+
+/**
+ * @brief 二次误差矩阵（对称 4x4，只存上三角）
+ *
+ * 按面积加权累加平面，Evaluate / weight 为到各平面的平均距离平方
+ */
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+
+    // 平面 n·p + d = 0（n 为单位法线）
+    void AddPlane(const PTF_3D &n, double d, double w)
+    {
+        a00 += w * n.x * n.x;
+        a01 += w * n.x * n.y;
+        a02 += w * n.x * n.z;
+        a03 += w * n.x * d;
+        a11 += w * n.y * n.y;
+        a12 += w * n.y * n.z;
+        a13 += w * n.y * d;
+        a22 += w * n.z * n.z;
+        a23 += w * n.z * d;
+        a33 += w * d * d;
+        weight += w;
+    }
+
+    Quadric &operator+=(const Quadric &other)
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a03 += other.a03;
+        a11 += other.a11;
+        a12 += other.a12;
+        a13 += other.a13;
+        a22 += other.a22;
+        a23 += other.a23;
+        a33 += other.a33;
+        weight += other.weight;
+        return *this;
+    }
+
+    double Evaluate(const PTF_3D &p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        return a00 * x * x + a11 * y * y + a22 * z * z
+               + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+               + 2.0 * (a03 * x + a13 * y + a23 * z) + a33;
+    }
+};
+
+/**
+ * @brief 半边折叠简化器
+ *
+ * 每趟按代价排序全部候选边，贪心折叠互不相邻的边，
+ * 折叠后重写索引并删除退化三角形，直到达到目标三角形数
+ */
+class MeshSimplifier
+{
+public:
+    MeshSimplifier(const std::vector<VerCorTexNor> &vertices,
+                   const std::vector<uint32_t> &indices);
+
+    /**
+     * @brief 继续简化到不多于 targetTriangles 个三角形
+     *        （没有可折叠的边时提前结束）
+     * @return 累计的最大几何误差
+     */
+    float Simplify(size_t targetTriangles, std::vector<uint32_t> &outIndices);
+
+private:
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    void buildAdjacency();
+
+    // 折叠代价（平均距离平方）
+    double collapseCost(uint32_t from, uint32_t to) const;
+
+    // 检查翻转和拓扑，返回折叠会删除的三角形数（0 表示不允许）
+    uint32_t checkCollapse(uint32_t from, uint32_t to,
+                           std::vector<uint32_t> &fromRing,
+                           std::vector<uint32_t> &toRing) const;
+
+    // 顶点的一环邻居（排序去重）
+    void gatherRing(uint32_t vertex, std::vector<uint32_t> &ring) const;
+
+    const PTF_3D &position(uint32_t vertex) const
+    {
+        return _vertices[vertex].pos;
+    }
+
+private:
+    const std::vector<VerCorTexNor> &_vertices;
+
+    std::vector<uint32_t> _indices;
+
+    std::vector<Quadric> _quadrics;
+
+    // 边界顶点不参与折叠（只能作为折叠目标）
+    std::vector<uint8_t> _locked;
+
+    // 顶点 -> 三角形（CSR）
+    std::vector<uint32_t> _triangleOffsets;
+    std::vector<uint32_t> _vertexTriangles;
+
+    double _maxCost = 0.0;
+};
+
+MeshSimplifier::MeshSimplifier(const std::vector<VerCorTexNor> &vertices,
+                               const std::vector<uint32_t> &indices)
+    : _vertices(vertices), _indices(indices)
+{
+    const size_t vertexCount = vertices.size();
+    _quadrics.resize(vertexCount);
+    _locked.assign(vertexCount, 0);
+
+    // 面积加权的平面二次误差
+    for (size_t i = 0; i + 2 < _indices.size(); i += 3) {
+        const PTF_3D &p0 = position(_indices[i]);
+        const PTF_3D normal =
+            glm::cross(position(_indices[i + 1]) - p0,
+                       position(_indices[i + 2]) - p0);
+        const float length = glm::length(normal);
+        if (length <= 0.0f) {
+            continue;
+        }
+
+        const PTF_3D n = normal / length;
+        const double d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k) {
+            _quadrics[_indices[i + k]].AddPlane(n, d, 0.5 * length);
+        }
+    }
+
+    // 只属于一个三角形的边是边界（UV / 法线接缝处顶点被拆开，同样是边界）
+    std::unordered_map<uint64_t, uint32_t> edgeCounts;
+    edgeCounts.reserve(_indices.size());
+    auto edgeKey = [](uint32_t a, uint32_t b) {
+        return (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+    };
+    for (size_t i = 0; i + 2 < _indices.size(); i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            ++edgeCounts[edgeKey(_indices[i + k],
+                                 _indices[i + (k + 1) % 3])];
+        }
+    }
+    for (const auto &[key, count] : edgeCounts) {
+        if (count == 1) {
+            _locked[key >> 32] = 1;
+            _locked[key & 0xFFFFFFFFu] = 1;
+        }
+    }
+}
+
+float MeshSimplifier::Simplify(size_t targetTriangles,
+                               std::vector<uint32_t> &outIndices)
+{
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> remap(_vertices.size());
+    std::vector<uint8_t> touched(_vertices.size());
+    std::vector<uint32_t> fromRing;
+    std::vector<uint32_t> toRing;
+
+    while (_indices.size() / 3 > targetTriangles) {
+        buildAdjacency();
+
+        // 每条内部边出现两次，只取 a < b 的一次，方向取代价较小的一端
+        collapses.clear();
+        for (size_t i = 0; i + 2 < _indices.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = _indices[i + k];
+                const uint32_t b = _indices[i + (k + 1) % 3];
+                if (a > b || (_locked[a] && _locked[b])) {
+                    continue;
+                }
+
+                const double costAB =
+                    _locked[a] ? HUGE_VAL : collapseCost(a, b);
+                const double costBA =
+                    _locked[b] ? HUGE_VAL : collapseCost(b, a);
+                collapses.push_back(costAB <= costBA
+                                        ? Collapse{a, b, costAB}
+                                        : Collapse{b, a, costBA});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse &x, const Collapse &y) {
+                      return x.cost < y.cost;
+                  });
+
+        // 一环邻域被改动过的顶点本趟不再参与，保证翻转检查有效
+        const size_t needed = _indices.size() / 3 - targetTriangles;
+        size_t removed = 0;
+        for (uint32_t i = 0; i < remap.size(); ++i) {
+            remap[i] = i;
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+
+        for (const Collapse &collapse : collapses) {
+            if (removed >= needed) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+
+            const uint32_t count =
+                checkCollapse(collapse.from, collapse.to, fromRing, toRing);
+            if (count == 0) {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+            _quadrics[collapse.to] += _quadrics[collapse.from];
+            _maxCost = std::max(_maxCost, collapse.cost);
+            removed += count;
+
+            touched[collapse.from] = 1;
+            touched[collapse.to] = 1;
+            for (uint32_t vertex : fromRing) {
+                touched[vertex] = 1;
+            }
+        }
+
+        if (removed == 0) {
+            break;
+        }
+
+        // 重写索引，删除退化三角形
+        size_t write = 0;
+        for (size_t i = 0; i + 2 < _indices.size(); i += 3) {
+            const uint32_t a = remap[_indices[i]];
+            const uint32_t b = remap[_indices[i + 1]];
+            const uint32_t c = remap[_indices[i + 2]];
+            if (a == b || b == c || a == c) {
+                continue;
+            }
+            _indices[write++] = a;
+            _indices[write++] = b;
+            _indices[write++] = c;
+        }
+        _indices.resize(write);
+    }
+
+    outIndices = _indices;
+    return static_cast<float>(std::sqrt(std::max(_maxCost, 0.0)));
+}
+
+void MeshSimplifier::buildAdjacency()
+{
+    _triangleOffsets.assign(_vertices.size() + 1, 0);
+    for (uint32_t index : _indices) {
+        ++_triangleOffsets[index + 1];
+    }
+    for (size_t i = 1; i < _triangleOffsets.size(); ++i) {
+        _triangleOffsets[i] += _triangleOffsets[i - 1];
+    }
+
+    std::vector<uint32_t> cursor(_triangleOffsets.begin(),
+                                 _triangleOffsets.end() - 1);
+    _vertexTriangles.resize(_indices.size());
+    for (size_t i = 0; i < _indices.size(); ++i) {
+        _vertexTriangles[cursor[_indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+}
+
+double MeshSimplifier::collapseCost(uint32_t from, uint32_t to) const
+{
+    Quadric quadric = _quadrics[from];
+    quadric += _quadrics[to];
+    if (quadric.weight <= 0.0) {
+        return 0.0;
+    }
+    return quadric.Evaluate(position(to)) / quadric.weight;
+}
+
+uint32_t MeshSimplifier::checkCollapse(uint32_t from, uint32_t to,
+                                       std::vector<uint32_t> &fromRing,
+                                       std::vector<uint32_t> &toRing) const
+{
+    uint32_t shared = 0;
+    for (uint32_t t = _triangleOffsets[from]; t < _triangleOffsets[from + 1];
+         ++t) {
+        const uint32_t *triangle = &_indices[_vertexTriangles[t] * 3];
+        if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+            ++shared;
+            continue;
+        }
+
+        // from 移到 to 后三角形法线不能反向（或退化）
+        PTF_3D before[3];
+        PTF_3D after[3];
+        for (int k = 0; k < 3; ++k) {
+            before[k] = position(triangle[k]);
+            after[k] = triangle[k] == from ? position(to) : before[k];
+        }
+        const PTF_3D n0 =
+            glm::cross(before[1] - before[0], before[2] - before[0]);
+        const PTF_3D n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+        if (glm::dot(n0, n1) <= 0.0f) {
+            return 0;
+        }
+    }
+
+    // 链接条件：两端的公共邻居只能是被删除三角形的对顶点，否则产生非流形
+    gatherRing(from, fromRing);
+    gatherRing(to, toRing);
+    size_t common = 0;
+    for (size_t i = 0, j = 0; i < fromRing.size() && j < toRing.size();) {
+        if (fromRing[i] < toRing[j]) {
+            ++i;
+        } else if (toRing[j] < fromRing[i]) {
+            ++j;
+        } else {
+            ++common;
+            ++i;
+            ++j;
+        }
+    }
+    if (shared == 0 || common != shared) {
+        return 0;
+    }
+    return shared;
+}
+
+void MeshSimplifier::gatherRing(uint32_t vertex,
+                                std::vector<uint32_t> &ring) const
+{
+    ring.clear();
+    for (uint32_t t = _triangleOffsets[vertex];
+         t < _triangleOffsets[vertex + 1]; ++t) {
+        const uint32_t *triangle = &_indices[_vertexTriangles[t] * 3];
+        for (int k = 0; k < 3; ++k) {
+            if (triangle[k] != vertex) {
+                ring.push_back(triangle[k]);
+            }
+        }
+    }
+    std::sort(ring.begin(), ring.end());
+    ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+}
+} // namespace
+
+void VulkanMeshLod::Cook(const std::vector<VerCorTexNor> &vertices,
+                         const std::vector<uint32_t> &indices,
+                         CookedMesh &mesh, uint32_t maxLodCount)
+{
+    mesh.vertices = vertices;
+    mesh.indices = indices;
+    mesh.sourceHash = HashSource(vertices, indices);
+
+    MeshLod base{};
+    base.indexCount = static_cast<uint32_t>(indices.size());
+    mesh.lods.assign(1, base);
+
+    // 每级在上一级的基础上继续折叠，误差随之累计
+    MeshSimplifier simplifier(vertices, indices);
+    std::vector<uint32_t> lodIndices;
+    while (mesh.lods.size() < maxLodCount) {
+        const size_t triangles = mesh.lods.back().indexCount / 3;
+        if (triangles < MIN_LOD_TRIANGLES) {
+            break;
+        }
+
+        const float error = simplifier.Simplify(triangles / 2, lodIndices);
+        if (lodIndices.size() / 3 > triangles * (1.0f - MIN_LOD_REDUCTION)) {
+            break;
+        }
+
+        MeshLod lod{};
+        lod.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+        lod.indexCount = static_cast<uint32_t>(lodIndices.size());
+        lod.error = std::max(error, mesh.lods.back().error);
+        mesh.lods.push_back(lod);
+
+        mesh.indices.insert(mesh.indices.end(), lodIndices.begin(),
+                            lodIndices.end());
+    }
+}
+
+bool VulkanMeshLod::Load(const std::string &filename, uint64_t sourceHash,
+                         CookedMesh &mesh)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    MeshFileHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+        || std::memcmp(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC)) != 0
+        || header.version != MESH_VERSION) {
+        PSG::PrintError("网格烘焙文件版本不匹配，忽略!");
+        return false;
+    }
+    if (header.sourceHash != sourceHash || 0 == header.lodCount) {
+        return false;
+    }
+
+    mesh.sourceHash = header.sourceHash;
+    mesh.vertices.resize(header.vertexCount);
+    mesh.indices.resize(header.indexCount);
+    mesh.lods.resize(header.lodCount);
+    file.read(reinterpret_cast<char *>(mesh.vertices.data()),
+              sizeof(VerCorTexNor) * mesh.vertices.size());
+    file.read(reinterpret_cast<char *>(mesh.indices.data()),
+              sizeof(uint32_t) * mesh.indices.size());
+    file.read(reinterpret_cast<char *>(mesh.lods.data()),
+              sizeof(MeshLod) * mesh.lods.size());
+    if (!file) {
+        PSG::PrintError("读取网格烘焙文件失败!");
+        return false;
+    }
+
+    // 各级范围必须落在索引缓冲内
+    for (const MeshLod &lod : mesh.lods) {
+        if (size_t(lod.firstIndex) + lod.indexCount > mesh.indices.size()) {
+            PSG::PrintError("网格烘焙文件已损坏!");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VulkanMeshLod::Save(const std::string &filename, const CookedMesh &mesh)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        PSG::PrintError("写入网格烘焙文件失败!");
+        return false;
+    }
+
+    MeshFileHeader header{};
+    std::memcpy(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC));
+    header.version = MESH_VERSION;
+    header.sourceHash = mesh.sourceHash;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(mesh.vertices.data()),
+               sizeof(VerCorTexNor) * mesh.vertices.size());
+    file.write(reinterpret_cast<const char *>(mesh.indices.data()),
+               sizeof(uint32_t) * mesh.indices.size());
+    file.write(reinterpret_cast<const char *>(mesh.lods.data()),
+               sizeof(MeshLod) * mesh.lods.size());
+    return static_cast<bool>(file);
+}
+
+uint64_t VulkanMeshLod::HashSource(const std::vector<VerCorTexNor> &vertices,
+                                   const std::vector<uint32_t> &indices)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto hashBytes = [&](const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    // 数量也参与哈希，避免拼接边界不同的两组数据碰撞
+    const uint64_t counts[2] = {vertices.size(), indices.size()};
+    hashBytes(counts, sizeof(counts));
+    hashBytes(vertices.data(), sizeof(VerCorTexNor) * vertices.size());
+    hashBytes(indices.data(), sizeof(uint32_t) * indices.size());
+    return hash;
+}
+
+float VulkanMeshLod::ProjectionScale(float height, float fovY)
+{
+    return height / (2.0f * std::tan(0.5f * fovY));
+}
+
+uint32_t VulkanMeshLod::SelectLod(const std::vector<MeshLod> &lods,
+                                  float objectScale, float distance,
+                                  float projectionScale, uint32_t currentLod,
+                                  float pixelError, float hysteresis)
+{
+    if (lods.empty()) {
+        return 0;
+    }
+
+    const float scale =
+        objectScale * projectionScale / std::max(distance, 1e-4f);
+    auto pixels = [&](uint32_t lod) { return lods[lod].error * scale; };
+
+    // 当前级误差超出阈值时变细，下一级误差明显低于阈值时才变粗
+    uint32_t lod = std::min(currentLod, uint32_t(lods.size() - 1));
+    while (lod > 0 && pixels(lod) > pixelError) {
+        --lod;
+    }
+    while (lod + 1 < lods.size()
+           && pixels(lod + 1) <= pixelError * (1.0f - hysteresis)) {
+        ++lod;
+    }
+    return lod;
+}
+
+} // namespace VKB
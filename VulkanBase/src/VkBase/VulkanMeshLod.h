@@ -0,0 +1,104 @@
+﻿#ifndef VULKANMESHLOD_H_
+#define VULKANMESHLOD_H_
+
+#include <string>
+
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 一级 LOD 在共享索引缓冲中的范围
+ */
+struct MeshLod
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+
+    // 相对原网格的几何误差（网格局部空间的距离）
+    float error = 0.0f;
+};
+
+/**
+ * @brief 烘焙后的网格
+ *
+ * 各级 LOD 共用同一组顶点，索引依次拼接在一个索引缓冲中，
+ * lods[0] 为原网格
+ */
+struct CookedMesh
+{
+    std::vector<VerCorTexNor> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods;
+
+    // 源网格的哈希，用于判断烘焙文件是否过期
+    uint64_t sourceHash = 0;
+};
+
+/**
+ * @brief VulkanMeshLod
+ *
+ * 导入时生成 LOD 链，运行时按屏幕空间误差选择：
+ * - 二次误差度量（QEM）边折叠，顶点折叠到已有顶点上，不产生新顶点
+ * - 边界边上的顶点（含 UV / 法线接缝拆开的顶点）锁定，保证外形和接缝不裂开
+ * - 翻转三角形法线的折叠被拒绝
+ * - 每级在上一级的基础上继续简化，三角形数约减半，误差单调不减
+ * - 烘焙结果以二进制文件缓存，源网格变化时自动重新生成
+ */
+class VulkanMeshLod
+{
+public:
+    static constexpr uint32_t MAX_LOD_COUNT = 5;
+
+    /**
+     * @brief 生成 LOD 链
+     * @param maxLodCount 最多级数（含原网格），简化效果不足 10% 时提前结束
+     */
+    static void Cook(const std::vector<VerCorTexNor> &vertices,
+                     const std::vector<uint32_t> &indices, CookedMesh &mesh,
+                     uint32_t maxLodCount = MAX_LOD_COUNT);
+
+    /**
+     * @brief 读取烘焙文件
+     * @param sourceHash 期望的源网格哈希，不一致时视为过期
+     */
+    static bool Load(const std::string &filename, uint64_t sourceHash,
+                     CookedMesh &mesh);
+
+    static bool Save(const std::string &filename, const CookedMesh &mesh);
+
+    /**
+     * @brief 源网格的哈希（FNV-1a）
+     */
+    static uint64_t HashSource(const std::vector<VerCorTexNor> &vertices,
+                               const std::vector<uint32_t> &indices);
+
+    /**
+     * @brief 投影缩放：距离为 1 处单位长度对应的像素数
+     * @param height 视口高度（像素）
+     * @param fovY 垂直视场角（弧度）
+     */
+    static float ProjectionScale(float height, float fovY);
+
+    /**
+     * @brief 按屏幕空间误差选择 LOD
+     *
+     * 误差投影到屏幕的像素数不超过 pixelError 的最粗一级；
+     * 变粗时要求误差低于 pixelError * (1 - hysteresis)，
+     * 避免在阈值附近来回切换
+     *
+     * @param objectScale 模型矩阵的最大缩放
+     * @param distance 相机到物体的距离
+     * @param currentLod 物体当前使用的 LOD
+     */
+    static uint32_t SelectLod(const std::vector<MeshLod> &lods,
+                              float objectScale, float distance,
+                              float projectionScale, uint32_t currentLod,
+                              float pixelError = 1.0f,
+                              float hysteresis = 0.25f);
+};
+
+} // namespace VKB
+
+#endif // !VULKANMESHLOD_H_
@@ -27,6 +27,11 @@ public:
 
     void Destroy();
 
+    VkImage GetImage() const
+    {
+        return _image.GetImage();
+    }
+
     VkImageView GetImageView() const
     {
         return _image.GetImageView();
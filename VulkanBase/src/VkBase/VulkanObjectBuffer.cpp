@@ -0,0 +1,69 @@
+﻿#include "VulkanObjectBuffer.h"
+#include "PrintMsg.h"
+
+#include <algorithm>
+
+namespace VKB
+{
+
+VulkanObjectBuffer::~VulkanObjectBuffer()
+{
+    Destroy();
+}
+
+bool VulkanObjectBuffer::Init(VkPhysicalDevice physicalDevice,
+                              VkDevice device, uint32_t capacity)
+{
+    _physicalDevice = physicalDevice;
+    _device = device;
+    return createBuffer(std::max(1u, capacity));
+}
+
+bool VulkanObjectBuffer::Update(const std::vector<ObjectData> &objects)
+{
+    if (objects.empty()) {
+        return true;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(objects.size());
+    if (count > _capacity) {
+        uint32_t capacity = std::max(1u, _capacity);
+        while (capacity < count) {
+            capacity *= 2;
+        }
+
+        _buffer.Destroy();
+        if (!createBuffer(capacity)) {
+            PSG::PrintError("物体缓冲扩容失败!");
+            return false;
+        }
+    }
+
+    void *mapped = _buffer.Map();
+    memcpy(mapped, objects.data(), sizeof(ObjectData) * objects.size());
+    _buffer.Unmap();
+
+    return true;
+}
+
+void VulkanObjectBuffer::Destroy()
+{
+    _buffer.Destroy();
+    _capacity = 0;
+}
+
+bool VulkanObjectBuffer::createBuffer(uint32_t capacity)
+{
+    if (!_buffer.Init(_physicalDevice, _device, sizeof(ObjectData) * capacity,
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                          | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        _capacity = 0;
+        return false;
+    }
+
+    _capacity = capacity;
+    return true;
+}
+
+} // namespace VKB
@@ -0,0 +1,67 @@
+﻿#ifndef VULKANOBJECTBUFFER_H_
+#define VULKANOBJECTBUFFER_H_
+
+#include "VulkanBuffer.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanObjectBuffer
+ *
+ * 逐物体数据的存储缓冲（ObjectData，绑定 5），主机可见，每帧整体重写
+ * - 每个在途帧一个，写入前该帧的栅栏必须已等待
+ * - 着色器按 gl_InstanceIndex 寻址，整帧只需绑定一次描述符集
+ * - 容量不足时按 2 倍扩容，扩容后需要重写描述符
+ */
+class VulkanObjectBuffer
+{
+public:
+    VulkanObjectBuffer() = default;
+
+    ~VulkanObjectBuffer();
+
+    /**
+     * @brief 初始化
+     * @param capacity 初始容量（物体个数）
+     */
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
+              uint32_t capacity);
+
+    // 写入物体数据（必要时扩容，扩容后 Get 返回新缓冲）
+    bool Update(const std::vector<ObjectData> &objects);
+
+    void Destroy();
+
+    VkBuffer Get() const
+    {
+        return _buffer.Get();
+    }
+
+    // 整个缓冲的字节数（写入描述符的范围）
+    VkDeviceSize GetSize() const
+    {
+        return _buffer.GetSize();
+    }
+
+    uint32_t GetCapacity() const
+    {
+        return _capacity;
+    }
+
+private:
+    bool createBuffer(uint32_t capacity);
+
+private:
+    VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
+
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VulkanBuffer _buffer;
+
+    uint32_t _capacity = 0;
+};
+
+} // namespace VKB
+
+#endif // !VULKANOBJECTBUFFER_H_
@@ -0,0 +1,147 @@
+﻿#include "VulkanParallelRecorder.h"
+
+#include <algorithm>
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+VulkanParallelRecorder::VulkanParallelRecorder()
+{
+}
+
+VulkanParallelRecorder::~VulkanParallelRecorder()
+{
+    Destroy();
+}
+
+bool VulkanParallelRecorder::Init(VkDevice device, uint32_t queueFamilyIndex,
+                                  uint32_t framesInFlight,
+                                  PSG::JobSystem *jobSystem,
+                                  uint32_t sliceCount)
+{
+    if (VK_NULL_HANDLE == device || nullptr == jobSystem) {
+        PSG::PrintError("创建并行录制器失败：逻辑设备或调度器为空!");
+        return false;
+    }
+
+    _jobSystem = jobSystem;
+    if (0 == sliceCount) {
+        sliceCount = _jobSystem->GetConcurrency();
+    }
+
+    for (uint32_t s = 0; s < sliceCount; ++s) {
+        Slice *slice = new Slice();
+        _slices.push_back(slice);
+
+        for (uint32_t f = 0; f < framesInFlight; ++f) {
+            // 每帧整体重置，不需要单独 reset CommandBuffer
+            VulkanCommandPool *pool = new VulkanCommandPool();
+            slice->pools.push_back(pool);
+            if (!pool->Init(device, queueFamilyIndex,
+                            VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)) {
+                Destroy();
+                return false;
+            }
+
+            VulkanCommandBuffer *commandBuffer = new VulkanCommandBuffer();
+            slice->commandBuffers.push_back(commandBuffer);
+            if (!commandBuffer->Init(device, pool->Get(), 1,
+                                     VK_COMMAND_BUFFER_LEVEL_SECONDARY)) {
+                Destroy();
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void VulkanParallelRecorder::Destroy()
+{
+    for (auto *slice : _slices) {
+        // 先释放 CommandBuffer，再销毁所属命令池
+        for (auto *commandBuffer : slice->commandBuffers) {
+            SDelete(commandBuffer);
+        }
+        for (auto *pool : slice->pools) {
+            SDelete(pool);
+        }
+        SDelete(slice);
+    }
+    _slices.clear();
+    _jobSystem = nullptr;
+}
+
+void VulkanParallelRecorder::SetDynamicStates(
+    uint32_t dynamicStates, PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode)
+{
+    for (auto *slice : _slices) {
+        slice->stateCache.Init(dynamicStates, cmdSetPolygonMode);
+
+        VulkanDynamicStateCache *stateCache = nullptr;
+        if (slice->stateCache.GetDynamicStates() != DYNAMIC_STATE_NONE) {
+            stateCache = &slice->stateCache;
+        }
+        for (auto *commandBuffer : slice->commandBuffers) {
+            commandBuffer->SetDynamicStateCache(stateCache);
+        }
+    }
+}
+
+bool VulkanParallelRecorder::Record(
+    uint32_t frame, const SecondaryTarget &target, VkExtent2D extent,
+    VkPipelineLayout pipelineLayout, const VulkanRenderQueue &queue,
+    std::vector<VkCommandBuffer> &secondaries)
+{
+    secondaries.clear();
+
+    // 按批次切分（未开启实例化时一个批次即一个 Draw）
+    const size_t drawCount = queue.GetBatchCount();
+    if (0 == drawCount || _slices.empty()) {
+        return true;
+    }
+
+    // 按最小粒度决定实际的段数，区间连续以保持绘制顺序
+    const size_t maxSlices =
+        (drawCount + MIN_DRAWS_PER_SLICE - 1) / MIN_DRAWS_PER_SLICE;
+    const uint32_t sliceCount = static_cast<uint32_t>(
+        std::min(maxSlices, static_cast<size_t>(_slices.size())));
+    const size_t sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+
+    PSG::JobCounter counter;
+    for (uint32_t s = 0; s < sliceCount; ++s) {
+        Slice *slice = _slices[s];
+        slice->first = s * sliceSize;
+        slice->count = std::min(sliceSize, drawCount - slice->first);
+
+        _jobSystem->Run(
+            [slice, frame, &target, extent, pipelineLayout, &queue]() {
+                // 该帧栅栏已等待，上次录制的内容 GPU 不再使用
+                slice->pools[frame]->Reset();
+
+                VulkanCommandBuffer *commandBuffer =
+                    slice->commandBuffers[frame];
+                slice->succeeded = commandBuffer->RecordSecondary(
+                    0, target, extent, pipelineLayout, queue, slice->first,
+                    slice->count);
+            },
+            &counter);
+    }
+    _jobSystem->Wait(counter);
+
+    bool succeeded = true;
+    for (uint32_t s = 0; s < sliceCount; ++s) {
+        succeeded = succeeded && _slices[s]->succeeded;
+        secondaries.push_back(_slices[s]->commandBuffers[frame]->Get(0));
+    }
+
+    if (!succeeded) {
+        PSG::PrintError("并行录制命令缓冲区失败!");
+        secondaries.clear();
+    }
+    return succeeded;
+}
+
+} // namespace VKB
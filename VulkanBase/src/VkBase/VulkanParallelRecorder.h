@@ -0,0 +1,91 @@
+﻿#ifndef VULKANPARALLELRECORDER_H_
+#define VULKANPARALLELRECORDER_H_
+
+#include "JobSystem.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanCommandPool.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanParallelRecorder
+ *
+ * 多线程命令录制：
+ * - 渲染队列切分为若干段，每段作为一个任务提交到 JobSystem
+ * - 每段每帧拥有独立的 CommandPool（池不能被两个线程同时使用，
+ *   一段同一时刻只在一个线程上执行）
+ * - 主线程按切分顺序 vkCmdExecuteCommands，保持队列的排序结果
+ */
+class VulkanParallelRecorder
+{
+public:
+    VulkanParallelRecorder();
+
+    ~VulkanParallelRecorder();
+
+public:
+    /**
+     * @brief 创建每段每帧的命令池
+     * @param framesInFlight 同时在途的帧数
+     * @param jobSystem 执行录制任务的调度器
+     * @param sliceCount 最大段数，0 表示调度器的并发线程数
+     */
+    bool Init(VkDevice device, uint32_t queueFamilyIndex,
+              uint32_t framesInFlight, PSG::JobSystem *jobSystem,
+              uint32_t sliceCount = 0);
+
+    void Destroy();
+
+    /**
+     * @brief 设置动态状态（每段持有独立的 VulkanDynamicStateCache）
+     */
+    void SetDynamicStates(uint32_t dynamicStates,
+                          PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode);
+
+    /**
+     * @brief 并行录制本帧的全部 Draw
+     *
+     * 调用前该帧的栅栏必须已经等待完成（命令池会被整体重置）；
+     * 等待期间调用线程也执行录制任务
+     * @param frame 当前帧序号（< framesInFlight）
+     * @param queue 已排序的渲染队列
+     * @param secondaries 输出的二级命令缓冲，按绘制顺序排列
+     */
+    bool Record(uint32_t frame, const SecondaryTarget &target,
+                VkExtent2D extent, VkPipelineLayout pipelineLayout,
+                const VulkanRenderQueue &queue,
+                std::vector<VkCommandBuffer> &secondaries);
+
+    uint32_t GetSliceCount() const
+    {
+        return static_cast<uint32_t>(_slices.size());
+    }
+
+private:
+    // 单段分到的 Draw 太少时，任务调度开销超过录制本身
+    static constexpr size_t MIN_DRAWS_PER_SLICE = 64;
+
+    struct Slice
+    {
+        // 每帧一个命令池 + 一个二级命令缓冲
+        std::vector<VulkanCommandPool *> pools;
+        std::vector<VulkanCommandBuffer *> commandBuffers;
+
+        VulkanDynamicStateCache stateCache;
+
+        // 本次分到的 Draw 区间
+        size_t first = 0;
+        size_t count = 0;
+        bool succeeded = true;
+    };
+
+private:
+    PSG::JobSystem *_jobSystem = nullptr;
+
+    std::vector<Slice *> _slices;
+};
+
+} // namespace VKB
+
+#endif // !VULKANPARALLELRECORDER_H_
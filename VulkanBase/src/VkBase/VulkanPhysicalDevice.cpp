@@ -64,10 +64,24 @@ bool VulkanPhysicalDevice::Pick(VkInstance instance, VkSurfaceKHR surface)
     // 获取物理设备的基本属性
     vkGetPhysicalDeviceProperties(_physicalDevice, &_properties);
 
+    // 查询可选特性
+    queryFeatureSupport();
+
     PSG::PrintMsg("选择的物理设备", _properties.deviceName);
     return true;
 }
 
+bool VulkanPhysicalDevice::IsExtensionSupported(const char *name) const
+{
+    for (const auto &ext : _extensions) {
+        if (strcmp(name, ext.extensionName) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool VulkanPhysicalDevice::isDeviceSuitable(VkPhysicalDevice device,
                                             VkSurfaceKHR surface)
 {
@@ -190,4 +204,119 @@ int VulkanPhysicalDevice::RateDevice(VkPhysicalDevice device)
     return score;
 }
 
+void VulkanPhysicalDevice::queryFeatureSupport()
+{
+    _featureSupport = DeviceFeatureSupport{};
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr,
+                                         &extensionCount, nullptr);
+    _extensions.resize(extensionCount);
+    vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr,
+                                         &extensionCount, _extensions.data());
+
+    // 1.3 核心特性结构体只能在设备版本 >= 1.3 时查询
+    if (_properties.apiVersion < VK_API_VERSION_1_3) {
+        return;
+    }
+
+    // 特性查询链：features2 -> 1.2 -> 1.3 -> 已支持扩展的特性结构体
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    void **next = &features2.pNext;
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    *next = &features12;
+    next = &features12.pNext;
+
+    VkPhysicalDeviceVulkan13Features features13{};
+    features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    *next = &features13;
+    next = &features13.pNext;
+
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3Features{};
+    eds3Features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    const bool hasEds3 = IsExtensionSupported(
+        VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    if (hasEds3) {
+        *next = &eds3Features;
+        next = &eds3Features.pNext;
+    }
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT gplFeatures{};
+    gplFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    const bool hasGpl =
+        IsExtensionSupported(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME)
+        && IsExtensionSupported(
+            VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    if (hasGpl) {
+        *next = &gplFeatures;
+        next = &gplFeatures.pNext;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    const bool hasPresentWait =
+        IsExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+        && IsExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    if (hasPresentWait) {
+        *next = &presentIdFeatures;
+        next = &presentIdFeatures.pNext;
+        *next = &presentWaitFeatures;
+        next = &presentWaitFeatures.pNext;
+    }
+
+    vkGetPhysicalDeviceFeatures2(_physicalDevice, &features2);
+
+    _featureSupport.dynamicRendering = features13.dynamicRendering == VK_TRUE;
+
+    _featureSupport.drawIndirectFirstInstance =
+        features2.features.drawIndirectFirstInstance == VK_TRUE;
+    _featureSupport.multiDrawIndirect =
+        features2.features.multiDrawIndirect == VK_TRUE;
+    _featureSupport.drawIndirectCount = features12.drawIndirectCount == VK_TRUE;
+    _featureSupport.descriptorIndexing =
+        features12.runtimeDescriptorArray == VK_TRUE
+        && features12.descriptorBindingPartiallyBound == VK_TRUE
+        && features12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+        && features12.descriptorBindingUpdateUnusedWhilePending == VK_TRUE
+        && features12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+
+    // EDS1 / EDS2 的基础状态已提升为 1.3 核心功能
+    _featureSupport.extendedDynamicState = true;
+
+    _featureSupport.extendedDynamicState3PolygonMode =
+        hasEds3 && eds3Features.extendedDynamicState3PolygonMode == VK_TRUE;
+
+    // 推送描述符没有特性结构体，扩展支持即可使用
+    _featureSupport.pushDescriptor =
+        IsExtensionSupported(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+
+    _featureSupport.presentWait = hasPresentWait
+                                  && presentIdFeatures.presentId == VK_TRUE
+                                  && presentWaitFeatures.presentWait == VK_TRUE;
+
+    // 管线库：只有支持快速链接时才比完整管线更快
+    if (hasGpl && gplFeatures.graphicsPipelineLibrary == VK_TRUE) {
+        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT gplProps{};
+        gplProps.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+
+        VkPhysicalDeviceProperties2 props2{};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props2.pNext = &gplProps;
+        vkGetPhysicalDeviceProperties2(_physicalDevice, &props2);
+
+        _featureSupport.graphicsPipelineLibrary =
+            gplProps.graphicsPipelineLibraryFastLinking == VK_TRUE;
+    }
+}
+
 } // namespace VKB
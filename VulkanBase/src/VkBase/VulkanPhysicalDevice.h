@@ -8,6 +8,45 @@
 namespace VKB
 {
 
+/**
+ * @brief 可选设备特性
+ *
+ * 由物理设备查询得到，逻辑设备按此启用；不支持时使用回退路径
+ */
+struct DeviceFeatureSupport
+{
+    // VK_KHR_dynamic_rendering（Vulkan 1.3 核心）
+    bool dynamicRendering = false;
+
+    // VK_EXT_extended_dynamic_state 1/2（Vulkan 1.3 核心，无需特性开关）
+    bool extendedDynamicState = false;
+
+    // VK_EXT_extended_dynamic_state3 多边形模式
+    bool extendedDynamicState3PolygonMode = false;
+
+    // VK_EXT_graphics_pipeline_library（且支持快速链接）
+    bool graphicsPipelineLibrary = false;
+
+    // 间接绘制命令中 firstInstance 可以非 0（GPU 驱动用作物体下标）
+    bool drawIndirectFirstInstance = false;
+
+    // 一次间接绘制调用提交多条命令
+    bool multiDrawIndirect = false;
+
+    // vkCmdDrawIndexedIndirectCount（Vulkan 1.2 核心）
+    bool drawIndirectCount = false;
+
+    // VK_KHR_present_id + VK_KHR_present_wait（按显示时间节拍）
+    bool presentWait = false;
+
+    // 描述符索引（Vulkan 1.2 核心）：运行时数组、部分绑定、
+    // 绑定后更新的采样图像、非一致索引（Bindless 纹理表）
+    bool descriptorIndexing = false;
+
+    // VK_KHR_push_descriptor（小型描述符集直接录制进命令缓冲）
+    bool pushDescriptor = false;
+};
+
 /**
  * @brief VulkanPhysicalDevice
  *
@@ -79,6 +118,19 @@ public:
         return _msaaSamples;
     }
 
+    /**
+     * @brief 获取可选特性支持情况
+     */
+    const DeviceFeatureSupport &GetFeatureSupport() const
+    {
+        return _featureSupport;
+    }
+
+    /**
+     * @brief 设备是否支持指定扩展
+     */
+    bool IsExtensionSupported(const char *name) const;
+
 private:
     /**
      * @brief 检查某个物理设备是否满足最低要求
@@ -103,6 +155,11 @@ private:
      */
     int RateDevice(VkPhysicalDevice device);
 
+    /**
+     * @brief 查询可选特性（动态渲染等）
+     */
+    void queryFeatureSupport();
+
 private:
     // 选中的物理设备
     VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
@@ -116,6 +173,12 @@ private:
     // 设备支持的最大采样数（MSAA）
     VkSampleCountFlagBits _msaaSamples;
 
+    // 可选特性支持情况
+    DeviceFeatureSupport _featureSupport;
+
+    // 设备支持的扩展列表
+    std::vector<VkExtensionProperties> _extensions;
+
     // 必需的设备扩展
     const std::vector<const char *> _requiredExtensions = {
         // 交换链(swapChain)扩展
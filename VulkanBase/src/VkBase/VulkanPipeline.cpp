@@ -1,48 +1,95 @@
 ﻿#include "VulkanPipeline.h"
 
+#include <memory>
+
 #include "PrintMsg.h"
+#include "VulkanUtils.h"
 
 namespace VKB
 {
-VulkanPipeline::VulkanPipeline()
+
+size_t PipelineStateDesc::Hash() const
 {
+    size_t seed = 0;
+    HashCombine(seed, vertex.Hash());
+    HashCombine(seed, fragment.Hash());
+    HashCombine(seed, specConstants.Hash());
+    HashCombine(seed, renderPass);
+    HashCombine(seed, static_cast<uint32_t>(colorFormat));
+    HashCombine(seed, static_cast<uint32_t>(depthFormat));
+    HashCombine(seed, layout);
+    HashCombine(seed, static_cast<uint32_t>(samples));
+    HashCombine(seed, drawState.Hash());
+    HashCombine(seed, blendEnable);
+    HashCombine(seed, dynamicStates);
+    return seed;
 }
 
-VulkanPipeline::~VulkanPipeline()
+PipelineStateDesc PipelineStateDesc::CacheKey() const
 {
-    Destroy();
+    PipelineStateDesc key = *this;
+    key.drawState = drawState.StaticPart(dynamicStates);
+    return key;
 }
 
-bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
-                          VkPipelineLayout layout,
-                          const std::vector<VulkanShaderModule *> &shaders,
-                          VkExtent2D extent, VkSampleCountFlagBits samples)
+namespace
 {
-    if (VK_NULL_HANDLE == device) {
-        PSG::PrintError("创建图形管线失败：逻辑设备为空!");
-        return false;
-    }
+/**
+ * @brief 固定功能状态集合
+ *
+ * 完整管线与管线库共用，结构体之间互相引用，所以不可拷贝
+ */
+struct PipelineStates
+{
+    std::vector<VkVertexInputBindingDescription> bindingDesc;
+    std::vector<VkVertexInputAttributeDescription> attrDesc;
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    std::vector<VkDynamicState> dynamicStates;
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    VkPipelineViewportStateCreateInfo viewportState{};
+    VkPipelineRasterizationStateCreateInfo raster{};
+    VkPipelineMultisampleStateCreateInfo multisample{};
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    VkPipelineColorBlendStateCreateInfo colorBlend{};
+    VkPipelineRenderingCreateInfo renderingInfo{};
 
-    // =========================
-    // Shader Stages
-    // =========================
-    std::vector<VkPipelineShaderStageCreateInfo> stages;
-    for (auto *shader : shaders) {
-        stages.push_back(shader->GetStageInfo());
-    }
+    const PipelineStateDesc &desc;
+
+    explicit PipelineStates(const PipelineStateDesc &stateDesc);
+
+    PipelineStates(const PipelineStates &) = delete;
+    PipelineStates &operator=(const PipelineStates &) = delete;
 
+    void Fill(VkGraphicsPipelineCreateInfo &pipelineInfo,
+              const std::vector<VkPipelineShaderStageCreateInfo> &stages) const;
+};
+
+PipelineStates::PipelineStates(const PipelineStateDesc &stateDesc)
+    : desc(stateDesc)
+{
     // 顶点属性描述
-    auto bindingDesc = VerCorTexNor::getBindingDescription();
-    auto attrDesc = VerCorTexNor::getAttributeDescriptions();
+    bindingDesc.push_back(VerCorTexNor::getBindingDescription());
+    auto attributes = VerCorTexNor::getAttributeDescriptions();
+    attrDesc.assign(attributes.begin(), attributes.end());
+
+    // 硬件实例化：绑定 1 为逐实例数据
+    if (desc.vertex.features & SHADER_FEATURE_INSTANCING) {
+        bindingDesc.push_back(InstanceData::getBindingDescription());
+        auto instanceAttributes = InstanceData::getAttributeDescriptions();
+        attrDesc.insert(attrDesc.end(), instanceAttributes.begin(),
+                        instanceAttributes.end());
+    }
 
     // =========================
     // Vertex Input
     // =========================
-    VkPipelineVertexInputStateCreateInfo vertexInput{};
     vertexInput.sType =
         VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInput.vertexBindingDescriptionCount = 1;
-    vertexInput.pVertexBindingDescriptions = &bindingDesc;
+    vertexInput.vertexBindingDescriptionCount =
+        static_cast<uint32_t>(bindingDesc.size());
+    vertexInput.pVertexBindingDescriptions = bindingDesc.data();
     vertexInput.vertexAttributeDescriptionCount =
         static_cast<uint32_t>(attrDesc.size());
     vertexInput.pVertexAttributeDescriptions = attrDesc.data();
@@ -50,21 +97,31 @@ bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
     // =========================
     // Input Assembly
     // =========================
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType =
         VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = desc.drawState.topology;
 
     // 视口和剪裁状态设置为动态
-    std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
-                                                 VK_DYNAMIC_STATE_SCISSOR};
-    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+    // 扩展动态状态：录制时逐 Draw 设置，不再产生新的管线
+    if (desc.dynamicStates & DYNAMIC_STATE_EXTENDED) {
+        dynamicStates.insert(dynamicStates.end(),
+                             {VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+                              VK_DYNAMIC_STATE_CULL_MODE,
+                              VK_DYNAMIC_STATE_FRONT_FACE,
+                              VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+                              VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+                              VK_DYNAMIC_STATE_DEPTH_COMPARE_OP});
+    }
+    if (desc.dynamicStates & DYNAMIC_STATE_POLYGON_MODE) {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    }
     dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
     dynamicState.dynamicStateCount =
         static_cast<uint32_t>(dynamicStates.size());
     dynamicState.pDynamicStates = dynamicStates.data();
 
-    VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
     // viewportState.pViewports = &viewport;
@@ -74,36 +131,33 @@ bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
     // =========================
     // Rasterization
     // =========================
-    VkPipelineRasterizationStateCreateInfo raster{};
     raster.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    raster.polygonMode = VK_POLYGON_MODE_FILL;
-    raster.cullMode = VK_CULL_MODE_NONE;
-    raster.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    raster.polygonMode = desc.drawState.polygonMode;
+    raster.cullMode = desc.drawState.cullMode;
+    raster.frontFace = desc.drawState.frontFace;
     raster.lineWidth = 1.0f;
 
     // =========================
     // Multisample
     // =========================
-    VkPipelineMultisampleStateCreateInfo multisample{};
     multisample.sType =
         VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisample.sampleShadingEnable = VK_TRUE;
-    multisample.rasterizationSamples = samples;
+    multisample.rasterizationSamples = desc.samples;
     multisample.minSampleShading = 0.2f;
     multisample.pSampleMask = nullptr;
     multisample.alphaToCoverageEnable = VK_FALSE;
     multisample.alphaToOneEnable = VK_FALSE;
 
     // 深度测试和模板测试
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType =
         VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     // 是否应将新片段的深度与深度缓冲区进行比较
-    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthTestEnable = desc.drawState.depthTestEnable;
     // 是否应将通过深度测试的片段的新深度实际写入深度缓冲区
-    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = desc.drawState.depthWriteEnable;
     // 指定执行的比较以保留或丢弃片段
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthCompareOp = desc.drawState.depthCompareOp;
     // 用于可选的深度边界测试
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.minDepthBounds = 0.0f; // 可选
@@ -116,20 +170,34 @@ bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
     // =========================
     // Color Blend
     // =========================
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask =
         VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
         | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    // 透明混合：src.a * src + (1 - src.a) * dst
+    colorBlendAttachment.blendEnable = desc.blendEnable;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor =
+        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 
-    VkPipelineColorBlendStateCreateInfo colorBlend{};
     colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlend.attachmentCount = 1;
     colorBlend.pAttachments = &colorBlendAttachment;
 
-    // =========================
-    // Pipeline Create
-    // =========================
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    // 动态渲染：不依赖 RenderPass，只需声明附件格式
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &desc.colorFormat;
+    renderingInfo.depthAttachmentFormat = desc.depthFormat;
+}
+
+void PipelineStates::Fill(
+    VkGraphicsPipelineCreateInfo &pipelineInfo,
+    const std::vector<VkPipelineShaderStageCreateInfo> &stages) const
+{
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
     pipelineInfo.pStages = stages.data();
@@ -143,13 +211,68 @@ bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
     pipelineInfo.pDepthStencilState = &depthStencil;
 
     pipelineInfo.pColorBlendState = &colorBlend;
-    pipelineInfo.layout = layout;
-    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.layout = desc.layout;
+    pipelineInfo.renderPass = desc.renderPass;
     pipelineInfo.subpass = 0;
     pipelineInfo.pDynamicState = &dynamicState;
 
-    VkResult ret = vkCreateGraphicsPipelines(
-        device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline);
+    if (VK_NULL_HANDLE == desc.renderPass) {
+        pipelineInfo.pNext = &renderingInfo;
+    }
+}
+} // namespace
+
+VulkanPipeline::VulkanPipeline()
+{
+}
+
+VulkanPipeline::~VulkanPipeline()
+{
+    Destroy();
+}
+
+bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
+                          VkPipelineLayout layout,
+                          const std::vector<VulkanShaderModule *> &shaders,
+                          VkExtent2D extent, VkSampleCountFlagBits samples)
+{
+    // 视口和剪裁为动态状态，extent 在录制命令时设置
+    PipelineStateDesc desc{};
+    desc.renderPass = renderPass;
+    desc.layout = layout;
+    desc.samples = samples;
+
+    return Init(device, desc, shaders);
+}
+
+bool VulkanPipeline::Init(VkDevice device, const PipelineStateDesc &desc,
+                          const std::vector<VulkanShaderModule *> &shaders,
+                          VkPipelineCache cache)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建图形管线失败：逻辑设备为空!");
+        return false;
+    }
+
+    // =========================
+    // Shader Stages
+    // =========================
+    VkSpecializationInfo specInfo = desc.specConstants.GetInfo();
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    for (auto *shader : shaders) {
+        stages.push_back(shader->GetStageInfo(&specInfo));
+    }
+
+    PipelineStates states(desc);
+
+    // =========================
+    // Pipeline Create
+    // =========================
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    states.Fill(pipelineInfo, stages);
+
+    VkResult ret = vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo,
+                                             nullptr, &_pipeline);
 
     if (ret != VK_SUCCESS) {
         PSG::PrintError("创建图形管线失败!");
@@ -160,6 +283,154 @@ bool VulkanPipeline::Init(VkDevice device, VkRenderPass renderPass,
     return true;
 }
 
+bool VulkanPipeline::CreateBatch(
+    VkDevice device, VkPipelineCache cache,
+    const std::vector<PipelineStateDesc> &descs,
+    const std::vector<std::vector<VulkanShaderModule *>> &shaders,
+    std::vector<VulkanPipeline *> &pipelines)
+{
+    pipelines.assign(descs.size(), nullptr);
+    if (VK_NULL_HANDLE == device || descs.size() != shaders.size()) {
+        PSG::PrintError("批量创建图形管线失败：参数无效!");
+        return false;
+    }
+
+    // 创建信息互相引用，必须在调用期间保持地址不变
+    std::vector<std::unique_ptr<PipelineStates>> states;
+    std::vector<VkSpecializationInfo> specInfos(descs.size());
+    std::vector<std::vector<VkPipelineShaderStageCreateInfo>> stages(
+        descs.size());
+    std::vector<VkGraphicsPipelineCreateInfo> pipelineInfos(descs.size());
+
+    for (size_t i = 0; i < descs.size(); ++i) {
+        specInfos[i] = descs[i].specConstants.GetInfo();
+        for (auto *shader : shaders[i]) {
+            stages[i].push_back(shader->GetStageInfo(&specInfos[i]));
+        }
+
+        states.push_back(std::make_unique<PipelineStates>(descs[i]));
+        states.back()->Fill(pipelineInfos[i], stages[i]);
+    }
+
+    std::vector<VkPipeline> handles(descs.size(), VK_NULL_HANDLE);
+    VkResult ret = vkCreateGraphicsPipelines(
+        device, cache, static_cast<uint32_t>(pipelineInfos.size()),
+        pipelineInfos.data(), nullptr, handles.data());
+
+    // 部分失败时，成功的句柄仍然有效
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (handles[i] != VK_NULL_HANDLE) {
+            pipelines[i] = new VulkanPipeline();
+            pipelines[i]->_device = device;
+            pipelines[i]->_pipeline = handles[i];
+        }
+    }
+
+    if (ret != VK_SUCCESS) {
+        PSG::PrintError("批量创建图形管线失败!");
+        return false;
+    }
+    return true;
+}
+
+bool VulkanPipeline::InitLibrary(
+    VkDevice device, const PipelineStateDesc &desc,
+    const std::vector<VulkanShaderModule *> &shaders,
+    VkGraphicsPipelineLibraryFlagsEXT parts, VkPipelineCache cache)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建管线库失败：逻辑设备为空!");
+        return false;
+    }
+
+    // 只保留当前部分需要的着色器阶段
+    VkSpecializationInfo specInfo = desc.specConstants.GetInfo();
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    for (auto *shader : shaders) {
+        VkGraphicsPipelineLibraryFlagsEXT part =
+            VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+        if (shader->GetStage() == VK_SHADER_STAGE_FRAGMENT_BIT) {
+            part = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+        }
+        if (parts & part) {
+            stages.push_back(shader->GetStageInfo(&specInfo));
+        }
+    }
+
+    PipelineStates states(desc);
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    states.Fill(pipelineInfo, stages);
+
+    // 部分之外的状态会被驱动忽略；保留链接期优化信息供后台完整链接使用
+    pipelineInfo.flags =
+        VK_PIPELINE_CREATE_LIBRARY_BIT_KHR
+        | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+    libraryInfo.sType =
+        VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    libraryInfo.flags = parts;
+    if (VK_NULL_HANDLE == desc.renderPass) {
+        libraryInfo.pNext = &states.renderingInfo;
+    }
+    pipelineInfo.pNext = &libraryInfo;
+
+    VkResult ret = vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo,
+                                             nullptr, &_pipeline);
+
+    if (ret != VK_SUCCESS) {
+        PSG::PrintError("创建管线库失败!");
+        return false;
+    }
+
+    _device = device;
+    return true;
+}
+
+bool VulkanPipeline::InitLinked(VkDevice device,
+                                const std::vector<VkPipeline> &libraries,
+                                VkPipelineLayout layout, bool optimized,
+                                VkPipelineCache cache)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("链接图形管线失败：逻辑设备为空!");
+        return false;
+    }
+
+    VkPipelineLibraryCreateInfoKHR linkInfo{};
+    linkInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    linkInfo.libraryCount = static_cast<uint32_t>(libraries.size());
+    linkInfo.pLibraries = libraries.data();
+
+    // 不带优化标志即为快速链接
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = &linkInfo;
+    pipelineInfo.layout = layout;
+    if (optimized) {
+        pipelineInfo.flags = VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+    }
+
+    VkResult ret = vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo,
+                                             nullptr, &_pipeline);
+
+    if (ret != VK_SUCCESS) {
+        PSG::PrintError("链接图形管线失败!");
+        return false;
+    }
+
+    _device = device;
+    return true;
+}
+
+VkPipeline VulkanPipeline::Swap(VkPipeline pipeline)
+{
+    VkPipeline old = _pipeline;
+    _pipeline = pipeline;
+    return old;
+}
+
 void VulkanPipeline::Destroy()
 {
     // 销毁图形管线
@@ -1,12 +1,61 @@
 ﻿#ifndef VULKANPIPELINE_H_
 #define VULKANPIPELINE_H_
 
+#include "VulkanDynamicState.h"
 #include "VulkanHead.h"
 #include "VulkanShaderModule.h"
+#include "VulkanShaderVariant.h"
 
 namespace VKB
 {
 
+/**
+ * @brief 管线状态描述
+ *
+ * 描述一个图形管线的全部可变部分，作为 VulkanPipelineRegistry 的缓存键
+ */
+struct PipelineStateDesc
+{
+    // 着色器变体
+    ShaderVariantKey vertex;
+    ShaderVariantKey fragment;
+
+    // 特化常量（顶点 / 片段阶段共用）
+    ShaderSpecConstants specConstants;
+
+    // renderPass 为空时使用动态渲染，按附件格式创建管线
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+    // 固定功能状态（启用动态状态时在录制期间设置）
+    DynamicDrawState drawState;
+    VkBool32 blendEnable = VK_FALSE;
+
+    // 启用的动态状态（DynamicStateBits）
+    uint32_t dynamicStates = DYNAMIC_STATE_NONE;
+
+    bool operator==(const PipelineStateDesc &other) const = default;
+
+    size_t Hash() const;
+
+    /**
+     * @brief 管线缓存键：动态部分归一化，不同动态状态共用同一管线
+     */
+    PipelineStateDesc CacheKey() const;
+};
+
+struct PipelineStateDescHash
+{
+    size_t operator()(const PipelineStateDesc &desc) const
+    {
+        return desc.Hash();
+    }
+};
+
 /**
  * @brief VulkanPipeline
  *
@@ -36,6 +85,51 @@ public:
               VkExtent2D extent,
               VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
 
+    /**
+     * @brief 根据管线状态描述创建 Graphics Pipeline
+     * @param device 逻辑设备
+     * @param desc 管线状态描述
+     * @param shaders 与 desc 中变体对应的 ShaderModules
+     * @param cache 管线缓存（可为空）
+     */
+    bool Init(VkDevice device, const PipelineStateDesc &desc,
+              const std::vector<VulkanShaderModule *> &shaders,
+              VkPipelineCache cache = VK_NULL_HANDLE);
+
+    /**
+     * @brief 一次 vkCreateGraphicsPipelines 批量创建多个管线
+     * @param pipelines 与 descs 一一对应，创建失败的位置为 nullptr
+     * @return 全部创建成功返回 true
+     */
+    static bool CreateBatch(
+        VkDevice device, VkPipelineCache cache,
+        const std::vector<PipelineStateDesc> &descs,
+        const std::vector<std::vector<VulkanShaderModule *>> &shaders,
+        std::vector<VulkanPipeline *> &pipelines);
+
+    /**
+     * @brief 创建管线库（VK_EXT_graphics_pipeline_library）
+     * @param parts 要编译的部分（VkGraphicsPipelineLibraryFlagBitsEXT）
+     */
+    bool InitLibrary(VkDevice device, const PipelineStateDesc &desc,
+                     const std::vector<VulkanShaderModule *> &shaders,
+                     VkGraphicsPipelineLibraryFlagsEXT parts,
+                     VkPipelineCache cache = VK_NULL_HANDLE);
+
+    /**
+     * @brief 链接管线库得到完整管线
+     * @param libraries 覆盖全部四个部分的管线库
+     * @param optimized false 为快速链接，true 为链接期优化（较慢）
+     */
+    bool InitLinked(VkDevice device, const std::vector<VkPipeline> &libraries,
+                    VkPipelineLayout layout, bool optimized,
+                    VkPipelineCache cache = VK_NULL_HANDLE);
+
+    /**
+     * @brief 替换管线句柄，返回旧句柄（由调用方负责销毁）
+     */
+    VkPipeline Swap(VkPipeline pipeline);
+
     void Destroy();
 
     VkPipeline Get() const
@@ -0,0 +1,138 @@
+﻿#include "VulkanPipelineLibrary.h"
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+namespace
+{
+const VkGraphicsPipelineLibraryFlagBitsEXT LIBRARY_PARTS[] = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+};
+} // namespace
+
+VulkanPipelineLibrary::VulkanPipelineLibrary()
+{
+}
+
+VulkanPipelineLibrary::~VulkanPipelineLibrary()
+{
+    Destroy();
+}
+
+bool VulkanPipelineLibrary::Init(VkDevice device, VkPipelineCache cache)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建管线库缓存失败：逻辑设备为空!");
+        return false;
+    }
+
+    _device = device;
+    _cache = cache;
+    return true;
+}
+
+void VulkanPipelineLibrary::Destroy()
+{
+    for (auto &parts : _parts) {
+        for (auto &[key, part] : parts) {
+            SDelete(part);
+        }
+        parts.clear();
+    }
+}
+
+bool VulkanPipelineLibrary::GetParts(const PipelineStateDesc &desc,
+                                     VulkanShaderModule *vertex,
+                                     VulkanShaderModule *fragment,
+                                     std::vector<VkPipeline> &parts)
+{
+    parts.clear();
+
+    for (uint32_t i = 0; i < PART_COUNT; ++i) {
+        PipelineStateDesc key = partKey(i, desc);
+
+        auto it = _parts[i].find(key);
+        if (it != _parts[i].end()) {
+            parts.push_back(it->second->Get());
+            continue;
+        }
+
+        VulkanPipeline *part = new VulkanPipeline();
+        if (!part->InitLibrary(_device, key, {vertex, fragment},
+                               LIBRARY_PARTS[i], _cache)) {
+            SDelete(part);
+            parts.clear();
+            return false;
+        }
+
+        _parts[i][key] = part;
+        parts.push_back(part->Get());
+    }
+
+    return true;
+}
+
+size_t VulkanPipelineLibrary::GetPartCount() const
+{
+    size_t count = 0;
+    for (const auto &parts : _parts) {
+        count += parts.size();
+    }
+    return count;
+}
+
+PipelineStateDesc VulkanPipelineLibrary::partKey(uint32_t index,
+                                                 const PipelineStateDesc &desc)
+{
+    PipelineStateDesc key{};
+    key.dynamicStates = desc.dynamicStates;
+
+    switch (LIBRARY_PARTS[index]) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        key.drawState.topology = desc.drawState.topology;
+        // 顶点输入布局只取决于是否带逐实例绑定
+        key.vertex.features =
+            desc.vertex.features & SHADER_FEATURE_INSTANCING;
+        break;
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        key.vertex = desc.vertex;
+        key.specConstants = desc.specConstants;
+        key.renderPass = desc.renderPass;
+        key.layout = desc.layout;
+        key.drawState.cullMode = desc.drawState.cullMode;
+        key.drawState.frontFace = desc.drawState.frontFace;
+        key.drawState.polygonMode = desc.drawState.polygonMode;
+        break;
+
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        key.fragment = desc.fragment;
+        key.specConstants = desc.specConstants;
+        key.renderPass = desc.renderPass;
+        key.colorFormat = desc.colorFormat;
+        key.depthFormat = desc.depthFormat;
+        key.layout = desc.layout;
+        key.samples = desc.samples;
+        key.drawState.depthTestEnable = desc.drawState.depthTestEnable;
+        key.drawState.depthWriteEnable = desc.drawState.depthWriteEnable;
+        key.drawState.depthCompareOp = desc.drawState.depthCompareOp;
+        break;
+
+    default:
+        key.renderPass = desc.renderPass;
+        key.colorFormat = desc.colorFormat;
+        key.depthFormat = desc.depthFormat;
+        key.samples = desc.samples;
+        key.blendEnable = desc.blendEnable;
+        break;
+    }
+
+    return key;
+}
+
+} // namespace VKB
@@ -0,0 +1,63 @@
+﻿#ifndef VULKANPIPELINELIBRARY_H_
+#define VULKANPIPELINELIBRARY_H_
+
+#include "VulkanPipeline.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanPipelineLibrary
+ *
+ * 图形管线库缓存（VK_EXT_graphics_pipeline_library）：
+ * - 顶点输入 / 光栅化前 / 片段着色 / 输出接口 四个部分分别编译
+ * - 每个部分只按自己依赖的状态缓存，不同管线之间共享
+ * - 链接由 VulkanPipelineRegistry 负责
+ */
+class VulkanPipelineLibrary
+{
+public:
+    VulkanPipelineLibrary();
+
+    ~VulkanPipelineLibrary();
+
+public:
+    /**
+     * @brief 初始化
+     * @param cache 编译各部分时使用的管线缓存（可为空）
+     */
+    bool Init(VkDevice device, VkPipelineCache cache = VK_NULL_HANDLE);
+
+    void Destroy();
+
+    /**
+     * @brief 获取（或编译）desc 对应的四个管线库部分
+     * @param parts 输出的管线库句柄，可直接用于链接
+     */
+    bool GetParts(const PipelineStateDesc &desc, VulkanShaderModule *vertex,
+                  VulkanShaderModule *fragment, std::vector<VkPipeline> &parts);
+
+    size_t GetPartCount() const;
+
+private:
+    static constexpr uint32_t PART_COUNT = 4;
+
+    /**
+     * @brief 只保留该部分依赖的状态，作为部分缓存键
+     */
+    static PipelineStateDesc partKey(uint32_t index,
+                                     const PipelineStateDesc &desc);
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VkPipelineCache _cache = VK_NULL_HANDLE;
+
+    std::unordered_map<PipelineStateDesc, VulkanPipeline *,
+                       PipelineStateDescHash>
+        _parts[PART_COUNT];
+};
+
+} // namespace VKB
+
+#endif // !VULKANPIPELINELIBRARY_H_
@@ -0,0 +1,143 @@
+﻿#include "VulkanPipelineManifest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "PrintMsg.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 清单文件版本，格式变化时递增，旧清单直接丢弃
+const char *MANIFEST_HEADER = "VKB_PIPELINE_MANIFEST 1";
+
+// 只保留可持久化的部分
+PipelineStateDesc portablePart(const PipelineStateDesc &desc)
+{
+    PipelineStateDesc portable{};
+    portable.vertex = desc.vertex;
+    portable.fragment = desc.fragment;
+    portable.specConstants = desc.specConstants;
+    portable.drawState = desc.drawState;
+    portable.blendEnable = desc.blendEnable;
+    return portable;
+}
+
+void writeKey(std::ostream &out, const ShaderVariantKey &key)
+{
+    out << key.name << ' ' << static_cast<uint32_t>(key.stage) << ' '
+        << key.features << ' ';
+}
+
+bool readKey(std::istream &in, ShaderVariantKey &key)
+{
+    uint32_t stage = 0;
+    if (!(in >> key.name >> stage >> key.features)) {
+        return false;
+    }
+    key.stage = static_cast<VkShaderStageFlagBits>(stage);
+    return true;
+}
+} // namespace
+
+bool VulkanPipelineManifest::Load(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != MANIFEST_HEADER) {
+        PSG::PrintError("管线清单版本不匹配，忽略!");
+        return false;
+    }
+
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+
+        PipelineStateDesc desc{};
+        uint32_t topology, cullMode, frontFace, polygonMode, compareOp;
+        if (!readKey(in, desc.vertex) || !readKey(in, desc.fragment)
+            || !(in >> desc.specConstants.uvScale
+                 >> desc.specConstants.useVertexColor
+                 >> desc.specConstants.useSpecular >> topology >> cullMode
+                 >> frontFace >> polygonMode >> desc.drawState.depthTestEnable
+                 >> desc.drawState.depthWriteEnable >> compareOp
+                 >> desc.blendEnable)) {
+            continue;
+        }
+
+        desc.drawState.topology = static_cast<VkPrimitiveTopology>(topology);
+        desc.drawState.cullMode = cullMode;
+        desc.drawState.frontFace = static_cast<VkFrontFace>(frontFace);
+        desc.drawState.polygonMode = static_cast<VkPolygonMode>(polygonMode);
+        desc.drawState.depthCompareOp = static_cast<VkCompareOp>(compareOp);
+        Add(desc);
+    }
+
+    return true;
+}
+
+bool VulkanPipelineManifest::Save(const std::string &filename) const
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.is_open()) {
+        PSG::PrintError("写入管线清单失败!");
+        return false;
+    }
+
+    // 浮点特化常量需要精确往返，否则读回后缓存键不一致
+    file.precision(std::numeric_limits<float>::max_digits10);
+    file << MANIFEST_HEADER << '\n';
+    for (const auto &desc : _descs) {
+        const DynamicDrawState &state = desc.drawState;
+        writeKey(file, desc.vertex);
+        writeKey(file, desc.fragment);
+        file << desc.specConstants.uvScale << ' '
+             << desc.specConstants.useVertexColor << ' '
+             << desc.specConstants.useSpecular << ' '
+             << static_cast<uint32_t>(state.topology) << ' ' << state.cullMode
+             << ' ' << static_cast<uint32_t>(state.frontFace) << ' '
+             << static_cast<uint32_t>(state.polygonMode) << ' '
+             << state.depthTestEnable << ' ' << state.depthWriteEnable << ' '
+             << static_cast<uint32_t>(state.depthCompareOp) << ' '
+             << desc.blendEnable << '\n';
+    }
+
+    return true;
+}
+
+void VulkanPipelineManifest::Add(const PipelineStateDesc &desc)
+{
+    PipelineStateDesc portable = portablePart(desc);
+    if (std::find(_descs.begin(), _descs.end(), portable) == _descs.end()) {
+        _descs.push_back(portable);
+    }
+}
+
+std::vector<PipelineStateDesc>
+VulkanPipelineManifest::Resolve(const PipelineStateDesc &target) const
+{
+    std::vector<PipelineStateDesc> descs;
+    descs.reserve(_descs.size());
+
+    for (const auto &portable : _descs) {
+        PipelineStateDesc desc = portable;
+        desc.renderPass = target.renderPass;
+        desc.colorFormat = target.colorFormat;
+        desc.depthFormat = target.depthFormat;
+        desc.layout = target.layout;
+        desc.samples = target.samples;
+        desc.dynamicStates = target.dynamicStates;
+        descs.push_back(desc);
+    }
+
+    return descs;
+}
+
+} // namespace VKB
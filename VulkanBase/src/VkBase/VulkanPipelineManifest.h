@@ -0,0 +1,54 @@
+﻿#ifndef VULKANPIPELINEMANIFEST_H_
+#define VULKANPIPELINEMANIFEST_H_
+
+#include "VulkanPipeline.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanPipelineManifest
+ *
+ * 管线清单：记录运行期间用到的 PipelineStateDesc，下次启动时预热
+ * - 只保存着色器变体、特化常量和固定功能状态
+ * - RenderPass / Layout 等句柄与附件格式不写入文件，加载后按当前目标补全
+ */
+class VulkanPipelineManifest
+{
+public:
+    VulkanPipelineManifest() = default;
+
+    ~VulkanPipelineManifest() = default;
+
+public:
+    /**
+     * @brief 读取清单文件（无法解析的行会被跳过）
+     */
+    bool Load(const std::string &filename);
+
+    bool Save(const std::string &filename) const;
+
+    /**
+     * @brief 添加描述（重复的忽略）
+     */
+    void Add(const PipelineStateDesc &desc);
+
+    /**
+     * @brief 用当前渲染目标补全清单中的描述
+     * @param target 提供 renderPass / 格式 / layout / 采样数
+     */
+    std::vector<PipelineStateDesc>
+    Resolve(const PipelineStateDesc &target) const;
+
+    size_t GetCount() const
+    {
+        return _descs.size();
+    }
+
+private:
+    std::vector<PipelineStateDesc> _descs;
+};
+
+} // namespace VKB
+
+#endif // !VULKANPIPELINEMANIFEST_H_
@@ -0,0 +1,348 @@
+﻿#include "VulkanPipelineRegistry.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <unordered_set>
+
+#include "PrintMsg.h"
+#include "VulkanPipelineManifest.h"
+
+namespace VKB
+{
+
+VulkanPipelineRegistry::VulkanPipelineRegistry()
+{
+}
+
+VulkanPipelineRegistry::~VulkanPipelineRegistry()
+{
+    Destroy();
+}
+
+bool VulkanPipelineRegistry::Init(VkDevice device, bool usePipelineLibrary,
+                                  uint32_t framesInFlight,
+                                  const std::string &cacheFile)
+{
+    if (VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建管线注册表失败：逻辑设备为空!");
+        return false;
+    }
+
+    _device = device;
+    _cacheFile = cacheFile;
+    if (!createPipelineCache()) {
+        return false;
+    }
+
+    if (usePipelineLibrary && !_library.Init(device, _pipelineCache)) {
+        return false;
+    }
+
+    _usePipelineLibrary = usePipelineLibrary;
+    _framesInFlight = framesInFlight;
+    return true;
+}
+
+void VulkanPipelineRegistry::Destroy()
+{
+    // 等待后台链接结束，结果直接丢弃
+    for (auto &pending : _pendingLinks) {
+        VulkanPipeline *optimized = pending.result.get();
+        SDelete(optimized);
+    }
+    _pendingLinks.clear();
+
+    for (auto &retired : _retired) {
+        vkDestroyPipeline(_device, retired.pipeline, nullptr);
+    }
+    _retired.clear();
+
+    // 先销毁管线，再销毁管线库和着色器
+    for (auto &[desc, pipeline] : _pipelines) {
+        SDelete(pipeline);
+    }
+    _pipelines.clear();
+
+    _library.Destroy();
+
+    if (_pipelineCache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(_device, _pipelineCache, nullptr);
+        _pipelineCache = VK_NULL_HANDLE;
+    }
+
+    for (auto &[key, shader] : _shaders) {
+        SDelete(shader);
+    }
+    _shaders.clear();
+}
+
+VulkanShaderModule *
+VulkanPipelineRegistry::GetShader(const ShaderVariantKey &key)
+{
+    auto it = _shaders.find(key);
+    if (it != _shaders.end()) {
+        return it->second;
+    }
+
+    VulkanShaderModule *shader = new VulkanShaderModule();
+    if (!shader->Init(_device, key.GetSpirvPath(), key.stage)) {
+        PSG::PrintError("加载着色器变体失败!");
+        SDelete(shader);
+        return nullptr;
+    }
+
+    _shaders[key] = shader;
+    return shader;
+}
+
+VulkanPipeline *
+VulkanPipelineRegistry::GetPipeline(const PipelineStateDesc &desc)
+{
+    PipelineStateDesc key = makeKey(desc);
+
+    auto it = _pipelines.find(key);
+    if (it != _pipelines.end()) {
+        return it->second;
+    }
+
+    VulkanShaderModule *vertex = GetShader(key.vertex);
+    VulkanShaderModule *fragment = GetShader(key.fragment);
+    if (!vertex || !fragment) {
+        return nullptr;
+    }
+
+    VulkanPipeline *pipeline = _usePipelineLibrary
+                                   ? linkPipeline(key, vertex, fragment)
+                                   : createPipeline(key, vertex, fragment);
+    if (!pipeline) {
+        return nullptr;
+    }
+
+    _pipelines[key] = pipeline;
+    return pipeline;
+}
+
+size_t VulkanPipelineRegistry::WarmUp(
+    const std::vector<PipelineStateDesc> &descs, uint32_t threadCount)
+{
+    // 去重并跳过已有管线；ShaderModule 缓存不是线程安全的，先在这里加载
+    std::vector<PipelineStateDesc> keys;
+    std::vector<std::vector<VulkanShaderModule *>> shaders;
+    std::unordered_set<PipelineStateDesc, PipelineStateDescHash> pending;
+    for (const auto &desc : descs) {
+        PipelineStateDesc key = makeKey(desc);
+        if (_pipelines.count(key) || !pending.insert(key).second) {
+            continue;
+        }
+
+        VulkanShaderModule *vertex = GetShader(key.vertex);
+        VulkanShaderModule *fragment = GetShader(key.fragment);
+        if (!vertex || !fragment) {
+            continue;
+        }
+
+        keys.push_back(key);
+        shaders.push_back({vertex, fragment});
+    }
+
+    if (keys.empty()) {
+        return 0;
+    }
+
+    if (0 == threadCount) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, static_cast<uint32_t>(keys.size()));
+
+    // 按线程均分，每个线程一次批量创建
+    const size_t batchSize = (keys.size() + threadCount - 1) / threadCount;
+    std::vector<std::vector<VulkanPipeline *>> results(threadCount);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        const size_t begin = t * batchSize;
+        const size_t end = std::min(begin + batchSize, keys.size());
+        if (begin >= end) {
+            break;
+        }
+
+        workers.emplace_back([this, &keys, &shaders, &results, t, begin,
+                              end]() {
+            std::vector<PipelineStateDesc> batch(keys.begin() + begin,
+                                                 keys.begin() + end);
+            std::vector<std::vector<VulkanShaderModule *>> batchShaders(
+                shaders.begin() + begin, shaders.begin() + end);
+            VulkanPipeline::CreateBatch(_device, _pipelineCache, batch,
+                                        batchShaders, results[t]);
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // 结果统一在调用线程登记
+    size_t created = 0;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        for (size_t i = 0; i < results[t].size(); ++i) {
+            if (results[t][i]) {
+                _pipelines[keys[t * batchSize + i]] = results[t][i];
+                ++created;
+            }
+        }
+    }
+
+    return created;
+}
+
+bool VulkanPipelineRegistry::SavePipelineCache() const
+{
+    if (_cacheFile.empty() || VK_NULL_HANDLE == _pipelineCache) {
+        return false;
+    }
+
+    size_t size = 0;
+    vkGetPipelineCacheData(_device, _pipelineCache, &size, nullptr);
+    std::vector<char> data(size);
+    if (0 == size
+        || vkGetPipelineCacheData(_device, _pipelineCache, &size, data.data())
+               != VK_SUCCESS) {
+        PSG::PrintError("获取管线缓存数据失败!");
+        return false;
+    }
+
+    std::ofstream file(_cacheFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        PSG::PrintError("写入管线缓存文件失败!");
+        return false;
+    }
+    file.write(data.data(), static_cast<std::streamsize>(size));
+    return true;
+}
+
+bool VulkanPipelineRegistry::SaveManifest(const std::string &filename) const
+{
+    VulkanPipelineManifest manifest;
+    for (const auto &[key, pipeline] : _pipelines) {
+        manifest.Add(key);
+    }
+    return manifest.Save(filename);
+}
+
+void VulkanPipelineRegistry::Update()
+{
+    // 已经过 framesInFlight 帧的旧管线不再被任何命令缓冲引用
+    for (auto it = _retired.begin(); it != _retired.end();) {
+        if (--it->framesLeft == 0) {
+            vkDestroyPipeline(_device, it->pipeline, nullptr);
+            it = _retired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = _pendingLinks.begin(); it != _pendingLinks.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0))
+            != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        // 优化链接失败时继续使用快速链接的管线
+        VulkanPipeline *optimized = it->result.get();
+        if (optimized) {
+            VkPipeline old = it->target->Swap(optimized->Swap(VK_NULL_HANDLE));
+            _retired.push_back({old, _framesInFlight});
+            SDelete(optimized);
+        }
+
+        it = _pendingLinks.erase(it);
+    }
+}
+
+PipelineStateDesc
+VulkanPipelineRegistry::makeKey(const PipelineStateDesc &desc) const
+{
+    // 动态部分不参与缓存键
+    PipelineStateDesc stateDesc = desc;
+    stateDesc.dynamicStates = _dynamicStates;
+    return stateDesc.CacheKey();
+}
+
+bool VulkanPipelineRegistry::createPipelineCache()
+{
+    // 不兼容的缓存数据（驱动 / 设备变化）会被驱动忽略
+    std::vector<char> data;
+    if (!_cacheFile.empty()) {
+        std::ifstream file(_cacheFile, std::ios::ate | std::ios::binary);
+        if (file.is_open()) {
+            data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(_device, &cacheInfo, nullptr, &_pipelineCache)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建管线缓存失败!");
+        return false;
+    }
+    return true;
+}
+
+VulkanPipeline *
+VulkanPipelineRegistry::createPipeline(const PipelineStateDesc &key,
+                                       VulkanShaderModule *vertex,
+                                       VulkanShaderModule *fragment)
+{
+    VulkanPipeline *pipeline = new VulkanPipeline();
+    if (!pipeline->Init(_device, key, {vertex, fragment}, _pipelineCache)) {
+        SDelete(pipeline);
+        return nullptr;
+    }
+    return pipeline;
+}
+
+VulkanPipeline *
+VulkanPipelineRegistry::linkPipeline(const PipelineStateDesc &key,
+                                     VulkanShaderModule *vertex,
+                                     VulkanShaderModule *fragment)
+{
+    std::vector<VkPipeline> parts;
+    if (!_library.GetParts(key, vertex, fragment, parts)) {
+        return nullptr;
+    }
+
+    // 快速链接：几乎不耗时，当前帧即可使用
+    VulkanPipeline *pipeline = new VulkanPipeline();
+    if (!pipeline->InitLinked(_device, parts, key.layout, false,
+                              _pipelineCache)) {
+        SDelete(pipeline);
+        return nullptr;
+    }
+
+    // 优化链接放到后台，完成后在 Update 中替换
+    VkDevice device = _device;
+    VkPipelineCache cache = _pipelineCache;
+    VkPipelineLayout layout = key.layout;
+    PendingLink pending;
+    pending.target = pipeline;
+    pending.result =
+        std::async(std::launch::async, [device, cache, parts, layout]() {
+            VulkanPipeline *optimized = new VulkanPipeline();
+            if (!optimized->InitLinked(device, parts, layout, true, cache)) {
+                SDelete(optimized);
+            }
+            return optimized;
+        });
+    _pendingLinks.push_back(std::move(pending));
+
+    return pipeline;
+}
+
+} // namespace VKB
@@ -0,0 +1,174 @@
+﻿#ifndef VULKANPIPELINEREGISTRY_H_
+#define VULKANPIPELINEREGISTRY_H_
+
+#include <future>
+
+#include "VulkanPipeline.h"
+#include "VulkanPipelineLibrary.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanPipelineRegistry
+ *
+ * 管线注册表：
+ * - 按 ShaderVariantKey 缓存 ShaderModule（只加载场景用到的排列）
+ * - 按 PipelineStateDesc 缓存 VulkanPipeline
+ * - 注册表持有全部 Shader / Pipeline，调用方只保存裸指针
+ * - 启用管线库时先快速链接立即可用，后台再做优化链接，Update 中替换
+ * - 所有管线共用一个 VkPipelineCache（驱动内部同步），可持久化到文件
+ */
+class VulkanPipelineRegistry
+{
+public:
+    VulkanPipelineRegistry();
+
+    ~VulkanPipelineRegistry();
+
+public:
+    /**
+     * @brief 初始化
+     * @param usePipelineLibrary 是否使用管线库（设备不支持时传 false）
+     * @param framesInFlight 被替换的旧管线延迟销毁的帧数
+     * @param cacheFile 管线缓存文件，存在时用作初始数据（可为空）
+     */
+    bool Init(VkDevice device, bool usePipelineLibrary = false,
+              uint32_t framesInFlight = 2,
+              const std::string &cacheFile = std::string());
+
+    void Destroy();
+
+    /**
+     * @brief 获取（或加载）着色器变体
+     * @return 失败返回 nullptr
+     */
+    VulkanShaderModule *GetShader(const ShaderVariantKey &key);
+
+    /**
+     * @brief 获取（或创建）管线
+     *
+     * desc.dynamicStates 会被注册表的动态状态模式覆盖，
+     * 动态部分不同的描述共用同一管线
+     * @return 失败返回 nullptr
+     */
+    VulkanPipeline *GetPipeline(const PipelineStateDesc &desc);
+
+    /**
+     * @brief 启动预热：多线程并行创建一组管线
+     *
+     * 每个线程用一次 vkCreateGraphicsPipelines 批量创建自己那一份，
+     * 着色器在调用线程中预先加载
+     * @param threadCount 线程数，0 表示使用全部硬件线程
+     * @return 新创建的管线数量
+     */
+    size_t WarmUp(const std::vector<PipelineStateDesc> &descs,
+                  uint32_t threadCount = 0);
+
+    /**
+     * @brief 把缓存数据写回 Init 时指定的文件
+     */
+    bool SavePipelineCache() const;
+
+    /**
+     * @brief 把已创建的管线写入清单，供下次启动预热
+     */
+    bool SaveManifest(const std::string &filename) const;
+
+    /**
+     * @brief 每帧调用（等待帧栅栏之后）
+     *
+     * 用完成的优化链接替换快速链接的管线，并销毁不再使用的旧管线
+     */
+    void Update();
+
+    bool IsUsingPipelineLibrary() const
+    {
+        return _usePipelineLibrary;
+    }
+
+    /**
+     * @brief 设置动态状态模式（DynamicStateBits）
+     */
+    void SetDynamicStates(uint32_t dynamicStates)
+    {
+        _dynamicStates = dynamicStates;
+    }
+
+    uint32_t GetDynamicStates() const
+    {
+        return _dynamicStates;
+    }
+
+    size_t GetShaderCount() const
+    {
+        return _shaders.size();
+    }
+
+    size_t GetPipelineCount() const
+    {
+        return _pipelines.size();
+    }
+
+private:
+    /**
+     * @brief 归一化管线描述，动态部分不参与缓存键
+     */
+    PipelineStateDesc makeKey(const PipelineStateDesc &desc) const;
+
+    bool createPipelineCache();
+
+    VulkanPipeline *createPipeline(const PipelineStateDesc &key,
+                                   VulkanShaderModule *vertex,
+                                   VulkanShaderModule *fragment);
+
+    VulkanPipeline *linkPipeline(const PipelineStateDesc &key,
+                                 VulkanShaderModule *vertex,
+                                 VulkanShaderModule *fragment);
+
+private:
+    // 后台优化链接任务
+    struct PendingLink
+    {
+        VulkanPipeline *target = nullptr;
+        std::future<VulkanPipeline *> result;
+    };
+
+    // 等待销毁的旧管线句柄
+    struct RetiredPipeline
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        uint32_t framesLeft = 0;
+    };
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    bool _usePipelineLibrary = false;
+
+    uint32_t _framesInFlight = 2;
+
+    VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+
+    std::string _cacheFile;
+
+    VulkanPipelineLibrary _library;
+
+    std::vector<PendingLink> _pendingLinks;
+
+    std::vector<RetiredPipeline> _retired;
+
+    uint32_t _dynamicStates = DYNAMIC_STATE_NONE;
+
+    std::unordered_map<ShaderVariantKey, VulkanShaderModule *,
+                       ShaderVariantKeyHash>
+        _shaders;
+
+    std::unordered_map<PipelineStateDesc, VulkanPipeline *,
+                       PipelineStateDescHash>
+        _pipelines;
+};
+
+} // namespace VKB
+
+#endif // !VULKANPIPELINEREGISTRY_H_
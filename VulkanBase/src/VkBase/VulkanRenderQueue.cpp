@@ -0,0 +1,372 @@
+﻿#include "VulkanRenderQueue.h"
+#include "VulkanUtils.h"
+
+#include <algorithm>
+#include <array>
+
+namespace VKB
+{
+
+namespace
+{
+// 每趟排序处理的位数
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+constexpr uint64_t RADIX_MASK = RADIX_SIZE - 1;
+
+constexpr uint64_t fieldMask(uint32_t bits)
+{
+    return (1ull << bits) - 1;
+}
+} // namespace
+
+VulkanRenderQueue::VulkanRenderQueue()
+{
+}
+
+VulkanRenderQueue::~VulkanRenderQueue()
+{
+}
+
+uint64_t VulkanRenderQueue::MakeSortKey(uint32_t pass, bool transparent,
+                                        uint32_t pipelineId,
+                                        uint32_t materialId, float depth)
+{
+    const uint64_t depthMax = fieldMask(DEPTH_BITS);
+    uint64_t depthBucket = static_cast<uint64_t>(
+        std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(depthMax));
+    depthBucket = std::min(depthBucket, depthMax);
+
+    const uint64_t pipeline = pipelineId & fieldMask(PIPELINE_BITS);
+    const uint64_t material = materialId & fieldMask(MATERIAL_BITS);
+
+    // 最高位：Pass，其次：半透明标记（不透明先画）
+    uint64_t key = static_cast<uint64_t>(pass & fieldMask(PASS_BITS)) << 60;
+    key |= static_cast<uint64_t>(transparent ? 1 : 0) << 59;
+
+    if (transparent) {
+        // 深度优先，由远到近
+        key |= (depthMax - depthBucket) << 35;
+        key |= pipeline << 19;
+        key |= material << 3;
+    } else {
+        // 状态优先，相同状态内由近到远
+        key |= pipeline << 43;
+        key |= material << 27;
+        key |= depthBucket << 3;
+    }
+
+    return key;
+}
+
+void VulkanRenderQueue::Clear()
+{
+    _packets.clear();
+    _entries.clear();
+    _batches.clear();
+    _instances.clear();
+    _objects.clear();
+    _objectBuffer = false;
+    _instanceBuffer = VK_NULL_HANDLE;
+    _bindlessSet = VK_NULL_HANDLE;
+    _keyOr = 0;
+    _keyAnd = ~0ull;
+}
+
+void VulkanRenderQueue::Submit(const DrawPacket &packet, uint32_t pass,
+                               bool transparent, float depth)
+{
+    const uint32_t pipelineId =
+        compactId(_pipelineIds, packet.pipeline, PIPELINE_BITS);
+    const uint32_t materialId =
+        compactId(_materialIds, packet.descriptorSet, MATERIAL_BITS);
+
+    SortEntry entry{};
+    entry.key =
+        MakeSortKey(pass, transparent, pipelineId, materialId, depth);
+    entry.index = static_cast<uint32_t>(_packets.size());
+
+    _keyOr |= entry.key;
+    _keyAnd &= entry.key;
+
+    _packets.push_back(packet);
+    _entries.push_back(entry);
+}
+
+void VulkanRenderQueue::Sort(uint32_t threadCount, bool instancing,
+                             bool objectBuffer)
+{
+    _submitStats = countBinds(false);
+
+    if (_entries.size() > 1) {
+        radixSort(threadCount);
+    }
+
+    buildBatches(instancing, objectBuffer);
+
+    _sortedStats = countBinds(true);
+}
+
+size_t VulkanRenderQueue::Hash() const
+{
+    size_t seed = 0;
+    HashCombine(seed, _instanceBuffer);
+    HashCombine(seed, _objectBuffer);
+    HashCombine(seed, _bindlessSet);
+
+    for (const DrawBatch &batch : _batches) {
+        const DrawPacket &packet = Get(batch.first);
+
+        HashCombine(seed, batch.count);
+        HashCombine(seed, batch.firstInstance);
+        HashCombine(seed, batch.instanced);
+        HashCombine(seed, batch.instanced ? packet.instancedPipeline
+                                          : packet.pipeline);
+        HashCombine(seed, packet.descriptorSet);
+        HashCombine(seed, packet.vertexBuffer);
+        HashCombine(seed, packet.indexBuffer);
+        HashCombine(seed, packet.firstIndex);
+        HashCombine(seed, packet.indexCount);
+        HashCombine(seed, packet.drawState.Hash());
+
+        // 实例化批次 / 逐物体缓冲的数据在缓冲中逐帧更新
+        if (batch.instanced || _objectBuffer) {
+            continue;
+        }
+
+        const PushObject &object = packet.pushObject;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                HashCombine(seed, object.model[column][row]);
+            }
+        }
+        HashCombine(seed, object.color.x);
+        HashCombine(seed, object.color.y);
+        HashCombine(seed, object.color.z);
+        HashCombine(seed, object.textureIndex);
+    }
+
+    return seed;
+}
+
+template <typename Handle>
+uint32_t
+VulkanRenderQueue::compactId(std::unordered_map<Handle, uint32_t> &ids,
+                             Handle handle, uint32_t bits)
+{
+    auto it = ids.find(handle);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    // 编号用尽时重新分配（只影响排序效果，不影响正确性）
+    if (ids.size() > fieldMask(bits)) {
+        ids.clear();
+    }
+
+    const uint32_t id = static_cast<uint32_t>(ids.size());
+    ids.emplace(handle, id);
+    return id;
+}
+
+void VulkanRenderQueue::radixSort(uint32_t threadCount)
+{
+    const size_t count = _entries.size();
+
+    // 所有键在该字节上都相同时跳过这一趟
+    const uint64_t varying = _keyOr ^ _keyAnd;
+    std::vector<uint32_t> shifts;
+    for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS) {
+        if ((varying >> shift) & RADIX_MASK) {
+            shifts.push_back(shift);
+        }
+    }
+    if (shifts.empty()) {
+        return;
+    }
+
+    if (count < PARALLEL_SORT_THRESHOLD || nullptr == _jobSystem) {
+        threadCount = 1;
+    } else if (0 == threadCount) {
+        threadCount = _jobSystem->GetConcurrency();
+    }
+
+    _scratch.resize(count);
+
+    // 每段连续，段内计数后换算为全局写入位置
+    const size_t chunk = (count + threadCount - 1) / threadCount;
+    std::vector<std::array<size_t, RADIX_SIZE>> offsets(threadCount);
+
+    SortEntry *src = _entries.data();
+    SortEntry *dst = _scratch.data();
+
+    // 按 (桶, 段) 顺序做前缀和，保证排序稳定
+    auto prefixSum = [&]() {
+        size_t sum = 0;
+        for (uint32_t digit = 0; digit < RADIX_SIZE; ++digit) {
+            for (auto &histogram : offsets) {
+                const size_t bucket = histogram[digit];
+                histogram[digit] = sum;
+                sum += bucket;
+            }
+        }
+    };
+
+    // 每一趟分两个阶段：各段计数 -> 前缀和 -> 各段分发，阶段之间等待
+    auto runSlices = [&](const std::function<void(uint32_t)> &work) {
+        if (1 == threadCount) {
+            work(0);
+            return;
+        }
+
+        PSG::JobCounter counter;
+        _jobSystem->ParallelFor(
+            threadCount, threadCount,
+            [&work](uint32_t begin, uint32_t end) {
+                for (uint32_t t = begin; t < end; ++t) {
+                    work(t);
+                }
+            },
+            counter);
+        _jobSystem->Wait(counter);
+    };
+
+    for (uint32_t shift : shifts) {
+        runSlices([&](uint32_t t) {
+            const size_t begin = std::min(count, t * chunk);
+            const size_t end = std::min(count, begin + chunk);
+            auto &histogram = offsets[t];
+
+            histogram.fill(0);
+            for (size_t i = begin; i < end; ++i) {
+                ++histogram[(src[i].key >> shift) & RADIX_MASK];
+            }
+        });
+
+        prefixSum();
+
+        runSlices([&](uint32_t t) {
+            const size_t begin = std::min(count, t * chunk);
+            const size_t end = std::min(count, begin + chunk);
+            auto &histogram = offsets[t];
+
+            for (size_t i = begin; i < end; ++i) {
+                dst[histogram[(src[i].key >> shift) & RADIX_MASK]++] = src[i];
+            }
+        });
+
+        std::swap(src, dst);
+    }
+
+    // 奇数趟时结果在交替缓冲中
+    if (src != _entries.data()) {
+        _entries.swap(_scratch);
+    }
+}
+
+void VulkanRenderQueue::buildBatches(bool instancing, bool objectBuffer)
+{
+    _batches.clear();
+    _instances.clear();
+    _objects.clear();
+    _objectBuffer = objectBuffer;
+
+    const size_t count = _entries.size();
+    size_t i = 0;
+    while (i < count) {
+        const DrawPacket &head = Get(i);
+
+        // 排序键已把相同管线 / 材质排在一起，只需向后扫描
+        size_t end = i + 1;
+        if (objectBuffer
+            || (instancing && VK_NULL_HANDLE != head.instancedPipeline)) {
+            while (end < count && canMerge(head, Get(end))) {
+                ++end;
+            }
+        }
+
+        DrawBatch batch{};
+        batch.first = static_cast<uint32_t>(i);
+        batch.count = static_cast<uint32_t>(end - i);
+
+        // 逐物体缓冲：所有批次（包括单个 Draw）都按 firstInstance 寻址，
+        // 管线不变，不需要实例化变体
+        if (objectBuffer) {
+            batch.firstInstance = static_cast<uint32_t>(_objects.size());
+            for (size_t j = i; j < end; ++j) {
+                const PushObject &object = Get(j).pushObject;
+                _objects.push_back({object.model, PTF_4D(object.color, 1.0f),
+                                    object.textureIndex});
+            }
+
+            _batches.push_back(batch);
+            i = end;
+            continue;
+        }
+
+        batch.instanced = batch.count > 1;
+
+        if (batch.instanced) {
+            batch.firstInstance = static_cast<uint32_t>(_instances.size());
+            for (size_t j = i; j < end; ++j) {
+                const PushObject &object = Get(j).pushObject;
+                _instances.push_back(
+                    {object.model, object.color, object.textureIndex});
+            }
+        }
+
+        _batches.push_back(batch);
+        i = end;
+    }
+}
+
+bool VulkanRenderQueue::canMerge(const DrawPacket &a, const DrawPacket &b)
+{
+    return a.pipeline == b.pipeline
+           && a.instancedPipeline == b.instancedPipeline
+           && a.descriptorSet == b.descriptorSet
+           && a.vertexBuffer == b.vertexBuffer
+           && a.indexBuffer == b.indexBuffer && a.firstIndex == b.firstIndex
+           && a.indexCount == b.indexCount
+           && a.drawState == b.drawState;
+}
+
+RenderQueueStats VulkanRenderQueue::countBinds(bool sorted) const
+{
+    RenderQueueStats stats{};
+    stats.drawCount = static_cast<uint32_t>(_packets.size());
+
+    // 排序后按批次统计，提交顺序下每个 Draw 一次调用
+    const size_t calls = sorted ? _batches.size() : _packets.size();
+    stats.drawCalls = static_cast<uint32_t>(calls);
+
+    const DrawPacket *previous = nullptr;
+    VkPipeline previousPipeline = VK_NULL_HANDLE;
+    for (size_t i = 0; i < calls; ++i) {
+        const DrawBatch *batch = sorted ? &_batches[i] : nullptr;
+        const DrawPacket &packet =
+            sorted ? Get(batch->first) : _packets[i];
+        const VkPipeline pipeline = batch && batch->instanced
+                                        ? packet.instancedPipeline
+                                        : packet.pipeline;
+
+        if (!previous || pipeline != previousPipeline) {
+            ++stats.pipelineBinds;
+        }
+        previousPipeline = pipeline;
+        if (!previous || packet.descriptorSet != previous->descriptorSet) {
+            ++stats.descriptorBinds;
+        }
+        if (!previous || packet.vertexBuffer != previous->vertexBuffer) {
+            ++stats.vertexBufferBinds;
+        }
+        if (!previous || packet.indexBuffer != previous->indexBuffer) {
+            ++stats.indexBufferBinds;
+        }
+        previous = &packet;
+    }
+
+    return stats;
+}
+
+} // namespace VKB
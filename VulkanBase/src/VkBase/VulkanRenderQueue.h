@@ -0,0 +1,279 @@
+﻿#ifndef VULKANRENDERQUEUE_H_
+#define VULKANRENDERQUEUE_H_
+
+#include <unordered_map>
+
+#include "JobSystem.h"
+#include "VulkanDynamicState.h"
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief 一次 Draw 所需的全部状态
+ *
+ * 同一队列中的 Draw 共用一个 PipelineLayout
+ */
+struct DrawPacket
+{
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    // 同一管线的实例化版本（SHADER_FEATURE_INSTANCING），为空时不参与合并
+    VkPipeline instancedPipeline = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+
+    // 多级 LOD 共用一个索引缓冲，按 [firstIndex, firstIndex + indexCount) 绘制
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+
+    PushObject pushObject{};
+    DynamicDrawState drawState;
+};
+
+/**
+ * @brief 排序后相邻的一段 Draw，录制为一次绘制调用
+ *
+ * instanced 为 true 时这段 Draw 网格、材质、状态完全相同，
+ * 逐物体数据在实例数组 [firstInstance, firstInstance + count) 中
+ */
+struct DrawBatch
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+    uint32_t firstInstance = 0;
+    bool instanced = false;
+};
+
+/**
+ * @brief 按某个顺序录制时的绑定次数
+ */
+struct RenderQueueStats
+{
+    uint32_t drawCount = 0;
+    uint32_t drawCalls = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorBinds = 0;
+    uint32_t vertexBufferBinds = 0;
+    uint32_t indexBufferBinds = 0;
+
+    bool operator==(const RenderQueueStats &other) const = default;
+};
+
+/**
+ * @brief VulkanRenderQueue
+ *
+ * 基于 64 位排序键的渲染队列：
+ * - 提交时生成排序键，Sort 用并行基数排序（LSD，每趟 8 位）
+ * - 不透明：Pass | 0 | 管线 | 材质 | 深度（由近到远，减少 overdraw）
+ * - 半透明：Pass | 1 | 反转深度（由远到近，保证混合正确）| 管线 | 材质
+ * - 排序只移动 (键, 下标)，DrawPacket 本身不搬动
+ * - 排序后相邻且可合并的 Draw 组成实例化批次
+ * - 逐物体缓冲模式下全部物体数据按排序顺序排列，批次按 firstInstance 寻址
+ * - 每帧 Clear 后重新提交，内部缓冲跨帧复用
+ */
+class VulkanRenderQueue
+{
+public:
+    VulkanRenderQueue();
+
+    ~VulkanRenderQueue();
+
+public:
+    static constexpr uint32_t PASS_BITS = 4;
+    static constexpr uint32_t PIPELINE_BITS = 16;
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    static constexpr uint32_t DEPTH_BITS = 24;
+
+    /**
+     * @brief 生成排序键
+     * @param pass 渲染 Pass 序号（< 2^PASS_BITS）
+     * @param transparent 是否半透明
+     * @param depth 归一化的视空间深度 [0, 1]，越小越近
+     */
+    static uint64_t MakeSortKey(uint32_t pass, bool transparent,
+                                uint32_t pipelineId, uint32_t materialId,
+                                float depth);
+
+    /**
+     * @brief 清空本帧的 Draw（管线 / 材质编号保留）
+     */
+    void Clear();
+
+    /**
+     * @brief 提交一个 Draw
+     *
+     * 管线、材质（DescriptorSet）按句柄分配紧凑编号后写入排序键
+     */
+    void Submit(const DrawPacket &packet, uint32_t pass, bool transparent,
+                float depth);
+
+    /**
+     * @brief 排序、生成批次并统计排序前后的绑定次数
+     * @param threadCount 并行分段数，0 表示调度器的并发线程数
+     * @param instancing 是否把相同网格 / 材质的 Draw 合并为实例化绘制
+     * @param objectBuffer 逐物体数据写入存储缓冲（代替 Push Constant，
+     *                     可合并的 Draw 同样合并，优先于 instancing）
+     */
+    void Sort(uint32_t threadCount = 0, bool instancing = false,
+              bool objectBuffer = false);
+
+    /**
+     * @brief 设置并行排序使用的调度器（为空时单线程排序）
+     */
+    void SetJobSystem(PSG::JobSystem *jobSystem)
+    {
+        _jobSystem = jobSystem;
+    }
+
+    size_t GetCount() const
+    {
+        return _entries.size();
+    }
+
+    /**
+     * @brief 排序后第 i 个 Draw
+     */
+    const DrawPacket &Get(size_t i) const
+    {
+        return _packets[_entries[i].index];
+    }
+
+    size_t GetBatchCount() const
+    {
+        return _batches.size();
+    }
+
+    const DrawBatch &GetBatch(size_t i) const
+    {
+        return _batches[i];
+    }
+
+    /// 实例化批次的逐实例数据，需上传到实例缓冲后才能录制
+    const std::vector<InstanceData> &GetInstances() const
+    {
+        return _instances;
+    }
+
+    /// 逐物体缓冲模式下全部 Draw 的数据（按排序顺序），需上传后才能录制
+    const std::vector<ObjectData> &GetObjects() const
+    {
+        return _objects;
+    }
+
+    /// 最近一次排序是否为逐物体缓冲模式（录制时不再使用 Push Constant）
+    bool UsesObjectBuffer() const
+    {
+        return _objectBuffer;
+    }
+
+    /// 本帧实例数据所在的顶点缓冲（绑定 1）
+    void SetInstanceBuffer(VkBuffer buffer)
+    {
+        _instanceBuffer = buffer;
+    }
+
+    VkBuffer GetInstanceBuffer() const
+    {
+        return _instanceBuffer;
+    }
+
+    /// 本帧使用的 Bindless 纹理表（集合 1），为空表示不使用
+    void SetBindlessSet(VkDescriptorSet set)
+    {
+        _bindlessSet = set;
+    }
+
+    VkDescriptorSet GetBindlessSet() const
+    {
+        return _bindlessSet;
+    }
+
+    /**
+     * @brief 排序后录制内容的哈希（用于判断缓存的命令缓冲是否失效）
+     *
+     * 包含批次划分、管线、材质、缓冲、绘制状态与 Push Constant，
+     * 实例数据在缓冲中逐帧更新，不参与哈希
+     */
+    size_t Hash() const;
+
+    /// 按提交顺序录制时的绑定次数
+    const RenderQueueStats &GetSubmitStats() const
+    {
+        return _submitStats;
+    }
+
+    /// 按排序结果录制时的绑定次数
+    const RenderQueueStats &GetSortedStats() const
+    {
+        return _sortedStats;
+    }
+
+private:
+    // Draw 数量低于此值时单线程排序
+    static constexpr size_t PARALLEL_SORT_THRESHOLD = 4096;
+
+    struct SortEntry
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;
+    };
+
+    template <typename Handle>
+    static uint32_t compactId(std::unordered_map<Handle, uint32_t> &ids,
+                              Handle handle, uint32_t bits);
+
+    void radixSort(uint32_t threadCount);
+
+    void buildBatches(bool instancing, bool objectBuffer);
+
+    /// 两个 Draw 能否合并为同一次实例化绘制
+    static bool canMerge(const DrawPacket &a, const DrawPacket &b);
+
+    /**
+     * @brief 模拟录制，统计绑定次数
+     * @param sorted true 按排序结果，false 按提交顺序
+     */
+    RenderQueueStats countBinds(bool sorted) const;
+
+private:
+    std::vector<DrawPacket> _packets;
+
+    std::vector<SortEntry> _entries;
+
+    // 基数排序的交替缓冲
+    std::vector<SortEntry> _scratch;
+
+    std::vector<DrawBatch> _batches;
+
+    std::vector<InstanceData> _instances;
+
+    std::vector<ObjectData> _objects;
+
+    bool _objectBuffer = false;
+
+    VkBuffer _instanceBuffer = VK_NULL_HANDLE;
+
+    VkDescriptorSet _bindlessSet = VK_NULL_HANDLE;
+
+    // 所有键的按位或 / 按位与，二者相同的字节不需要排序
+    uint64_t _keyOr = 0;
+    uint64_t _keyAnd = ~0ull;
+
+    std::unordered_map<VkPipeline, uint32_t> _pipelineIds;
+
+    std::unordered_map<VkDescriptorSet, uint32_t> _materialIds;
+
+    RenderQueueStats _submitStats;
+
+    RenderQueueStats _sortedStats;
+
+    PSG::JobSystem *_jobSystem = nullptr;
+};
+
+} // namespace VKB
+
+#endif // !VULKANRENDERQUEUE_H_
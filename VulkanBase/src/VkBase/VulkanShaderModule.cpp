@@ -56,13 +56,15 @@ void VulkanShaderModule::Destroy()
     _code.clear();
 }
 
-VkPipelineShaderStageCreateInfo VulkanShaderModule::GetStageInfo() const
+VkPipelineShaderStageCreateInfo
+VulkanShaderModule::GetStageInfo(const VkSpecializationInfo *specInfo) const
 {
     VkPipelineShaderStageCreateInfo stageInfo{};
     stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     stageInfo.stage = _stage;
     stageInfo.module = _shaderModule;
     stageInfo.pName = "main"; // Shader 入口函数
+    stageInfo.pSpecializationInfo = specInfo;
 
     return stageInfo;
 }
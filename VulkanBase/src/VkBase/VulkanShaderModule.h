@@ -41,8 +41,17 @@ public:
         return _shaderModule;
     }
 
-    /// 获取 Pipeline 使用的 ShaderStage 信息
-    VkPipelineShaderStageCreateInfo GetStageInfo() const;
+    /**
+     * @brief 获取 Pipeline 使用的 ShaderStage 信息
+     * @param specInfo 特化常量信息（可选，需在创建管线期间保持有效）
+     */
+    VkPipelineShaderStageCreateInfo
+    GetStageInfo(const VkSpecializationInfo *specInfo = nullptr) const;
+
+    VkShaderStageFlagBits GetStage() const
+    {
+        return _stage;
+    }
 
 private:
     bool loadFile(const std::string &filename);
@@ -0,0 +1,70 @@
+﻿#include "VulkanShaderVariant.h"
+
+#include <cstddef>
+
+#include "VulkanUtils.h"
+
+namespace VKB
+{
+
+namespace
+{
+// 特化常量映射表（constant_id -> ShaderSpecConstants 成员）
+const VkSpecializationMapEntry SPEC_MAP_ENTRIES[] = {
+    {0, offsetof(ShaderSpecConstants, uvScale), sizeof(float)},
+    {1, offsetof(ShaderSpecConstants, useVertexColor), sizeof(uint32_t)},
+    {2, offsetof(ShaderSpecConstants, useSpecular), sizeof(uint32_t)},
+};
+
+const char *stageSuffix(VkShaderStageFlagBits stage)
+{
+    switch (stage) {
+    case VK_SHADER_STAGE_VERTEX_BIT:
+        return "vert";
+    case VK_SHADER_STAGE_FRAGMENT_BIT:
+        return "frag";
+    case VK_SHADER_STAGE_COMPUTE_BIT:
+        return "comp";
+    default:
+        return "unknown";
+    }
+}
+} // namespace
+
+size_t ShaderSpecConstants::Hash() const
+{
+    size_t seed = 0;
+    HashCombine(seed, uvScale);
+    HashCombine(seed, useVertexColor);
+    HashCombine(seed, useSpecular);
+    return seed;
+}
+
+VkSpecializationInfo ShaderSpecConstants::GetInfo() const
+{
+    // 未在着色器中声明的 constant_id 会被驱动忽略，
+    // 所以所有阶段可以共用同一份映射表
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(std::size(SPEC_MAP_ENTRIES));
+    info.pMapEntries = SPEC_MAP_ENTRIES;
+    info.dataSize = sizeof(ShaderSpecConstants);
+    info.pData = this;
+    return info;
+}
+
+size_t ShaderVariantKey::Hash() const
+{
+    size_t seed = 0;
+    HashCombine(seed, name);
+    HashCombine(seed, static_cast<uint32_t>(stage));
+    HashCombine(seed, features);
+    return seed;
+}
+
+std::string ShaderVariantKey::GetSpirvPath() const
+{
+    return "Res\\Shaders\\Uber\\" + name + "_" + stageSuffix(stage) + "_"
+           + std::to_string(features) + ".spv";
+}
+
+} // namespace VKB
@@ -0,0 +1,90 @@
+﻿#ifndef VULKANSHADERVARIANT_H_
+#define VULKANSHADERVARIANT_H_
+
+#include "VulkanHead.h"
+
+#include <string>
+
+namespace VKB
+{
+
+/**
+ * @brief 着色器特性位
+ *
+ * 每个特性对应 Uber 着色器中的一个编译宏（glslc -D），
+ * 不同特性组合离线编译为不同的 SPIR-V 排列（Permutation）。
+ * 位定义需要与 VulkanBase/CMakeLists.txt 中 UBER_FEATURES 顺序一致。
+ */
+enum ShaderFeature : uint32_t
+{
+    SHADER_FEATURE_NONE = 0,
+    SHADER_FEATURE_TEXTURE = 1 << 0,       // HAS_TEXTURE   纹理采样
+    SHADER_FEATURE_NORMAL = 1 << 1,        // HAS_NORMAL    顶点法线输入
+    SHADER_FEATURE_LIGHTING = 1 << 2,      // HAS_LIGHTING  Phong 光照（需法线）
+    SHADER_FEATURE_UBO_COLOR = 1 << 3,     // HAS_UBO_COLOR UBO 颜色 / 透明度
+    SHADER_FEATURE_GPU_DRIVEN = 1 << 4,    // HAS_GPU_DRIVEN 存储缓冲物体数据
+    SHADER_FEATURE_INSTANCING = 1 << 5,    // HAS_INSTANCING 逐实例顶点属性
+    SHADER_FEATURE_OBJECT_BUFFER = 1 << 6, // HAS_OBJECT_BUFFER 逐物体存储缓冲
+    SHADER_FEATURE_BINDLESS = 1 << 7,      // HAS_BINDLESS  Bindless 纹理表
+};
+
+/**
+ * @brief 特化常量（Specialization Constants）
+ *
+ * 不需要重新编译 SPIR-V 的廉价开关，通过 VkSpecializationInfo
+ * 在创建管线时写入，constant_id 与 Uber 着色器保持一致。
+ * 布尔值按 SPIR-V 要求使用 32 位存储。
+ */
+struct ShaderSpecConstants
+{
+    float uvScale = 1.0f;        // constant_id = 0 纹理坐标缩放
+    uint32_t useVertexColor = 0; // constant_id = 1 颜色取自顶点而非 Push
+    uint32_t useSpecular = 1;    // constant_id = 2 光照是否计算高光
+
+    bool operator==(const ShaderSpecConstants &other) const = default;
+
+    size_t Hash() const;
+
+    /// 生成特化信息（pData 指向自身，调用方需保证生命周期）
+    VkSpecializationInfo GetInfo() const;
+};
+
+/**
+ * @brief 着色器变体键
+ *
+ * 由 源文件名 + 阶段 + 特性位 唯一确定一个 SPIR-V 排列
+ */
+struct ShaderVariantKey
+{
+    // Uber 着色器名
+    std::string name;
+
+    // 着色器阶段
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // 特性位（ShaderFeature 组合）
+    uint32_t features = SHADER_FEATURE_NONE;
+
+    bool operator==(const ShaderVariantKey &other) const = default;
+
+    size_t Hash() const;
+
+    /**
+     * @brief 离线编译排列的 SPIR-V 路径
+     *
+     * 例如 Res\Shaders\Uber\Uber_frag_7.spv
+     */
+    std::string GetSpirvPath() const;
+};
+
+struct ShaderVariantKeyHash
+{
+    size_t operator()(const ShaderVariantKey &key) const
+    {
+        return key.Hash();
+    }
+};
+
+} // namespace VKB
+
+#endif // !VULKANSHADERVARIANT_H_
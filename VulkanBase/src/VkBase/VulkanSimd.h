@@ -0,0 +1,58 @@
+﻿#ifndef VULKANSIMD_H_
+#define VULKANSIMD_H_
+
+#include "MacroHead.h"
+
+/**
+ * SIMD 指令集（编译期选择）：
+ * - VKB_SIMD_AVX2：编译器启用了 AVX2（CMake 选项 VKB_ENABLE_AVX2）
+ * - VKB_SIMD_SSE2：x64 / 启用 SSE2 的 x86 基线
+ * - 都未定义时只使用标量路径
+ */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VKB_SIMD_AVX2
+#define VKB_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64)                                     \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKB_SIMD_SSE2
+#endif
+
+namespace VKB
+{
+
+/**
+ * @brief out = a * b（列主序 4x4 矩阵）
+ *
+ * SSE 下结果的每一列为 a 的四列按 b 对应列的分量加权求和，
+ * out 可以与 a 或 b 相同
+ */
+inline void MultiplyMatrix(const MAT_4 &a, const MAT_4 &b, MAT_4 &out)
+{
+#if defined(VKB_SIMD_SSE2)
+    const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+    const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+    const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+    const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+    for (int column = 0; column < 4; ++column) {
+        const __m128 b0 = _mm_set1_ps(b[column][0]);
+        const __m128 b1 = _mm_set1_ps(b[column][1]);
+        const __m128 b2 = _mm_set1_ps(b[column][2]);
+        const __m128 b3 = _mm_set1_ps(b[column][3]);
+
+        __m128 result = _mm_mul_ps(a0, b0);
+        result = _mm_add_ps(result, _mm_mul_ps(a1, b1));
+        result = _mm_add_ps(result, _mm_mul_ps(a2, b2));
+        result = _mm_add_ps(result, _mm_mul_ps(a3, b3));
+        _mm_storeu_ps(&out[column][0], result);
+    }
+#else
+    out = a * b;
+#endif
+}
+
+} // namespace VKB
+
+#endif // !VULKANSIMD_H_
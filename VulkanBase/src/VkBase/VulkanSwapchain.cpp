@@ -20,7 +20,7 @@ VulkanSwapchain::~VulkanSwapchain()
 bool VulkanSwapchain::Init(VkPhysicalDevice physicalDevice, VkDevice device,
                            VkSurfaceKHR surface, uint32_t graphicsQueueFamily,
                            uint32_t presentQueueFamily, uint32_t width,
-                           uint32_t height)
+                           uint32_t height, const PresentConfig &config)
 {
     if (physicalDevice == VK_NULL_HANDLE || device == VK_NULL_HANDLE) {
         PSG::PrintError("创建交换链失败 物理或者逻辑设备为空!");
@@ -42,13 +42,15 @@ bool VulkanSwapchain::Init(VkPhysicalDevice physicalDevice, VkDevice device,
     VkSurfaceFormatKHR surfaceFormat = chooseFormat(support.formats);
 
     // 选择最优的呈现模式
-    VkPresentModeKHR presentMode = choosePresentMode(support.presentModes);
+    VkPresentModeKHR presentMode =
+        choosePresentMode(support.presentModes, config.presentMode);
 
     // 选择最终的分辨率
     VkExtent2D extent = chooseExtent(support.capabilities, width, height);
 
-    // 交换链图像数量
-    uint32_t imageCount = support.capabilities.minImageCount;
+    // 交换链图像数量（未指定时取最小值），不少于 Surface 的最小数量
+    uint32_t imageCount =
+        std::max(config.imageCount, support.capabilities.minImageCount);
 
     // 如果交换链图像数量大于支持的最大数量，那么等于支持的最大数量
     if (support.capabilities.maxImageCount > 0
@@ -119,6 +121,7 @@ bool VulkanSwapchain::Init(VkPhysicalDevice physicalDevice, VkDevice device,
     _device = device;
     _extent = extent;
     _format = surfaceFormat.format;
+    _presentMode = presentMode;
     return true;
 }
 
@@ -180,12 +183,13 @@ VulkanSwapchain::chooseFormat(const std::vector<VkSurfaceFormatKHR> &formats)
 }
 
 VkPresentModeKHR
-VulkanSwapchain::choosePresentMode(const std::vector<VkPresentModeKHR> &modes)
+VulkanSwapchain::choosePresentMode(const std::vector<VkPresentModeKHR> &modes,
+                                   VkPresentModeKHR preferred)
 {
     for (const auto &mode : modes) {
 
-        // 优先选择 MAILBOX (低延迟 Triple-buffering 风格 高帧率渲染)
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+        // 优先选择配置的模式（默认 MAILBOX）
+        if (mode == preferred) {
             return mode;
         }
     }
@@ -6,6 +6,24 @@
 namespace VKB
 {
 
+/**
+ * @brief 呈现策略（运行时配置）
+ */
+struct PresentConfig
+{
+    // 并行帧数（1 ~ 3，越少延迟越低，越多吞吐越高）
+    uint32_t framesInFlight = 2;
+
+    // 交换链图像数（0 表示使用 Surface 支持的最小值）
+    uint32_t imageCount = 0;
+
+    // 期望的呈现模式，不支持时回退到 FIFO
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+
+    // 使用 VK_KHR_present_wait 按显示时间节拍（设备支持时）
+    bool presentWait = false;
+};
+
 /**
  * @brief VulkanSwapchain
  *
@@ -30,7 +48,8 @@ public:
      */
     bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
               VkSurfaceKHR surface, uint32_t graphicsQueueFamily,
-              uint32_t presentQueueFamily, uint32_t width, uint32_t height);
+              uint32_t presentQueueFamily, uint32_t width, uint32_t height,
+              const PresentConfig &config = {});
 
     /**
      * @brief 销毁 Swapchain
@@ -61,6 +80,14 @@ public:
         return _extent;
     }
 
+    /**
+     * @brief 交换链图像
+     */
+    const std::vector<VkImage> &GetImages() const
+    {
+        return _images;
+    }
+
     /**
      * @brief 交换链图像对应的图像视图
      */
@@ -69,6 +96,14 @@ public:
         return _imageViews;
     }
 
+    /**
+     * @brief 实际使用的呈现模式
+     */
+    VkPresentModeKHR GetPresentMode() const
+    {
+        return _presentMode;
+    }
+
     /**
      * @brief 交换链图像视图数量
      */
@@ -118,12 +153,16 @@ private:
      * @brief 选择 Swapchain 的 Present Mode（呈现方式）
      *
      * 各模式含义：
-     * - FIFO       ：垂直同步（一定支持）
-     * - MAILBOX    ：三缓冲，低延迟（优先）
-     * - IMMEDIATE  ：可能撕裂（不推荐）
+     * - FIFO         ：垂直同步（一定支持）
+     * - FIFO_RELAXED ：垂直同步，错过 VBlank 时立即呈现（可能撕裂）
+     * - MAILBOX      ：三缓冲，低延迟
+     * - IMMEDIATE    ：延迟最低，可能撕裂
+     *
+     * 期望的模式不支持时回退到 FIFO
      */
     VkPresentModeKHR
-    choosePresentMode(const std::vector<VkPresentModeKHR> &modes);
+    choosePresentMode(const std::vector<VkPresentModeKHR> &modes,
+                      VkPresentModeKHR preferred);
 
     /**
      * @brief 决定 Swapchain Image 的最终分辨率
@@ -161,6 +200,9 @@ private:
     // 交换链分辨率（宽高，通常等于窗口尺寸）
     VkExtent2D _extent{};
 
+    // 实际使用的呈现模式
+    VkPresentModeKHR _presentMode = VK_PRESENT_MODE_FIFO_KHR;
+
     // 交换链中的图像列表（由 Vulkan 创建，不需要手动分配）
     std::vector<VkImage> _images;
 
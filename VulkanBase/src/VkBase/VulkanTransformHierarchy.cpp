@@ -0,0 +1,138 @@
+﻿#include "VulkanTransformHierarchy.h"
+
+#include "VulkanSimd.h"
+
+namespace VKB
+{
+
+uint32_t VulkanTransformHierarchy::Add(uint32_t parent, const MAT_4 &local,
+                                       uint32_t objectSlot)
+{
+    uint32_t parentIndex = INVALID_NODE;
+    uint32_t index = GetCount();
+    if (parent != INVALID_NODE) {
+        if (parent >= _indexOf.size()) {
+            return INVALID_NODE;
+        }
+        parentIndex = _indexOf[parent];
+        index = parentIndex + _subtreeSize[parentIndex];
+    }
+
+    // 插入到中间时后面的节点整体后移，修正指向它们的下标
+    if (index < GetCount()) {
+        for (uint32_t &p : _parent) {
+            if (p != INVALID_NODE && p >= index) {
+                ++p;
+            }
+        }
+        for (uint32_t i = index; i < GetCount(); ++i) {
+            ++_indexOf[_handleOf[i]];
+        }
+    }
+
+    const uint32_t handle = static_cast<uint32_t>(_indexOf.size());
+    _indexOf.push_back(index);
+
+    _local.insert(_local.begin() + index, local);
+    _world.insert(_world.begin() + index, local);
+    _parent.insert(_parent.begin() + index, parentIndex);
+    _subtreeSize.insert(_subtreeSize.begin() + index, 1);
+    _objectSlot.insert(_objectSlot.begin() + index, objectSlot);
+    _dirty.insert(_dirty.begin() + index, 1);
+    _handleOf.insert(_handleOf.begin() + index, handle);
+
+    // 祖先的子树都增加一个节点
+    for (uint32_t p = parentIndex; p != INVALID_NODE; p = _parent[p]) {
+        ++_subtreeSize[p];
+    }
+
+    return handle;
+}
+
+void VulkanTransformHierarchy::SetLocal(uint32_t node, const MAT_4 &local)
+{
+    const uint32_t index = _indexOf[node];
+    _local[index] = local;
+    _dirty[index] = 1;
+}
+
+uint32_t VulkanTransformHierarchy::Update(MAT_4 *models, size_t stride)
+{
+    // 收集最外层的脏子树：脏节点的整个子树都需要重算，直接跳过
+    _ranges.clear();
+    uint32_t dirtyCount = 0;
+    const uint32_t count = GetCount();
+    for (uint32_t i = 0; i < count;) {
+        if (_dirty[i]) {
+            const uint32_t end = i + _subtreeSize[i];
+            _ranges.push_back({i, end});
+            dirtyCount += end - i;
+            i = end;
+        } else {
+            ++i;
+        }
+    }
+
+    if (_ranges.empty()) {
+        return 0;
+    }
+
+    // 各区间互不重叠，父节点要么在区间内，要么是干净的
+    const uint32_t rangeCount = static_cast<uint32_t>(_ranges.size());
+    if (nullptr == _jobSystem || 1 == rangeCount
+        || dirtyCount < PARALLEL_UPDATE_THRESHOLD) {
+        for (const NodeRange &range : _ranges) {
+            updateRange(range.begin, range.end, models, stride);
+        }
+        return dirtyCount;
+    }
+
+    PSG::JobCounter counter;
+    _jobSystem->ParallelFor(
+        rangeCount, 0,
+        [&](uint32_t first, uint32_t last) {
+            for (uint32_t r = first; r < last; ++r) {
+                updateRange(_ranges[r].begin, _ranges[r].end, models, stride);
+            }
+        },
+        counter);
+    _jobSystem->Wait(counter);
+
+    return dirtyCount;
+}
+
+void VulkanTransformHierarchy::Clear()
+{
+    _local.clear();
+    _world.clear();
+    _parent.clear();
+    _subtreeSize.clear();
+    _objectSlot.clear();
+    _dirty.clear();
+    _handleOf.clear();
+    _indexOf.clear();
+    _ranges.clear();
+}
+
+void VulkanTransformHierarchy::updateRange(uint32_t begin, uint32_t end,
+                                           MAT_4 *models, size_t stride)
+{
+    auto *output = reinterpret_cast<uint8_t *>(models);
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const uint32_t parent = _parent[i];
+        if (parent == INVALID_NODE) {
+            _world[i] = _local[i];
+        } else {
+            MultiplyMatrix(_world[parent], _local[i], _world[i]);
+        }
+        _dirty[i] = 0;
+
+        if (output != nullptr && _objectSlot[i] != INVALID_NODE) {
+            *reinterpret_cast<MAT_4 *>(output + _objectSlot[i] * stride) =
+                _world[i];
+        }
+    }
+}
+
+} // namespace VKB
@@ -0,0 +1,127 @@
+﻿#ifndef VULKANTRANSFORMHIERARCHY_H_
+#define VULKANTRANSFORMHIERARCHY_H_
+
+#include "JobSystem.h"
+#include "VulkanHead.h"
+
+namespace VKB
+{
+
+/**
+ * @brief VulkanTransformHierarchy
+ *
+ * 面向数据的变换层级：
+ * - 局部 / 世界矩阵、父节点、子树大小、脏标记按结构数组（SoA）存放
+ * - 节点按深度优先顺序排列：父节点在子节点之前，每棵子树占一段连续区间
+ * - 修改局部矩阵只标记该节点，Update 时只重算脏节点所在的子树
+ * - 互不重叠的脏子树在调度器上并行更新，矩阵连乘使用 SIMD
+ * - 重算的世界矩阵直接写入调用方的逐物体数据（按物体槽位寻址）
+ * - 对外使用稳定的句柄，插入节点时内部下标会移动
+ */
+class VulkanTransformHierarchy
+{
+public:
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    VulkanTransformHierarchy() = default;
+
+    ~VulkanTransformHierarchy() = default;
+
+public:
+    /**
+     * @brief 添加节点
+     * @param parent 父节点句柄（INVALID_NODE 表示根节点）
+     * @param objectSlot 世界矩阵写入的物体槽位（INVALID_NODE 表示不输出）
+     * @return 节点句柄，父节点无效时返回 INVALID_NODE
+     *
+     * 节点插入到父节点子树的末尾；按深度优先顺序构建时不需要移动数据
+     */
+    uint32_t Add(uint32_t parent, const MAT_4 &local,
+                 uint32_t objectSlot = INVALID_NODE);
+
+    /**
+     * @brief 修改局部矩阵，下次 Update 时重算整个子树
+     */
+    void SetLocal(uint32_t node, const MAT_4 &local);
+
+    const MAT_4 &GetLocal(uint32_t node) const
+    {
+        return _local[_indexOf[node]];
+    }
+
+    /**
+     * @brief 最近一次 Update 后的世界矩阵
+     */
+    const MAT_4 &GetWorld(uint32_t node) const
+    {
+        return _world[_indexOf[node]];
+    }
+
+    /**
+     * @brief 重算全部脏子树
+     * @param models 第一个物体的模型矩阵地址（可为空），
+     *               物体 slot 的模型矩阵位于 models + slot * stride 字节处
+     * @param stride 相邻物体的字节间隔
+     *
+     * 只写入重算的节点，models 指向的数据需要在两次 Update 之间保留
+     * @return 重算的节点数
+     */
+    uint32_t Update(MAT_4 *models = nullptr, size_t stride = sizeof(MAT_4));
+
+    void Clear();
+
+    /**
+     * @brief 设置并行更新使用的调度器（为空时单线程更新）
+     */
+    void SetJobSystem(PSG::JobSystem *jobSystem)
+    {
+        _jobSystem = jobSystem;
+    }
+
+    uint32_t GetCount() const
+    {
+        return static_cast<uint32_t>(_local.size());
+    }
+
+private:
+    // 脏节点总数低于此值时单线程更新
+    static constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 1024;
+
+    struct NodeRange
+    {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    // 按深度优先顺序重算 [begin, end)（父节点已是最新）
+    void updateRange(uint32_t begin, uint32_t end, MAT_4 *models,
+                     size_t stride);
+
+private:
+    std::vector<MAT_4> _local;
+
+    std::vector<MAT_4> _world;
+
+    // 父节点下标（根节点为 INVALID_NODE）
+    std::vector<uint32_t> _parent;
+
+    // 以该节点为根的子树节点数（包括自身）
+    std::vector<uint32_t> _subtreeSize;
+
+    std::vector<uint32_t> _objectSlot;
+
+    std::vector<uint8_t> _dirty;
+
+    // 下标 -> 句柄，句柄 -> 下标
+    std::vector<uint32_t> _handleOf;
+    std::vector<uint32_t> _indexOf;
+
+    // 本次更新的脏子树区间
+    std::vector<NodeRange> _ranges;
+
+    PSG::JobSystem *_jobSystem = nullptr;
+};
+
+} // namespace VKB
+
+#endif // !VULKANTRANSFORMHIERARCHY_H_
@@ -1,6 +1,7 @@
 ﻿#ifndef VULKAN_UTILS_H_
 #define VULKAN_UTILS_H_
 
+#include <functional>
 #include <stdexcept>
 #include <vulkan/vulkan.h>
 
@@ -166,6 +167,13 @@ inline void EndSingleTimeCommand(VkDevice device, VkCommandPool commandPool,
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
 
+// 哈希合并（用于 Pipeline / Shader 变体等组合键）
+template <typename T>
+inline void HashCombine(size_t &seed, const T &value)
+{
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 } // namespace VKB
 
 #endif // VULKAN_UTILS_H_
\ No newline at end of file
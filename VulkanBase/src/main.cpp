@@ -4,8 +4,28 @@
 
 #include "VkBase/VulkanBase.h"
 
-int main()
+int main(int argc, char **argv)
 {
+#ifdef NDEBUG
+    // 基准结果经 PSG::PrintMsg 输出，Release 构建下不会打印
+    if (argc > 1 && std::string(argv[1]).ends_with("-benchmark")) {
+        std::cerr << "基准结果只在未定义 NDEBUG 的构建中输出\n";
+    }
+#endif
+
+    // 视锥体剔除微基准（100 万物体），不创建窗口
+    if (argc > 1 && std::string(argv[1]) == "--cull-benchmark") {
+        PSG::JobSystem jobSystem;
+        jobSystem.Init();
+        VKB::VulkanFrustumCuller::Benchmark(1000000, &jobSystem);
+        jobSystem.Destroy();
+        return 0;
+    }
+
+    // 描述符更新微基准：需要真实设备，初始化完成后运行一次即退出
+    const bool descriptorBenchmark =
+        argc > 1 && std::string(argv[1]) == "--descriptor-benchmark";
+
     // 1. 初始化 GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to init GLFW\n";
@@ -37,8 +57,12 @@ int main()
         return -1;
     }
 
+    if (descriptorBenchmark) {
+        vulkan.BenchmarkDescriptorUpdates();
+    }
+
     // 5. 主循环（暂时不做渲染）
-    while (!glfwWindowShouldClose(window)) {
+    while (!descriptorBenchmark && !glfwWindowShouldClose(window)) {
         glfwPollEvents();
 
         vulkan.DrawFrame(); // 这里可以调用 DrawFrame() 进行渲染
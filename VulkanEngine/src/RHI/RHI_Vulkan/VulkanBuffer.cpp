@@ -133,4 +133,27 @@ void VulkanBuffer::CopyFrom(VulkanBuffer &src, VkCommandPool commandPool,
     vkFreeCommandBuffers(_device, commandPool, 1, &commandBuffer);
 }
 
+uint64_t VulkanBuffer::CopyFrom(VulkanBuffer *staging,
+                                VkCommandPool commandPool,
+                                VulkanTimeline *timeline)
+{
+    VkCommandBuffer cmd = BeginSingleTimeCommand(_device, commandPool);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.size = staging->GetSize();
+    vkCmdCopyBuffer(cmd, staging->Get(), _buffer, 1, &copyRegion);
+
+    // 不再等待队列空闲，由屏障保证之后提交的命令读取到拷贝结果
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+
+    return EndSingleTimeCommand(_device, commandPool, timeline, cmd,
+                                [staging]() { delete staging; });
+}
+
 } // namespace RHI
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define VULKANBUFFER_H_
 
 #include "VulkanHeadRHI.h"
+#include "VulkanTimeline.h"
 
 namespace RHI
 {
@@ -62,6 +63,17 @@ public:
      */
     void CopyFrom(VulkanBuffer &src, VkCommandPool commandPool, VkQueue queue);
 
+    /**
+     * @brief 从暂存 Buffer 拷贝数据，提交到时间线后立即返回
+     *
+     * 暂存 Buffer 的所有权转交给时间线，GPU 完成拷贝后再销毁；
+     * 之后提交到同一队列的命令可以直接读取
+     *
+     * @return 拷贝提交的时间线值，失败返回 0
+     */
+    uint64_t CopyFrom(VulkanBuffer *staging, VkCommandPool commandPool,
+                      VulkanTimeline *timeline);
+
     VkBuffer Get() const
     {
         return _buffer;
@@ -9,7 +9,8 @@ VulkanCommandPool::~VulkanCommandPool()
     Destroy();
 }
 
-bool VulkanCommandPool::Init(VkDevice device, uint32_t queueFamilyIndex)
+bool VulkanCommandPool::Init(VkDevice device, uint32_t queueFamilyIndex,
+                             VkCommandPoolCreateFlags flags)
 {
     if (VK_NULL_HANDLE == device) {
         PSG::PrintError("创建命令池对象失败：逻辑设备为空!");
@@ -23,8 +24,8 @@ bool VulkanCommandPool::Init(VkDevice device, uint32_t queueFamilyIndex)
     // 图形命令队列族
     poolInfo.queueFamilyIndex = queueFamilyIndex;
 
-    // 允许单个 CommandBuffer reset
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    // 默认允许单个 CommandBuffer reset
+    poolInfo.flags = flags;
 
     // 创建命令池
     VkResult ret =
@@ -37,6 +38,13 @@ bool VulkanCommandPool::Init(VkDevice device, uint32_t queueFamilyIndex)
     return true;
 }
 
+void VulkanCommandPool::Reset()
+{
+    if (_commandPool != VK_NULL_HANDLE) {
+        vkResetCommandPool(_device, _commandPool, 0);
+    }
+}
+
 void VulkanCommandPool::Destroy()
 {
     if (_commandPool != VK_NULL_HANDLE) {
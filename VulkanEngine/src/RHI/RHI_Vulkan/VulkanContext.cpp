@@ -1,5 +1,7 @@
 ﻿#include "VulkanContext.h"
 
+#include <algorithm>
+
 #include "VulkanUtils.h"
 
 namespace RHI
@@ -21,7 +23,7 @@ VulkanContext::~VulkanContext()
 }
 
 bool VulkanContext::Init(const SurfaceDescRHI &surfaceDesc, int width,
-                         int height)
+                         int height, uint32_t framesInFlight)
 {
     // 创建 Vulkan Instance
     bool ret = _instance->Create();
@@ -64,8 +66,9 @@ bool VulkanContext::Init(const SurfaceDescRHI &surfaceDesc, int width,
         return false;
     }
 
-    // 同步对象
-    ret = _sync->Init(device, _swapchain->GetImageViewCount());
+    // 同步对象：每个并行帧一组
+    framesInFlight = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    ret = _sync->Init(device, _device->GetGraphicsQueue(), framesInFlight);
     return ret;
 }
 
@@ -75,10 +78,24 @@ void VulkanContext::Shutdown()
 
 void VulkanContext::WaitIdle()
 {
+    VkDevice device = GetVkDevice();
+    if (device != VK_NULL_HANDLE) {
+        vkDeviceWaitIdle(device);
+    }
 }
 
-void VulkanContext::RecreateSwapchain(int width, int height)
+bool VulkanContext::RecreateSwapchain(int width, int height)
 {
+    if (nullptr == _swapchain) {
+        return false;
+    }
+
+    // 旧交换链图像可能仍被在途帧使用，销毁前等待 GPU 空闲
+    WaitIdle();
+    _swapchain->Destroy();
+
+    return _swapchain->Init(_physicalDevice, GetVkDevice(), _surface->Get(),
+                            width, height);
 }
 
 } // namespace RHI
@@ -29,6 +29,12 @@ namespace RHI
 class VulkanContext
 {
 public:
+    // 默认并行帧数
+    static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+    // 并行帧数上限
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
     VulkanContext();
 
     ~VulkanContext();
@@ -36,11 +42,13 @@ public:
     /*
      * 初始化 Vulkan 上下文
      *
-     * @param surfaceDesc  平台相关的表面描述（Win32 / GLFW / SDL 等）
-     * @param width        初始窗口宽度
-     * @param height       初始窗口高度
+     * @param surfaceDesc     平台相关的表面描述（Win32 / GLFW / SDL 等）
+     * @param width           初始窗口宽度
+     * @param height          初始窗口高度
+     * @param framesInFlight  并行帧数（限制在 1 ~ MAX_FRAMES_IN_FLIGHT）
      */
-    bool Init(const SurfaceDescRHI &surfaceDesc, int width, int height);
+    bool Init(const SurfaceDescRHI &surfaceDesc, int width, int height,
+              uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
 
     /*
      * 释放 Vulkan 所有资源（需在应用退出时调用）
@@ -56,9 +64,9 @@ public:
 
     /*
      * 当窗口尺寸变化或 Swapchain 失效时调用
-     *
+     * 窗口最小化（分辨率为 0）时返回 false，交换链保持销毁状态
      */
-    void RecreateSwapchain(int width, int height);
+    bool RecreateSwapchain(int width, int height);
 
     // -------- Vulkan 对象访问接口 --------
 public:
@@ -90,6 +98,18 @@ public:
         return _sync;
     }
 
+    /*
+     * 并行帧数（每帧资源、DescriptorPool 等都按它分配）
+     */
+    uint32_t GetFramesInFlight() const
+    {
+        if (nullptr == _sync) {
+            return 0;
+        }
+
+        return _sync->GetFrameCount();
+    }
+
     // ========================
     // 原生 Vulkan 对象访问接口（Vk* 对象）
     // ========================
@@ -156,13 +176,13 @@ public:
         return _sync->GetRenderFinished(frameIndex);
     }
 
-    VkFence GetInFlightFence(uint32_t frameIndex) const
+    VulkanTimeline *GetGraphicsTimeline() const
     {
         if (nullptr == _sync) {
-            return VK_NULL_HANDLE;
+            return nullptr;
         }
 
-        return _sync->GetInFlightFence(frameIndex);
+        return _sync->GetGraphicsTimeline();
     }
 
 private:
@@ -184,7 +204,7 @@ private:
     // 命令池（分配 CommandBuffer）
     VulkanCommandPool *_commandPool = nullptr;
 
-    // 同步对象（Fence / Semaphore，多帧并行）
+    // 同步对象（时间线 / Semaphore，多帧并行）
     VulkanSync *_sync = nullptr;
 };
 
@@ -0,0 +1,195 @@
+﻿#include "VulkanDescriptorCache.h"
+
+#include "PrintMsg.h"
+#include "VulkanUtils.h"
+
+namespace RHI
+{
+
+DescriptorWrite DescriptorWrite::Buffer(uint32_t binding, VkDescriptorType type,
+                                        VkBuffer buffer, VkDeviceSize offset,
+                                        VkDeviceSize range)
+{
+    DescriptorWrite write{};
+    write.binding = binding;
+    write.type = type;
+    write.buffer.buffer = buffer;
+    write.buffer.offset = offset;
+    write.buffer.range = range;
+    return write;
+}
+
+DescriptorWrite DescriptorWrite::Image(uint32_t binding, VkDescriptorType type,
+                                       VkImageView imageView, VkSampler sampler,
+                                       VkImageLayout layout)
+{
+    DescriptorWrite write{};
+    write.binding = binding;
+    write.type = type;
+    write.image.imageView = imageView;
+    write.image.sampler = sampler;
+    write.image.imageLayout = layout;
+    return write;
+}
+
+bool DescriptorWrite::IsImage() const
+{
+    switch (type) {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool DescriptorWrite::operator==(const DescriptorWrite &other) const
+{
+    if (binding != other.binding || type != other.type) {
+        return false;
+    }
+
+    if (IsImage()) {
+        return image.imageView == other.image.imageView
+               && image.sampler == other.image.sampler
+               && image.imageLayout == other.image.imageLayout;
+    }
+
+    return buffer.buffer == other.buffer.buffer
+           && buffer.offset == other.buffer.offset
+           && buffer.range == other.buffer.range;
+}
+
+VulkanDescriptorCache::~VulkanDescriptorCache()
+{
+    Destroy();
+}
+
+bool VulkanDescriptorCache::Init(VkDevice device, uint32_t setsPerPool)
+{
+    _device = device;
+
+    // 材质 set 以 UBO + 纹理为主，兼顾存储缓冲
+    std::vector<VulkanDescriptorPool::PoolRatio> ratios = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f},
+    };
+
+    return _pool.Init(device, setsPerPool, ratios);
+}
+
+VkDescriptorSet
+VulkanDescriptorCache::Get(VkDescriptorSetLayout layout,
+                           const std::vector<DescriptorWrite> &writes)
+{
+    SetKey key{layout, writes};
+
+    auto it = _sets.find(key);
+    if (it != _sets.end()) {
+        ++_hits;
+        return it->second;
+    }
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (!_pool.Allocate(layout, set)) {
+        return VK_NULL_HANDLE;
+    }
+
+    write(set, writes);
+
+    ++_misses;
+    _sets.emplace(std::move(key), set);
+    return set;
+}
+
+void VulkanDescriptorCache::InvalidateBuffer(VkBuffer buffer)
+{
+    std::erase_if(_sets, [buffer](const auto &entry) {
+        for (const DescriptorWrite &write : entry.first.writes) {
+            if (!write.IsImage() && write.buffer.buffer == buffer) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+void VulkanDescriptorCache::InvalidateImageView(VkImageView imageView)
+{
+    std::erase_if(_sets, [imageView](const auto &entry) {
+        for (const DescriptorWrite &write : entry.first.writes) {
+            if (write.IsImage() && write.image.imageView == imageView) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+void VulkanDescriptorCache::Clear()
+{
+    _sets.clear();
+    _pool.Reset();
+}
+
+void VulkanDescriptorCache::Destroy()
+{
+    _sets.clear();
+    _pool.Destroy();
+    _hits = 0;
+    _misses = 0;
+}
+
+size_t VulkanDescriptorCache::SetKeyHash::operator()(const SetKey &key) const
+{
+    size_t seed = 0;
+    HashCombine(seed, key.layout);
+
+    for (const DescriptorWrite &write : key.writes) {
+        HashCombine(seed, write.binding);
+        HashCombine(seed, static_cast<uint32_t>(write.type));
+
+        if (write.IsImage()) {
+            HashCombine(seed, write.image.imageView);
+            HashCombine(seed, write.image.sampler);
+            HashCombine(seed, static_cast<uint32_t>(write.image.imageLayout));
+        } else {
+            HashCombine(seed, write.buffer.buffer);
+            HashCombine(seed, write.buffer.offset);
+            HashCombine(seed, write.buffer.range);
+        }
+    }
+
+    return seed;
+}
+
+void VulkanDescriptorCache::write(
+    VkDescriptorSet set, const std::vector<DescriptorWrite> &writes) const
+{
+    std::vector<VkWriteDescriptorSet> descriptorWrites(writes.size());
+    for (size_t i = 0; i < writes.size(); ++i) {
+        VkWriteDescriptorSet &descriptorWrite = descriptorWrites[i];
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = set;
+        descriptorWrite.dstBinding = writes[i].binding;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = writes[i].type;
+        descriptorWrite.descriptorCount = 1;
+        if (writes[i].IsImage()) {
+            descriptorWrite.pImageInfo = &writes[i].image;
+        } else {
+            descriptorWrite.pBufferInfo = &writes[i].buffer;
+        }
+    }
+
+    // 一次调用写入全部绑定
+    vkUpdateDescriptorSets(_device,
+                           static_cast<uint32_t>(descriptorWrites.size()),
+                           descriptorWrites.data(), 0, nullptr);
+}
+
+} // namespace RHI
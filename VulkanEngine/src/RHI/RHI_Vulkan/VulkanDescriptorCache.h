@@ -0,0 +1,140 @@
+﻿#ifndef VULKAN_DESCRIPTOR_CACHE_H_
+#define VULKAN_DESCRIPTOR_CACHE_H_
+
+#include "VulkanDescriptorPool.h"
+#include "VulkanHeadRHI.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace RHI
+{
+
+/*
+ * DescriptorWrite
+ * --------------------------------
+ * 描述符集中一个绑定引用的资源（缓冲或图像）
+ */
+struct DescriptorWrite
+{
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    // 缓冲类描述符使用
+    VkDescriptorBufferInfo buffer{};
+
+    // 图像 / 采样器类描述符使用
+    VkDescriptorImageInfo image{};
+
+    static DescriptorWrite Buffer(uint32_t binding, VkDescriptorType type,
+                                  VkBuffer buffer, VkDeviceSize offset,
+                                  VkDeviceSize range);
+
+    static DescriptorWrite
+    Image(uint32_t binding, VkDescriptorType type, VkImageView imageView,
+          VkSampler sampler,
+          VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    bool IsImage() const;
+
+    bool operator==(const DescriptorWrite &other) const;
+};
+
+/*
+ * VulkanDescriptorCache
+ * --------------------------------
+ * 职责：
+ *  * 按 布局 + 绑定资源 缓存不可变的 DescriptorSet
+ *  * 相同的材质绑定复用同一个 set，只在首次分配并写入
+ *  * set 从内部可增长的 DescriptorPool 分配
+ *
+ * 约束：
+ *  * 返回的 set 被多处共享，调用方不能再更新
+ *  * 资源销毁时按句柄 Invalidate，避免新资源复用句柄时命中旧 set
+ */
+class VulkanDescriptorCache
+{
+public:
+    VulkanDescriptorCache() = default;
+
+    ~VulkanDescriptorCache();
+
+    /*
+     * 初始化
+     *
+     * @param setsPerPool: 内部首个池的 set 数
+     */
+    bool Init(VkDevice device, uint32_t setsPerPool = 64);
+
+    /*
+     * 获取绑定了 writes 的 set（未命中时分配并写入）
+     *
+     * @return 失败时返回 VK_NULL_HANDLE
+     */
+    VkDescriptorSet Get(VkDescriptorSetLayout layout,
+                        const std::vector<DescriptorWrite> &writes);
+
+    /*
+     * 丢弃引用 buffer / imageView 的缓存 set（资源销毁时调用）
+     *
+     * set 本身留在池中直到 Clear，在途帧仍可继续使用
+     */
+    void InvalidateBuffer(VkBuffer buffer);
+
+    void InvalidateImageView(VkImageView imageView);
+
+    /*
+     * 丢弃全部缓存的 set，并整体重置内部的池
+     * （GPU 不再使用这些 set 之后调用）
+     */
+    void Clear();
+
+    void Destroy();
+
+    size_t GetCount() const
+    {
+        return _sets.size();
+    }
+
+    // 命中 / 未命中次数
+    uint64_t GetHits() const
+    {
+        return _hits;
+    }
+
+    uint64_t GetMisses() const
+    {
+        return _misses;
+    }
+
+private:
+    struct SetKey
+    {
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        std::vector<DescriptorWrite> writes;
+
+        bool operator==(const SetKey &other) const = default;
+    };
+
+    struct SetKeyHash
+    {
+        size_t operator()(const SetKey &key) const;
+    };
+
+    void write(VkDescriptorSet set,
+               const std::vector<DescriptorWrite> &writes) const;
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VulkanDescriptorPool _pool;
+
+    std::unordered_map<SetKey, VkDescriptorSet, SetKeyHash> _sets;
+
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+};
+
+} // namespace RHI
+
+#endif // VULKAN_DESCRIPTOR_CACHE_H_
@@ -1,5 +1,9 @@
 ﻿#include "VulkanDescriptorPool.h"
 
+#include <algorithm>
+
+#include "PrintMsg.h"
+
 namespace RHI
 {
 
@@ -10,76 +14,160 @@ VulkanDescriptorPool::~VulkanDescriptorPool()
 
 bool VulkanDescriptorPool::Init(VkDevice device, uint32_t framesInFlight)
 {
-    if (device == VK_NULL_HANDLE || framesInFlight == 0) {
+    if (framesInFlight == 0) {
         return false;
     }
 
-    _device = device;
-
     // 预估需要的 descriptor 数量
-    std::vector<VkDescriptorPoolSize> poolSizes = {
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 * framesInFlight},
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 16 * framesInFlight},
+    std::vector<PoolRatio> ratios = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
         // 可以根据需求扩展：storage buffer / sampled image 等
     };
 
-    VkDescriptorPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = framesInFlight * 16; // 预留每帧最多 16 个 set
-    poolInfo.flags =
-        VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // 支持 free
+    return Init(device, 16 * framesInFlight, ratios);
+}
 
-    VkResult ret =
-        vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_descriptorPool);
-    if (ret != VK_SUCCESS) {
+bool VulkanDescriptorPool::Init(VkDevice device, uint32_t setsPerPool,
+                                const std::vector<PoolRatio> &ratios)
+{
+    if (device == VK_NULL_HANDLE || setsPerPool == 0 || ratios.empty()) {
         return false;
     }
 
-    return true;
+    Destroy();
+
+    _device = device;
+    _ratios = ratios;
+    _setsPerPool = std::min(setsPerPool, MAX_SETS_PER_POOL);
+
+    // 首个池立即创建，尽早暴露配置错误
+    return nextPool();
 }
 
 bool VulkanDescriptorPool::AllocateDescriptorSets(
     VkDescriptorSetLayout layout, std::vector<VkDescriptorSet> &outSets,
     uint32_t count)
 {
-    if (_descriptorPool == VK_NULL_HANDLE) {
-        return false;
-    }
+    // 每个 set 都需要一个布局
+    std::vector<VkDescriptorSetLayout> layouts(count, layout);
 
     outSets.resize(count);
+    return allocate(layouts, outSets.data());
+}
 
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = _descriptorPool;
-    allocInfo.descriptorSetCount = count;
-    allocInfo.pSetLayouts = &layout;
+bool VulkanDescriptorPool::Allocate(VkDescriptorSetLayout layout,
+                                    VkDescriptorSet &outSet)
+{
+    return allocate({layout}, &outSet);
+}
 
-    VkResult ret =
-        vkAllocateDescriptorSets(_device, &allocInfo, outSets.data());
-    if (ret != VK_SUCCESS) {
-        return false;
+void VulkanDescriptorPool::Reset()
+{
+    for (VkDescriptorPool pool : _usedPools) {
+        vkResetDescriptorPool(_device, pool, 0);
+        _freePools.push_back(pool);
     }
 
+    _usedPools.clear();
+    _currentPool = VK_NULL_HANDLE;
+}
+
+void VulkanDescriptorPool::Destroy()
+{
+    for (VkDescriptorPool pool : _usedPools) {
+        vkDestroyDescriptorPool(_device, pool, nullptr);
+    }
+    for (VkDescriptorPool pool : _freePools) {
+        vkDestroyDescriptorPool(_device, pool, nullptr);
+    }
+
+    _usedPools.clear();
+    _freePools.clear();
+    _currentPool = VK_NULL_HANDLE;
+}
+
+bool VulkanDescriptorPool::nextPool()
+{
+    if (!_freePools.empty()) {
+        _currentPool = _freePools.back();
+        _freePools.pop_back();
+    } else {
+        _currentPool = createPool(_setsPerPool);
+        if (_currentPool == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        // 只有当前池耗尽才会新建，下一个池加倍
+        _setsPerPool = std::min(_setsPerPool * 2, MAX_SETS_PER_POOL);
+    }
+
+    _usedPools.push_back(_currentPool);
     return true;
 }
 
-void VulkanDescriptorPool::FreeDescriptorSets(
-    const std::vector<VkDescriptorSet> &sets)
+VkDescriptorPool VulkanDescriptorPool::createPool(uint32_t setCount)
 {
-    if (_descriptorPool != VK_NULL_HANDLE && !sets.empty()) {
-        vkFreeDescriptorSets(_device, _descriptorPool,
-                             static_cast<uint32_t>(sets.size()), sets.data());
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    poolSizes.reserve(_ratios.size());
+    for (const PoolRatio &ratio : _ratios) {
+        const float count = ratio.ratio * static_cast<float>(setCount);
+        poolSizes.push_back(
+            {ratio.type, std::max(1u, static_cast<uint32_t>(count))});
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = setCount;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(_device, &poolInfo, nullptr, &pool)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建描述符池失败!");
+        return VK_NULL_HANDLE;
     }
+
+    return pool;
 }
 
-void VulkanDescriptorPool::Destroy()
+bool VulkanDescriptorPool::allocate(
+    const std::vector<VkDescriptorSetLayout> &layouts, VkDescriptorSet *outSets)
 {
-    if (_descriptorPool != VK_NULL_HANDLE) {
-        vkDestroyDescriptorPool(_device, _descriptorPool, nullptr);
-        _descriptorPool = VK_NULL_HANDLE;
+    if (layouts.empty()) {
+        return true;
     }
+
+    if (_currentPool == VK_NULL_HANDLE && !nextPool()) {
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _currentPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    VkResult ret = vkAllocateDescriptorSets(_device, &allocInfo, outSets);
+
+    // 当前池耗尽：接上新池重试（新池为空，仍失败说明请求超过单池容量）
+    if (ret == VK_ERROR_OUT_OF_POOL_MEMORY
+        || ret == VK_ERROR_FRAGMENTED_POOL) {
+        if (!nextPool()) {
+            return false;
+        }
+
+        allocInfo.descriptorPool = _currentPool;
+        ret = vkAllocateDescriptorSets(_device, &allocInfo, outSets);
+    }
+
+    if (ret != VK_SUCCESS) {
+        PSG::PrintError("分配描述符集失败!");
+        return false;
+    }
+
+    return true;
 }
 
 } // namespace RHI
@@ -10,55 +10,109 @@ namespace RHI
  * VulkanDescriptorPool
  * --------------------------------
  * 职责：
- *  * 创建 VkDescriptorPool
- *  * 支持多帧 in-flight 分配 DescriptorSet
- *  * 提供 Allocate / Free 接口
+ *  * 管理一串 VkDescriptorPool，当前池耗尽
+ *    （OUT_OF_POOL_MEMORY / FRAGMENTED_POOL）时自动接上新池
+ *  * 新池的容量按 2 倍增长，直到上限
+ *  * Reset 整体重置全部池（每帧一个分配器时，帧开始时批量回收）
  *
  * 不负责：
  *  * 定义 DescriptorSetLayout（交给 VulkanDescriptorSetLayout）
  *  * 更新 DescriptorSet（交给 ResourceManager 或 Renderer）
+ *  * 单个 DescriptorSet 的释放（只支持整体重置）
  */
 class VulkanDescriptorPool
 {
 public:
+    /*
+     * 每种描述符类型的数量 = 池的 set 数 * ratio
+     */
+    struct PoolRatio
+    {
+        VkDescriptorType type;
+        float ratio;
+    };
+
     VulkanDescriptorPool() = default;
 
     ~VulkanDescriptorPool();
 
     /*
-     * 初始化 DescriptorPool
+     * 初始化 DescriptorPool（UBO + 组合图像采样器）
      *
      * @param Vulkan device
-     * @param framesInFlight: 每帧需要多少 DescriptorSet
+     * @param framesInFlight: 首个池按每帧 16 个 set 预估
      */
     bool Init(VkDevice device, uint32_t framesInFlight);
 
     /*
-     * 分配 DescriptorSet
+     * 初始化 DescriptorPool
+     *
+     * @param setsPerPool: 首个池的 set 数
+     * @param ratios: 每个 set 平均包含的各类描述符数量
+     */
+    bool Init(VkDevice device, uint32_t setsPerPool,
+              const std::vector<PoolRatio> &ratios);
+
+    /*
+     * 分配 count 个相同布局的 DescriptorSet
      */
     bool AllocateDescriptorSets(VkDescriptorSetLayout layout,
                                 std::vector<VkDescriptorSet> &outSets,
                                 uint32_t count);
 
     /*
-     * 释放 DescriptorSet（可选，依赖 FREE_DESCRIPTOR_SET_BIT）
+     * 分配一个 DescriptorSet
+     */
+    bool Allocate(VkDescriptorSetLayout layout, VkDescriptorSet &outSet);
+
+    /*
+     * 整体重置全部池，已分配的 DescriptorSet 全部失效
+     * （调用前必须确保 GPU 不再使用它们）
      */
-    void FreeDescriptorSets(const std::vector<VkDescriptorSet> &sets);
+    void Reset();
 
     /*
-     * 销毁 DescriptorPool
+     * 销毁全部 DescriptorPool
      */
     void Destroy();
 
-    VkDescriptorPool Get() const
+    /*
+     * 已创建的池数量
+     */
+    uint32_t GetPoolCount() const
     {
-        return _descriptorPool;
+        return static_cast<uint32_t>(_usedPools.size() + _freePools.size());
     }
 
+private:
+    // 单个池的 set 数上限
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+    // 取一个空闲池（没有时创建）作为当前池
+    bool nextPool();
+
+    VkDescriptorPool createPool(uint32_t setCount);
+
+    // 在当前池中分配，必要时接上新池重试一次
+    bool allocate(const std::vector<VkDescriptorSetLayout> &layouts,
+                  VkDescriptorSet *outSets);
+
 private:
     VkDevice _device = VK_NULL_HANDLE;
 
-    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    std::vector<PoolRatio> _ratios;
+
+    // 下一个新建池的 set 数
+    uint32_t _setsPerPool = 0;
+
+    // 当前分配使用的池（也在 _usedPools 中）
+    VkDescriptorPool _currentPool = VK_NULL_HANDLE;
+
+    // 已分配过的池
+    std::vector<VkDescriptorPool> _usedPools;
+
+    // 已重置、可直接复用的池
+    std::vector<VkDescriptorPool> _freePools;
 };
 
 } // namespace RHI
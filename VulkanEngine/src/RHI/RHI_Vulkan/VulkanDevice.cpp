@@ -70,6 +70,24 @@ bool VulkanDevice::Init(const VulkanPhysicalDevice *physicalDevice)
 
     createInfo.pEnabledFeatures = &deviceFeatures;
 
+    // 时间线信号量（Vulkan 1.2 核心特性），用于帧同步与跨队列同步
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported.pNext = &features12;
+    vkGetPhysicalDeviceFeatures2(phyDevice, &supported);
+    if (!features12.timelineSemaphore) {
+        PSG::PrintError("物理设备不支持时间线信号量!");
+        return false;
+    }
+
+    features12 = {};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = VK_TRUE;
+    createInfo.pNext = &features12;
+
     // 创建逻辑设备
     VkResult ret = vkCreateDevice(phyDevice, &createInfo, nullptr, &_device);
     if (ret != VK_SUCCESS) {
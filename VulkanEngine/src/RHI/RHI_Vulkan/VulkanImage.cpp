@@ -61,57 +61,49 @@ void VulkanImage::TransitionLayout(VkCommandPool commandPool, VkQueue queue,
                                    VkImageLayout newLayout)
 {
     VkCommandBuffer cmd = BeginSingleTimeCommand(_device, commandPool);
+    RecordTransitionLayout(cmd, oldLayout, newLayout);
+    EndSingleTimeCommand(_device, commandPool, queue, cmd);
+}
+
+void VulkanImage::CopyFromBuffer(VkCommandPool commandPool, VkQueue queue,
+                                 VkBuffer buffer, uint32_t width,
+                                 uint32_t height)
+{
+    VkCommandBuffer cmd = BeginSingleTimeCommand(_device, commandPool);
+    RecordCopyFromBuffer(cmd, buffer, width, height);
+    EndSingleTimeCommand(_device, commandPool, queue, cmd);
+}
 
+void VulkanImage::RecordTransitionLayout(VkCommandBuffer cmd,
+                                         VkImageLayout oldLayout,
+                                         VkImageLayout newLayout)
+{
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
     barrier.image = _image;
-    barrier.subresourceRange.aspectMask =
-        (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-            ? VK_IMAGE_ASPECT_DEPTH_BIT
-            : VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.aspectMask = GetFormatAspect(_format);
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = 1;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
-    VkPipelineStageFlags srcStage = 0;
-    VkPipelineStageFlags dstStage = 0;
-
-    // UNDEFINED -> TRANSFER_DST
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED
-        && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    // 访问阶段 / 类型由布局推导，任意布局组合都可转换
+    const ImageLayoutAccess src = GetImageLayoutAccess(oldLayout);
+    const ImageLayoutAccess dst = GetImageLayoutAccess(newLayout);
+    barrier.srcAccessMask = src.access;
+    barrier.dstAccessMask = dst.access;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
-        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    // TRANSFER_DST -> SHADER_READ_ONLY
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-             && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT; // ✅ 关键修正
-        dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else {
-        throw std::runtime_error("Unsupported layout transition!");
-    }
-
-    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1,
-                         &barrier);
-
-    EndSingleTimeCommand(_device, commandPool, queue, cmd);
+    vkCmdPipelineBarrier(cmd, src.stage, dst.stage, 0, 0, nullptr, 0, nullptr,
+                         1, &barrier);
 }
 
-void VulkanImage::CopyFromBuffer(VkCommandPool commandPool, VkQueue queue,
-                                 VkBuffer buffer, uint32_t width,
-                                 uint32_t height)
+void VulkanImage::RecordCopyFromBuffer(VkCommandBuffer cmd, VkBuffer buffer,
+                                       uint32_t width, uint32_t height)
 {
-    VkCommandBuffer cmd = BeginSingleTimeCommand(_device, commandPool);
-
     VkBufferImageCopy region{};
     region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     region.imageSubresource.layerCount = 1;
@@ -119,8 +111,6 @@ void VulkanImage::CopyFromBuffer(VkCommandPool commandPool, VkQueue queue,
 
     vkCmdCopyBufferToImage(cmd, buffer, _image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    EndSingleTimeCommand(_device, commandPool, queue, cmd);
 }
 
 bool VulkanImage::createImageView(VkImageAspectFlags aspectFlags)
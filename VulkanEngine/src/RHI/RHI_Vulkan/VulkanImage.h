@@ -37,6 +37,18 @@ public:
     void CopyFromBuffer(VkCommandPool commandPool, VkQueue queue,
                         VkBuffer buffer, uint32_t width, uint32_t height);
 
+    /**
+     * @brief 在已有命令缓冲区中录制 Layout 转换（由调用者负责提交）
+     */
+    void RecordTransitionLayout(VkCommandBuffer cmd, VkImageLayout oldLayout,
+                                VkImageLayout newLayout);
+
+    /**
+     * @brief 在已有命令缓冲区中录制 Buffer → Image 拷贝
+     */
+    void RecordCopyFromBuffer(VkCommandBuffer cmd, VkBuffer buffer,
+                              uint32_t width, uint32_t height);
+
     void Destroy();
 
     // =========================
@@ -4,11 +4,11 @@ namespace RHI
 {
 VulkanIndexBuffer::VulkanIndexBuffer(VkPhysicalDevice physicalDevice,
                                      VkDevice device, VkCommandPool commandPool,
-                                     VkQueue graphicsQueue,
+                                     VulkanTimeline *timeline,
                                      const void *indexData, VkDeviceSize size,
                                      VkIndexType indexType)
 {
-    Init(physicalDevice, device, commandPool, graphicsQueue, indexData, size,
+    Init(physicalDevice, device, commandPool, timeline, indexData, size,
          indexType);
 }
 
@@ -18,21 +18,25 @@ VulkanIndexBuffer::~VulkanIndexBuffer()
 }
 
 bool VulkanIndexBuffer::Init(VkPhysicalDevice physicalDevice, VkDevice device,
-                             VkCommandPool commandPool, VkQueue graphicsQueue,
-                             const void *indexData, VkDeviceSize size,
-                             VkIndexType indexType)
+                             VkCommandPool commandPool,
+                             VulkanTimeline *timeline, const void *indexData,
+                             VkDeviceSize size, VkIndexType indexType)
 {
     _indexType = indexType;
 
-    // Staging buffer（CPU 可写）
-    VulkanBuffer staging;
-    staging.Init(physicalDevice, device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                     | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    void *data = staging.Map();
+    // Staging buffer（CPU 可写，拷贝完成前由时间线持有）
+    VulkanBuffer *staging = new (std::nothrow) VulkanBuffer();
+    if (nullptr == staging) {
+        return false;
+    }
+    staging->Init(physicalDevice, device, size,
+                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    void *data = staging->Map();
     memcpy(data, indexData, static_cast<size_t>(size));
-    staging.Unmap();
+    staging->Unmap();
 
     // Device local buffer（真正用来画）
     _buffer.Init(physicalDevice, device, size,
@@ -40,12 +44,8 @@ bool VulkanIndexBuffer::Init(VkPhysicalDevice physicalDevice, VkDevice device,
                      | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    // Copy staging -> device local
-    _buffer.CopyFrom(staging, commandPool, graphicsQueue);
-
-    staging.Destroy(); // 可以销毁临时 staging
-
-    return true;
+    // Copy staging -> device local（不阻塞，GPU 完成后释放 staging）
+    return _buffer.CopyFrom(staging, commandPool, timeline) != 0;
 }
 
 void VulkanIndexBuffer::Destroy()
@@ -12,14 +12,19 @@ public:
     VulkanIndexBuffer() = default;
 
     VulkanIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device,
-                      VkCommandPool commandPool, VkQueue graphicsQueue,
+                      VkCommandPool commandPool, VulkanTimeline *timeline,
                       const void *indexData, VkDeviceSize size,
                       VkIndexType indexType);
 
     ~VulkanIndexBuffer();
 
+    /**
+     * @brief 使用 staging buffer 创建索引缓冲
+     *
+     * 拷贝提交到图形时间线，不等待完成，staging 由时间线回收
+     */
     bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
-              VkCommandPool commandPool, VkQueue graphicsQueue,
+              VkCommandPool commandPool, VulkanTimeline *timeline,
               const void *indexData, VkDeviceSize size, VkIndexType indexType);
 
     void Destroy();
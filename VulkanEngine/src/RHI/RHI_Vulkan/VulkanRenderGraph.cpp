@@ -0,0 +1,677 @@
+﻿#include "VulkanRenderGraph.h"
+
+#include <algorithm>
+#include <string>
+
+#include "PrintMsg.h"
+#include "VulkanUtils.h"
+
+namespace RHI
+{
+
+namespace
+{
+// 一次访问对应的布局、阶段、访问类型与所需的图像用途
+struct AccessInfo
+{
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags access = 0;
+    VkImageUsageFlags usage = 0;
+};
+
+AccessInfo getAccessInfo(RenderGraphAccess access, bool write)
+{
+    const VkPipelineStageFlags depthStages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+        | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+    switch (access) {
+    case RenderGraphAccess::ColorAttachment:
+        return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                write ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+                            | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                      : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+    case RenderGraphAccess::DepthAttachment:
+        return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthStages,
+                write ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                            | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                      : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+    case RenderGraphAccess::DepthReadOnly:
+        return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                depthStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                    | VK_ACCESS_SHADER_READ_BIT,
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                    | VK_IMAGE_USAGE_SAMPLED_BIT};
+    case RenderGraphAccess::SampledFragment:
+        return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT};
+    case RenderGraphAccess::SampledCompute:
+        return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT};
+    case RenderGraphAccess::StorageCompute:
+        return {VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                write ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+                      : VK_ACCESS_SHADER_READ_BIT,
+                VK_IMAGE_USAGE_STORAGE_BIT};
+    case RenderGraphAccess::TransferSrc:
+        return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+    case RenderGraphAccess::TransferDst:
+    default:
+        return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+    }
+}
+
+VkImageMemoryBarrier makeBarrier(VkImageLayout oldLayout,
+                                 VkImageLayout newLayout,
+                                 VkAccessFlags srcAccess,
+                                 VkAccessFlags dstAccess,
+                                 VkImageAspectFlags aspect)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+std::string formatBytes(VkDeviceSize bytes)
+{
+    return std::to_string(bytes / 1024) + " KB";
+}
+} // namespace
+
+RenderGraphPass &RenderGraphPass::Read(RenderGraphResource resource,
+                                       RenderGraphAccess access)
+{
+    _accesses.push_back({resource, access, false});
+    return *this;
+}
+
+RenderGraphPass &RenderGraphPass::Write(RenderGraphResource resource,
+                                        RenderGraphAccess access)
+{
+    _accesses.push_back({resource, access, true});
+    return *this;
+}
+
+RenderGraphPass &RenderGraphPass::SideEffect()
+{
+    _sideEffect = true;
+    return *this;
+}
+
+VulkanRenderGraph::VulkanRenderGraph()
+{
+}
+
+VulkanRenderGraph::~VulkanRenderGraph()
+{
+    Destroy();
+}
+
+bool VulkanRenderGraph::Init(VkPhysicalDevice physicalDevice, VkDevice device)
+{
+    if (VK_NULL_HANDLE == physicalDevice || VK_NULL_HANDLE == device) {
+        PSG::PrintError("创建渲染图失败：设备为空!");
+        return false;
+    }
+
+    _physicalDevice = physicalDevice;
+    _device = device;
+    return true;
+}
+
+void VulkanRenderGraph::Reset()
+{
+    destroyTransients();
+
+    _passes.clear();
+    _resources.clear();
+    _finalBarriers.clear();
+    _finalResources.clear();
+    _stats = {};
+    _compiled = false;
+}
+
+void VulkanRenderGraph::Destroy()
+{
+    Reset();
+
+    _physicalDevice = VK_NULL_HANDLE;
+    _device = VK_NULL_HANDLE;
+}
+
+RenderGraphResource
+VulkanRenderGraph::CreateTexture(const std::string &name,
+                                 const RenderGraphTextureDesc &desc)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.desc = desc;
+    resource.aspect = GetFormatAspect(desc.format);
+
+    _resources.push_back(resource);
+    return static_cast<RenderGraphResource>(_resources.size() - 1);
+}
+
+RenderGraphResource VulkanRenderGraph::ImportTexture(
+    const std::string &name, VkImage image, VkImageView imageView,
+    VkFormat format, VkImageLayout initialLayout, VkImageLayout finalLayout)
+{
+    Resource resource{};
+    resource.name = name;
+    resource.imported = true;
+    resource.desc.format = format;
+    resource.aspect = GetFormatAspect(format);
+    resource.image = image;
+    resource.imageView = imageView;
+    resource.initialLayout = initialLayout;
+    resource.finalLayout = finalLayout;
+
+    _resources.push_back(resource);
+    return static_cast<RenderGraphResource>(_resources.size() - 1);
+}
+
+void VulkanRenderGraph::SetImportedTexture(RenderGraphResource resource,
+                                           VkImage image,
+                                           VkImageView imageView)
+{
+    if (resource >= _resources.size() || !_resources[resource].imported) {
+        PSG::PrintError("渲染图：只能更新导入的纹理!");
+        return;
+    }
+
+    _resources[resource].image = image;
+    _resources[resource].imageView = imageView;
+}
+
+RenderGraphPass &
+VulkanRenderGraph::AddPass(const std::string &name,
+                           RenderGraphPass::ExecuteFunc execute)
+{
+    RenderGraphPass &pass = _passes.emplace_back();
+    pass._name = name;
+    pass._execute = std::move(execute);
+    return pass;
+}
+
+bool VulkanRenderGraph::Compile()
+{
+    // 重新编译时先释放上次的瞬态资源
+    destroyTransients();
+    _stats = {};
+
+    for (const auto &pass : _passes) {
+        for (const auto &access : pass._accesses) {
+            if (access.resource >= _resources.size()) {
+                PSG::PrintError("渲染图 Pass \"" + pass._name
+                                + "\" 引用了无效资源!");
+                return false;
+            }
+        }
+    }
+
+    cullPasses();
+
+    if (!allocateTransients()) {
+        destroyTransients();
+        return false;
+    }
+
+    buildBarriers();
+
+    _compiled = true;
+    PSG::PrintMsg(
+        "渲染图",
+        std::to_string(_stats.passCount) + " 个 Pass（剔除 "
+            + std::to_string(_stats.culledPassCount) + "）, 屏障 "
+            + std::to_string(_stats.barrierBatchCount) + " 批 / "
+            + std::to_string(_stats.imageBarrierCount) + " 个, 瞬态显存 "
+            + formatBytes(_stats.allocatedBytes) + " / "
+            + formatBytes(_stats.requiredBytes));
+    return true;
+}
+
+void VulkanRenderGraph::Execute(VkCommandBuffer cmd)
+{
+    if (!_compiled) {
+        PSG::PrintError("渲染图未编译!");
+        return;
+    }
+
+    for (auto &pass : _passes) {
+        if (pass._culled) {
+            continue;
+        }
+
+        // 导入资源的句柄可能每帧变化，执行时再填写
+        if (!pass._barriers.empty()) {
+            for (size_t i = 0; i < pass._barriers.size(); ++i) {
+                pass._barriers[i].image =
+                    _resources[pass._barrierResources[i]].image;
+            }
+            vkCmdPipelineBarrier(
+                cmd, pass._srcStage, pass._dstStage, 0, 0, nullptr, 0,
+                nullptr, static_cast<uint32_t>(pass._barriers.size()),
+                pass._barriers.data());
+        }
+
+        if (pass._execute) {
+            pass._execute(cmd);
+        }
+    }
+
+    if (!_finalBarriers.empty()) {
+        for (size_t i = 0; i < _finalBarriers.size(); ++i) {
+            _finalBarriers[i].image = _resources[_finalResources[i]].image;
+        }
+        vkCmdPipelineBarrier(cmd, _finalSrcStage, _finalDstStage, 0, 0,
+                             nullptr, 0, nullptr,
+                             static_cast<uint32_t>(_finalBarriers.size()),
+                             _finalBarriers.data());
+    }
+}
+
+void VulkanRenderGraph::cullPasses()
+{
+    // 需要保留最新内容的资源：初始为带最终布局的导入资源
+    std::vector<bool> needed(_resources.size(), false);
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        const Resource &resource = _resources[i];
+        needed[i] = resource.imported
+                    && resource.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    // 反向遍历：写入所需资源的 Pass 保留，其读取的资源也变为所需
+    for (auto it = _passes.rbegin(); it != _passes.rend(); ++it) {
+        RenderGraphPass &pass = *it;
+
+        bool live = pass._sideEffect;
+        for (const auto &access : pass._accesses) {
+            live = live || (access.write && needed[access.resource]);
+        }
+
+        pass._culled = !live;
+        if (!live) {
+            ++_stats.culledPassCount;
+            continue;
+        }
+        ++_stats.passCount;
+
+        // 只写不读视为完全覆盖，更早的写入不再需要
+        for (const auto &access : pass._accesses) {
+            if (access.write) {
+                needed[access.resource] = false;
+            }
+        }
+        for (const auto &access : pass._accesses) {
+            if (!access.write) {
+                needed[access.resource] = true;
+            }
+        }
+    }
+}
+
+bool VulkanRenderGraph::allocateTransients()
+{
+    // 生命周期以未剔除 Pass 的执行序号计
+    uint32_t order = 0;
+    for (const auto &pass : _passes) {
+        if (pass._culled) {
+            continue;
+        }
+        for (const auto &access : pass._accesses) {
+            Resource &resource = _resources[access.resource];
+            resource.usage |= getAccessInfo(access.access, access.write).usage;
+            resource.firstPass = std::min(resource.firstPass, order);
+            resource.lastPass = std::max(resource.lastPass, order);
+        }
+        ++order;
+    }
+
+    std::vector<RenderGraphResource> transients;
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        Resource &resource = _resources[i];
+        if (resource.imported || ~0u == resource.firstPass) {
+            continue;
+        }
+
+        if (0 == resource.desc.width || 0 == resource.desc.height) {
+            PSG::PrintError("渲染图纹理 \"" + resource.name + "\" 尺寸无效!");
+            return false;
+        }
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {resource.desc.width, resource.desc.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = resource.desc.format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = resource.usage;
+        imageInfo.samples = resource.desc.samples;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(_device, &imageInfo, nullptr, &resource.image)
+            != VK_SUCCESS) {
+            PSG::PrintError("创建渲染图纹理 \"" + resource.name + "\" 失败!");
+            return false;
+        }
+        vkGetImageMemoryRequirements(_device, resource.image,
+                                     &resource.requirements);
+
+        _stats.requiredBytes += resource.requirements.size;
+        transients.push_back(static_cast<RenderGraphResource>(i));
+    }
+    _stats.transientCount = static_cast<uint32_t>(transients.size());
+
+    // 由大到小放入显存块：生命周期不重叠且内存类型兼容时复用
+    std::sort(transients.begin(), transients.end(),
+              [this](RenderGraphResource a, RenderGraphResource b) {
+                  return _resources[a].requirements.size
+                         > _resources[b].requirements.size;
+              });
+
+    auto overlaps = [this](const Resource &a, RenderGraphResource other) {
+        const Resource &b = _resources[other];
+        return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+    };
+
+    for (RenderGraphResource index : transients) {
+        Resource &resource = _resources[index];
+        const VkMemoryRequirements &req = resource.requirements;
+
+        uint32_t found = ~0u;
+        for (uint32_t b = 0; b < _memoryBlocks.size() && ~0u == found; ++b) {
+            const MemoryBlock &block = _memoryBlocks[b];
+            if (0 == (block.memoryTypeBits & req.memoryTypeBits)
+                || req.size > block.size) {
+                continue;
+            }
+            if (std::none_of(block.resources.begin(), block.resources.end(),
+                             [&](RenderGraphResource other) {
+                                 return overlaps(resource, other);
+                             })) {
+                found = b;
+            }
+        }
+
+        if (~0u == found) {
+            MemoryBlock block{};
+            block.size = req.size;
+            block.memoryTypeBits = req.memoryTypeBits;
+            _memoryBlocks.push_back(block);
+            found = static_cast<uint32_t>(_memoryBlocks.size() - 1);
+        }
+
+        MemoryBlock &block = _memoryBlocks[found];
+        block.memoryTypeBits &= req.memoryTypeBits;
+        block.resources.push_back(index);
+        resource.memoryBlock = found;
+    }
+
+    // 每个块一次分配，块内资源都绑定在偏移 0
+    for (auto &block : _memoryBlocks) {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = block.size;
+        allocInfo.memoryTypeIndex =
+            FindMemoryType(_physicalDevice, block.memoryTypeBits,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (vkAllocateMemory(_device, &allocInfo, nullptr, &block.memory)
+            != VK_SUCCESS) {
+            PSG::PrintError("分配渲染图显存失败!");
+            return false;
+        }
+        _stats.allocatedBytes += block.size;
+
+        for (RenderGraphResource index : block.resources) {
+            Resource &resource = _resources[index];
+            vkBindImageMemory(_device, resource.image, block.memory, 0);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = resource.image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = resource.desc.format;
+            viewInfo.subresourceRange.aspectMask = resource.aspect;
+            viewInfo.subresourceRange.baseMipLevel = 0;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+
+            if (vkCreateImageView(_device, &viewInfo, nullptr,
+                                  &resource.imageView)
+                != VK_SUCCESS) {
+                PSG::PrintError("创建渲染图纹理视图 \"" + resource.name
+                                + "\" 失败!");
+                return false;
+            }
+        }
+    }
+    _stats.memoryBlockCount = static_cast<uint32_t>(_memoryBlocks.size());
+
+    return true;
+}
+
+void VulkanRenderGraph::buildBarriers()
+{
+    std::vector<ResourceState> states(_resources.size());
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        const Resource &resource = _resources[i];
+        if (resource.imported) {
+            const ImageLayoutAccess initial =
+                GetImageLayoutAccess(resource.initialLayout);
+            states[i].layout = resource.initialLayout;
+            states[i].stage = initial.stage;
+            states[i].access = initial.access;
+            states[i].touched = true;
+        }
+    }
+
+    // 同一 Pass 对同一资源的多次访问合并为一个状态
+    struct MergedAccess
+    {
+        RenderGraphResource resource = RENDER_GRAPH_INVALID;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage = 0;
+        VkAccessFlags access = 0;
+        bool write = false;
+    };
+    std::vector<MergedAccess> merged;
+
+    // 每个显存块中第一个被使用的资源：其首次使用的屏障（所在 Pass 与下标）
+    struct BlockFirstUse
+    {
+        RenderGraphPass *pass = nullptr;
+        size_t barrier = 0;
+    };
+    std::vector<BlockFirstUse> firstUses(_memoryBlocks.size());
+
+    for (auto &pass : _passes) {
+        pass._barriers.clear();
+        pass._barrierResources.clear();
+        pass._srcStage = 0;
+        pass._dstStage = 0;
+        if (pass._culled) {
+            continue;
+        }
+
+        merged.clear();
+        for (const auto &access : pass._accesses) {
+            const AccessInfo info = getAccessInfo(access.access, access.write);
+            auto it = std::find_if(merged.begin(), merged.end(),
+                                   [&](const MergedAccess &m) {
+                                       return m.resource == access.resource;
+                                   });
+            if (it == merged.end()) {
+                merged.push_back({access.resource, info.layout, info.stage,
+                                  info.access, access.write});
+                continue;
+            }
+            it->stage |= info.stage;
+            it->access |= info.access;
+            if (access.write) {
+                it->layout = info.layout;
+                it->write = true;
+            }
+        }
+
+        for (const auto &m : merged) {
+            const Resource &resource = _resources[m.resource];
+            ResourceState &state = states[m.resource];
+
+            // 瞬态资源首次使用：等待同一显存块上一个资源的访问结束
+            bool firstInBlock = false;
+            if (!state.touched) {
+                const MemoryBlock &block = _memoryBlocks[resource.memoryBlock];
+                firstInBlock = nullptr == firstUses[resource.memoryBlock].pass;
+                state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                state.stage = block.lastStage;
+                state.access = block.lastAccess;
+                state.write = true;
+                state.touched = true;
+            }
+
+            // 以 UNDEFINED 导入的资源（如刚获取的交换链图像）：源阶段取首次
+            // 使用的阶段，与等待在该阶段的信号量构成依赖链
+            if (resource.imported
+                && VK_IMAGE_LAYOUT_UNDEFINED == state.layout) {
+                state.stage = m.stage;
+            }
+
+            // 布局不变的连续读取不需要屏障，只累加读取阶段
+            if (state.layout == m.layout && !state.write && !m.write) {
+                state.stage |= m.stage;
+                state.access |= m.access;
+            } else {
+                if (firstInBlock) {
+                    firstUses[resource.memoryBlock] = {&pass,
+                                                       pass._barriers.size()};
+                }
+                pass._barriers.push_back(
+                    makeBarrier(state.layout, m.layout,
+                                state.write ? state.access : 0, m.access,
+                                resource.aspect));
+                pass._barrierResources.push_back(m.resource);
+                pass._srcStage |= state.stage;
+                pass._dstStage |= m.stage;
+
+                state.layout = m.layout;
+                state.stage = m.stage;
+                state.access = m.access;
+                state.write = m.write;
+            }
+
+            if (!resource.imported) {
+                MemoryBlock &block = _memoryBlocks[resource.memoryBlock];
+                block.lastStage = state.stage;
+                block.lastAccess = state.access;
+            }
+        }
+
+        if (!pass._barriers.empty()) {
+            ++_stats.barrierBatchCount;
+            _stats.imageBarrierCount +=
+                static_cast<uint32_t>(pass._barriers.size());
+        }
+    }
+
+    // 瞬态资源在多帧间共享同一显存，上一帧的命令可能仍在执行：
+    // 块内第一个资源的首次屏障还要等待上一次 Execute 中该块的最后访问。
+    // 同一队列上屏障的源作用域包含之前提交的全部命令，因此首帧也成立
+    for (size_t i = 0; i < firstUses.size(); ++i) {
+        const BlockFirstUse &first = firstUses[i];
+        if (nullptr == first.pass) {
+            continue;
+        }
+        first.pass->_srcStage |= _memoryBlocks[i].lastStage;
+        first.pass->_barriers[first.barrier].srcAccessMask |=
+            _memoryBlocks[i].lastAccess;
+    }
+
+    // 导入资源转换到最终布局
+    _finalBarriers.clear();
+    _finalResources.clear();
+    _finalSrcStage = 0;
+    _finalDstStage = 0;
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        const Resource &resource = _resources[i];
+        const ResourceState &state = states[i];
+        if (!resource.imported
+            || VK_IMAGE_LAYOUT_UNDEFINED == resource.finalLayout
+            || (state.layout == resource.finalLayout && !state.write)) {
+            continue;
+        }
+
+        const ImageLayoutAccess final =
+            GetImageLayoutAccess(resource.finalLayout);
+        _finalBarriers.push_back(makeBarrier(state.layout, resource.finalLayout,
+                                             state.write ? state.access : 0,
+                                             final.access, resource.aspect));
+        _finalResources.push_back(static_cast<RenderGraphResource>(i));
+        _finalSrcStage |= state.stage;
+        _finalDstStage |= final.stage;
+    }
+
+    if (!_finalBarriers.empty()) {
+        ++_stats.barrierBatchCount;
+        _stats.imageBarrierCount +=
+            static_cast<uint32_t>(_finalBarriers.size());
+    }
+}
+
+void VulkanRenderGraph::destroyTransients()
+{
+    for (auto &resource : _resources) {
+        if (resource.imported) {
+            continue;
+        }
+        if (resource.imageView != VK_NULL_HANDLE) {
+            vkDestroyImageView(_device, resource.imageView, nullptr);
+            resource.imageView = VK_NULL_HANDLE;
+        }
+        if (resource.image != VK_NULL_HANDLE) {
+            vkDestroyImage(_device, resource.image, nullptr);
+            resource.image = VK_NULL_HANDLE;
+        }
+        resource.usage = 0;
+        resource.firstPass = ~0u;
+        resource.lastPass = 0;
+        resource.memoryBlock = ~0u;
+    }
+
+    for (auto &block : _memoryBlocks) {
+        if (block.memory != VK_NULL_HANDLE) {
+            vkFreeMemory(_device, block.memory, nullptr);
+        }
+    }
+    _memoryBlocks.clear();
+
+    _compiled = false;
+}
+
+} // namespace RHI
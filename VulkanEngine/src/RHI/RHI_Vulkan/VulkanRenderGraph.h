@@ -0,0 +1,287 @@
+﻿#ifndef VULKANRENDERGRAPH_H_
+#define VULKANRENDERGRAPH_H_
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "VulkanHeadRHI.h"
+
+namespace RHI
+{
+
+/// 渲染图中的资源句柄（VulkanRenderGraph 内的下标）
+using RenderGraphResource = uint32_t;
+
+constexpr RenderGraphResource RENDER_GRAPH_INVALID = ~0u;
+
+/**
+ * @brief Pass 访问资源的方式，决定布局、阶段与访问类型
+ */
+enum class RenderGraphAccess : uint32_t
+{
+    ColorAttachment,   // 颜色附件
+    DepthAttachment,   // 深度附件（测试 + 写入）
+    DepthReadOnly,     // 只读深度（测试或采样）
+    SampledFragment,   // 片段着色器采样
+    SampledCompute,    // 计算着色器采样
+    StorageCompute,    // 计算着色器存储图像
+    TransferSrc,       // 拷贝源
+    TransferDst,       // 拷贝目标
+};
+
+/**
+ * @brief 瞬态纹理描述（由渲染图创建并管理内存）
+ */
+struct RenderGraphTextureDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+};
+
+/**
+ * @brief 编译结果统计
+ */
+struct RenderGraphStats
+{
+    uint32_t passCount = 0;
+    uint32_t culledPassCount = 0;
+
+    // 屏障批次（一次 vkCmdPipelineBarrier）与其中的图像屏障数
+    uint32_t barrierBatchCount = 0;
+    uint32_t imageBarrierCount = 0;
+
+    uint32_t transientCount = 0;
+    uint32_t memoryBlockCount = 0;
+
+    // 瞬态资源需求总量与别名复用后实际分配的显存
+    VkDeviceSize requiredBytes = 0;
+    VkDeviceSize allocatedBytes = 0;
+};
+
+class VulkanRenderGraph;
+
+/**
+ * @brief 渲染图中的一个 Pass
+ *
+ * 声明读写的资源，执行回调只负责录制命令（不需要手动插入屏障）
+ */
+class RenderGraphPass
+{
+public:
+    using ExecuteFunc = std::function<void(VkCommandBuffer cmd)>;
+
+    RenderGraphPass &Read(RenderGraphResource resource,
+                          RenderGraphAccess access);
+
+    RenderGraphPass &Write(RenderGraphResource resource,
+                           RenderGraphAccess access);
+
+    /**
+     * @brief 标记为有副作用（写入图外部的缓冲等），不会被剔除
+     */
+    RenderGraphPass &SideEffect();
+
+    const std::string &GetName() const
+    {
+        return _name;
+    }
+
+    bool IsCulled() const
+    {
+        return _culled;
+    }
+
+private:
+    friend class VulkanRenderGraph;
+
+    struct Access
+    {
+        RenderGraphResource resource = RENDER_GRAPH_INVALID;
+        RenderGraphAccess access = RenderGraphAccess::SampledFragment;
+        bool write = false;
+    };
+
+    std::string _name;
+
+    ExecuteFunc _execute;
+
+    std::vector<Access> _accesses;
+
+    bool _sideEffect = false;
+
+    bool _culled = false;
+
+    // 编译结果：执行前的一批屏障（image 字段在执行时填写）
+    std::vector<VkImageMemoryBarrier> _barriers;
+    std::vector<RenderGraphResource> _barrierResources;
+    VkPipelineStageFlags _srcStage = 0;
+    VkPipelineStageFlags _dstStage = 0;
+};
+
+/**
+ * @brief VulkanRenderGraph
+ *
+ * 帧图：
+ * - Pass 按添加顺序执行，只声明读写，不手动同步
+ * - Compile 时从输出（带最终布局的导入资源、有副作用的 Pass）反向剔除
+ *   无用的 Pass
+ * - 按资源状态推导屏障，每个 Pass 前合并为一次 vkCmdPipelineBarrier，
+ *   连续只读且布局不变时不插入屏障
+ * - 瞬态纹理按生命周期区间复用显存块（别名），互不重叠的资源共享内存
+ * - 图结构不变时只需 Compile 一次，每帧 Execute；导入资源（交换链图像等）
+ *   可在每帧执行前更新句柄
+ */
+class VulkanRenderGraph
+{
+public:
+    VulkanRenderGraph();
+
+    ~VulkanRenderGraph();
+
+public:
+    bool Init(VkPhysicalDevice physicalDevice, VkDevice device);
+
+    /**
+     * @brief 清空 Pass 与资源，并释放瞬态资源
+     */
+    void Reset();
+
+    void Destroy();
+
+    /**
+     * @brief 声明瞬态纹理（用途由各 Pass 的访问方式推导）
+     */
+    RenderGraphResource CreateTexture(const std::string &name,
+                                      const RenderGraphTextureDesc &desc);
+
+    /**
+     * @brief 导入外部纹理
+     * @param initialLayout 图开始时的布局
+     * @param finalLayout 图结束时需要的布局，UNDEFINED 表示不是输出
+     */
+    RenderGraphResource ImportTexture(const std::string &name, VkImage image,
+                                      VkImageView imageView, VkFormat format,
+                                      VkImageLayout initialLayout,
+                                      VkImageLayout finalLayout);
+
+    /**
+     * @brief 更新导入纹理的句柄（如本帧的交换链图像）
+     */
+    void SetImportedTexture(RenderGraphResource resource, VkImage image,
+                            VkImageView imageView);
+
+    /**
+     * @brief 添加 Pass（按添加顺序执行）
+     */
+    RenderGraphPass &AddPass(const std::string &name,
+                             RenderGraphPass::ExecuteFunc execute);
+
+    /**
+     * @brief 剔除、分配瞬态资源并生成屏障
+     */
+    bool Compile();
+
+    /**
+     * @brief 录制全部未剔除的 Pass
+     */
+    void Execute(VkCommandBuffer cmd);
+
+    VkImage GetImage(RenderGraphResource resource) const
+    {
+        return _resources[resource].image;
+    }
+
+    VkImageView GetImageView(RenderGraphResource resource) const
+    {
+        return _resources[resource].imageView;
+    }
+
+    const RenderGraphStats &GetStats() const
+    {
+        return _stats;
+    }
+
+private:
+    struct Resource
+    {
+        std::string name;
+        bool imported = false;
+        RenderGraphTextureDesc desc;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView imageView = VK_NULL_HANDLE;
+
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        // 编译结果
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = ~0u;
+        uint32_t lastPass = 0;
+        uint32_t memoryBlock = ~0u;
+        VkMemoryRequirements requirements{};
+    };
+
+    // 别名复用的显存块，块内资源生命周期互不重叠
+    struct MemoryBlock
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        uint32_t memoryTypeBits = ~0u;
+        std::vector<RenderGraphResource> resources;
+
+        // 编译时记录块内上一个资源的最后访问，用于别名切换的屏障；
+        // 编译结束时为块的最终访问，作为下一次执行首个屏障的源
+        VkPipelineStageFlags lastStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags lastAccess = 0;
+    };
+
+    // 编译期间的资源状态
+    struct ResourceState
+    {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags access = 0;
+        bool write = false;
+        bool touched = false;
+    };
+
+    void cullPasses();
+
+    bool allocateTransients();
+
+    void buildBarriers();
+
+    void destroyTransients();
+
+private:
+    VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
+
+    VkDevice _device = VK_NULL_HANDLE;
+
+    // deque 保证 AddPass 返回的引用在继续添加时有效
+    std::deque<RenderGraphPass> _passes;
+
+    std::vector<Resource> _resources;
+
+    std::vector<MemoryBlock> _memoryBlocks;
+
+    // 图结束时导入资源转换到最终布局
+    std::vector<VkImageMemoryBarrier> _finalBarriers;
+    std::vector<RenderGraphResource> _finalResources;
+    VkPipelineStageFlags _finalSrcStage = 0;
+    VkPipelineStageFlags _finalDstStage = 0;
+
+    RenderGraphStats _stats;
+
+    bool _compiled = false;
+};
+
+} // namespace RHI
+
+#endif // !VULKANRENDERGRAPH_H_
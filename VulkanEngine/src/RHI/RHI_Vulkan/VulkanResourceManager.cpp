@@ -1,14 +1,33 @@
 ﻿#include "VulkanResourceManager.h"
 
+#include <algorithm>
+
 namespace RHI
 {
 
+namespace
+{
+// 从存储中移除 resource，不属于该存储时返回 false
+template <typename T>
+bool removeResource(std::vector<T *> &resources, T *resource)
+{
+    auto it = std::find(resources.begin(), resources.end(), resource);
+    if (it == resources.end()) {
+        return false;
+    }
+
+    resources.erase(it);
+    return true;
+}
+} // namespace
+
 VulkanResourceManager::VulkanResourceManager()
     : _context(nullptr)
     , _framesInFlight(0)
     , _descriptorSetLayout(nullptr)
     , _descriptorPool(nullptr)
     , _defaultSampler(nullptr)
+    , _descriptorCache(nullptr)
 {
 }
 
@@ -52,6 +71,18 @@ bool VulkanResourceManager::Init(VulkanContext *context,
         return false;
     }
 
+    // ---------- 创建每帧 DescriptorPool ----------
+    if (!createFramePools(_framesInFlight)) {
+        return false;
+    }
+
+    // ---------- 创建 DescriptorSet 缓存 ----------
+    _descriptorCache = new VulkanDescriptorCache();
+    ret = _descriptorCache->Init(_context->GetVkDevice());
+    if (!ret) {
+        return false;
+    }
+
     // ---------- 创建默认 Sampler ----------
     _defaultSampler = new VulkanSampler();
     ret = _defaultSampler->Init(_context->GetVkPhysicalDevice(),
@@ -82,6 +113,14 @@ void VulkanResourceManager::Shutdown()
     }
     _textures.clear();
 
+    // 缓存的 set 引用上面的资源，随资源一起失效
+    SDelete(_descriptorCache);
+
+    for (auto pool : _framePools) {
+        SDelete(pool);
+    }
+    _framePools.clear();
+
     SDelete(_descriptorPool);
     SDelete(_descriptorSetLayout);
     SDelete(_defaultSampler);
@@ -101,8 +140,8 @@ VulkanVertexBuffer *VulkanResourceManager::CreateVertexBuffer(const void *data,
 
     VulkanVertexBuffer *vb = new VulkanVertexBuffer(
         _context->GetVkPhysicalDevice(), _context->GetVkDevice(),
-        _context->GetVkCommandPool(), _context->GetGraphicsQueue(), data, size,
-        stride);
+        _context->GetVkCommandPool(), _context->GetGraphicsTimeline(), data,
+        size, stride);
 
     _vertexBuffers.push_back(vb);
     return vb;
@@ -118,8 +157,8 @@ VulkanResourceManager::CreateIndexBuffer(const void *data, uint32_t size,
 
     VulkanIndexBuffer *ib = new VulkanIndexBuffer(
         _context->GetVkPhysicalDevice(), _context->GetVkDevice(),
-        _context->GetVkCommandPool(), _context->GetGraphicsQueue(), data, size,
-        indexType);
+        _context->GetVkCommandPool(), _context->GetGraphicsTimeline(), data,
+        size, indexType);
 
     _indexBuffers.push_back(ib);
     return ib;
@@ -153,10 +192,10 @@ VulkanTexture *VulkanResourceManager::CreateTexture(const char *filePath,
 
     VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
 
-    VulkanTexture *tex =
-        new VulkanTexture(_context->GetVkPhysicalDevice(),
-                          _context->GetVkDevice(), _context->GetVkCommandPool(),
-                          _context->GetGraphicsQueue(), filePath, sampleCount);
+    VulkanTexture *tex = new VulkanTexture(
+        _context->GetVkPhysicalDevice(), _context->GetVkDevice(),
+        _context->GetVkCommandPool(), _context->GetGraphicsTimeline(), filePath,
+        sampleCount);
 
     // 自动更新 DescriptorSet
     UpdateTextureDescriptor(tex, 1);
@@ -165,11 +204,84 @@ VulkanTexture *VulkanResourceManager::CreateTexture(const char *filePath,
     return tex;
 }
 
+// -------- Buffer / Texture 销毁 --------
+void VulkanResourceManager::DestroyVertexBuffer(VulkanVertexBuffer *vb)
+{
+    if (nullptr == vb || !removeResource(_vertexBuffers, vb)) {
+        return;
+    }
+
+    _descriptorCache->InvalidateBuffer(vb->Get());
+    _context->GetGraphicsTimeline()->Retire([vb]() { delete vb; });
+}
+
+void VulkanResourceManager::DestroyIndexBuffer(VulkanIndexBuffer *ib)
+{
+    if (nullptr == ib || !removeResource(_indexBuffers, ib)) {
+        return;
+    }
+
+    _descriptorCache->InvalidateBuffer(ib->Get());
+    _context->GetGraphicsTimeline()->Retire([ib]() { delete ib; });
+}
+
+void VulkanResourceManager::DestroyUniformBuffer(VulkanUniformBuffer *ub)
+{
+    if (nullptr == ub || !removeResource(_uniformBuffers, ub)) {
+        return;
+    }
+
+    _descriptorCache->InvalidateBuffer(ub->Get());
+    _context->GetGraphicsTimeline()->Retire([ub]() { delete ub; });
+}
+
+void VulkanResourceManager::DestroyTexture(VulkanTexture *tex)
+{
+    if (nullptr == tex || !removeResource(_textures, tex)) {
+        return;
+    }
+
+    _descriptorCache->InvalidateImageView(tex->GetImageView());
+    _context->GetGraphicsTimeline()->Retire([tex]() { delete tex; });
+}
+
+// -------- DescriptorSet 分配 --------
+void VulkanResourceManager::BeginFrame(uint32_t frameIndex)
+{
+    if (frameIndex < _framePools.size()) {
+        _framePools[frameIndex]->Reset();
+    }
+}
+
+bool VulkanResourceManager::AllocateFrameSet(uint32_t frameIndex,
+                                             VkDescriptorSetLayout layout,
+                                             VkDescriptorSet &outSet)
+{
+    if (frameIndex >= _framePools.size()) {
+        return false;
+    }
+
+    return _framePools[frameIndex]->Allocate(layout, outSet);
+}
+
+VkDescriptorSet VulkanResourceManager::GetDescriptorSet(
+    VkDescriptorSetLayout layout, const std::vector<DescriptorWrite> &writes)
+{
+    if (nullptr == _descriptorCache) {
+        return VK_NULL_HANDLE;
+    }
+
+    return _descriptorCache->Get(layout, writes);
+}
+
 // -------- Swapchain 重建 --------
 void VulkanResourceManager::OnSwapchainRecreated(uint32_t framesInFlight)
 {
     _framesInFlight = framesInFlight;
 
+    // 帧数增加时补齐每帧的 DescriptorPool
+    createFramePools(framesInFlight);
+
     for (auto ub : _uniformBuffers) {
         if (ub) {
             // ub->Recreate(_context->GetVkDevice(), framesInFlight);
@@ -178,6 +290,21 @@ void VulkanResourceManager::OnSwapchainRecreated(uint32_t framesInFlight)
     }
 }
 
+// -------- 私有接口：创建每帧 DescriptorPool --------
+bool VulkanResourceManager::createFramePools(uint32_t framesInFlight)
+{
+    while (_framePools.size() < framesInFlight) {
+        VulkanDescriptorPool *pool = new VulkanDescriptorPool();
+        if (!pool->Init(_context->GetVkDevice(), 1)) {
+            SDelete(pool);
+            return false;
+        }
+        _framePools.push_back(pool);
+    }
+
+    return true;
+}
+
 // -------- 私有接口：更新 DescriptorSet --------
 void VulkanResourceManager::UpdateUniformBufferDescriptor(
     VulkanUniformBuffer *ub, uint32_t binding)
@@ -2,6 +2,7 @@
 #define VULKANRESOURCEMANAGER_H_
 
 #include "VulkanContext.h"
+#include "VulkanDescriptorCache.h"
 #include "VulkanDescriptorPool.h"
 #include "VulkanDescriptorSetLayout.h"
 #include "VulkanIndexBuffer.h"
@@ -21,6 +22,8 @@ namespace RHI
  * 职责：
  *  * 管理 Vulkan GPU 资源的创建与销毁
  *  * 统一管理 DescriptorSetLayout / DescriptorPool / Sampler
+ *  * 每帧一个可增长的 DescriptorPool，帧开始时整体重置
+ *  * 按 布局 + 绑定资源 缓存不可变的材质 DescriptorSet
  *  * 支持多帧 in-flight UniformBuffer 和 DescriptorSet
  *  * 自动在 Swapchain 重建时刷新相关资源
  *
@@ -54,6 +57,16 @@ public:
 
     VulkanTexture *CreateTexture(const char *filePath, bool generateMipmaps);
 
+    // -------- Buffer / Texture 销毁接口 --------
+    // 引用该资源的缓存 DescriptorSet 立即失效，对象在 GPU 用完后释放
+    void DestroyVertexBuffer(VulkanVertexBuffer *vb);
+
+    void DestroyIndexBuffer(VulkanIndexBuffer *ib);
+
+    void DestroyUniformBuffer(VulkanUniformBuffer *ub);
+
+    void DestroyTexture(VulkanTexture *tex);
+
     // -------- Descriptor 访问 --------
     VulkanSampler *GetDefaultSampler() const
     {
@@ -70,10 +83,31 @@ public:
         return _descriptorPool;
     }
 
+    // 帧开始时调用：重置该帧的 DescriptorPool
+    // （调用前必须确保该帧上一轮提交的命令已执行完）
+    void BeginFrame(uint32_t frameIndex);
+
+    // 从该帧的 DescriptorPool 分配临时 DescriptorSet（只在本帧有效）
+    bool AllocateFrameSet(uint32_t frameIndex, VkDescriptorSetLayout layout,
+                          VkDescriptorSet &outSet);
+
+    // 获取绑定了 writes 的不可变 DescriptorSet（相同绑定复用同一个 set）
+    VkDescriptorSet
+    GetDescriptorSet(VkDescriptorSetLayout layout,
+                     const std::vector<DescriptorWrite> &writes);
+
+    VulkanDescriptorCache *GetDescriptorCache() const
+    {
+        return _descriptorCache;
+    }
+
     // 当 Swapchain 重建时调用
     void OnSwapchainRecreated(uint32_t framesInFlight);
 
 private:
+    // 补齐每帧的 DescriptorPool
+    bool createFramePools(uint32_t framesInFlight);
+
     // 更新 UniformBuffer / Texture 的 DescriptorSet
     void UpdateUniformBufferDescriptor(VulkanUniformBuffer *ub,
                                        uint32_t binding);
@@ -89,6 +123,12 @@ private:
     VulkanDescriptorPool *_descriptorPool = nullptr;
     VulkanSampler *_defaultSampler = nullptr;
 
+    // 每帧临时 DescriptorSet 的分配器
+    std::vector<VulkanDescriptorPool *> _framePools;
+
+    // 不可变 DescriptorSet 缓存
+    VulkanDescriptorCache *_descriptorCache = nullptr;
+
     // -------- Resource Storage --------
     std::vector<VulkanVertexBuffer *> _vertexBuffers;
     std::vector<VulkanIndexBuffer *> _indexBuffers;
@@ -41,6 +41,11 @@ bool VulkanSwapchain::Init(VulkanPhysicalDevice *physicalDevice,
     // 选择最终的分辨率
     VkExtent2D extent = chooseExtent(support.capabilities, width, height);
 
+    // 窗口最小化时 Surface 分辨率为 0，无法创建交换链
+    if (0 == extent.width || 0 == extent.height) {
+        return false;
+    }
+
     // 交换链图像数量
     uint32_t imageCount = support.capabilities.minImageCount;
 
@@ -61,6 +66,13 @@ bool VulkanSwapchain::Init(VulkanPhysicalDevice *physicalDevice,
     createInfo.imageArrayLayers = 1;
     createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+    // 支持时允许拷贝写入（渲染图把离屏结果拷贝到交换链图像）
+    if (support.capabilities.supportedUsageFlags
+        & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+        createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        _transferDst = true;
+    }
+
     uint32_t graphicsQueueFamily = physicalDevice->GetGraphicsQueueFamily();
     uint32_t presentQueueFamily = physicalDevice->GetPresentQueueFamily();
 
@@ -133,6 +145,8 @@ void VulkanSwapchain::Destroy()
         vkDestroySwapchainKHR(_device, _swapchain, nullptr);
         _swapchain = VK_NULL_HANDLE;
     }
+    _images.clear();
+    _transferDst = false;
 }
 
 SupportDetails VulkanSwapchain::querySupport(VkPhysicalDevice device,
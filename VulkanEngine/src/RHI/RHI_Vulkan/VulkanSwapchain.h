@@ -60,6 +60,22 @@ public:
         return _extent;
     }
 
+    /**
+     * @brief 交换链图像
+     */
+    const std::vector<VkImage> &GetImages() const
+    {
+        return _images;
+    }
+
+    /**
+     * @brief 交换链图像是否可作为拷贝目标
+     */
+    bool SupportsTransferDst() const
+    {
+        return _transferDst;
+    }
+
     /**
      * @brief 交换链图像对应的图像视图
      */
@@ -165,6 +181,9 @@ private:
 
     // 与交换链图像一一对应的图像视图（用于作为渲染目标）
     std::vector<VkImageView> _imageViews;
+
+    // 交换链图像是否带 TRANSFER_DST 用途
+    bool _transferDst = false;
 };
 
 } // namespace RHI
@@ -13,7 +13,8 @@ VulkanSync::~VulkanSync()
     Destroy();
 }
 
-bool VulkanSync::Init(VkDevice device, uint32_t maxFrames)
+bool VulkanSync::Init(VkDevice device, VkQueue graphicsQueue,
+                      uint32_t maxFrames)
 {
     if (VK_NULL_HANDLE == device) {
         PSG::PrintError("创建同步对象失败：逻辑设备为空!");
@@ -23,19 +24,14 @@ bool VulkanSync::Init(VkDevice device, uint32_t maxFrames)
     // 为每个并行帧创建一组同步对象
     _imageAvailable.resize(maxFrames);
     _renderFinished.resize(maxFrames);
-    _inFlightFences.resize(maxFrames);
+    _frameValues.assign(maxFrames, 0);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    // Fence 初始为 signaled，避免第一帧 CPU 等待
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
     for (uint32_t i = 0; i < maxFrames; ++i) {
 
-        // ImageAvailable + RenderFinished + InFlightFence
+        // ImageAvailable + RenderFinished（交换链只接受二值信号量）
         VkResult ret = vkCreateSemaphore(device, &semaphoreInfo, nullptr,
                                          &_imageAvailable[i]);
         if (ret != VK_SUCCESS) {
@@ -49,12 +45,11 @@ bool VulkanSync::Init(VkDevice device, uint32_t maxFrames)
             PSG::PrintError("创建同步对象失败!");
             return false;
         }
+    }
 
-        ret = vkCreateFence(device, &fenceInfo, nullptr, &_inFlightFences[i]);
-        if (ret != VK_SUCCESS) {
-            PSG::PrintError("创建同步对象失败!");
-            return false;
-        }
+    // 时间线初始值为 0，第一帧不需要等待
+    if (!_graphicsTimeline.Init(device, graphicsQueue)) {
+        return false;
     }
 
     _device = device;
@@ -68,6 +63,9 @@ void VulkanSync::Destroy()
         return;
     }
 
+    // 先等待 GPU 完成全部提交，再销毁信号量
+    _graphicsTimeline.Destroy();
+
     // 销毁所有同步对象
     for (uint32_t i = 0; i < _maxFrames; ++i) {
         if (_imageAvailable[i]) {
@@ -77,16 +75,42 @@ void VulkanSync::Destroy()
         if (_renderFinished[i]) {
             vkDestroySemaphore(_device, _renderFinished[i], nullptr);
         }
-
-        if (_inFlightFences[i]) {
-            vkDestroyFence(_device, _inFlightFences[i], nullptr);
-        }
     }
 
     _maxFrames = 0;
     _imageAvailable.clear();
     _renderFinished.clear();
-    _inFlightFences.clear();
+    _frameValues.clear();
+}
+
+bool VulkanSync::WaitFrame(uint32_t frame)
+{
+    if (!_graphicsTimeline.Wait(_frameValues[frame])) {
+        PSG::PrintError("等待帧完成失败!");
+        return false;
+    }
+
+    _graphicsTimeline.Collect();
+    return true;
+}
+
+uint64_t
+VulkanSync::SubmitFrame(uint32_t frame,
+                        const std::vector<VkCommandBuffer> &commandBuffers,
+                        const std::vector<TimelineWait> &waits,
+                        VkPipelineStageFlags waitStage)
+{
+    BinarySemaphores binary;
+    binary.wait = _imageAvailable[frame];
+    binary.waitStage = waitStage;
+    binary.signal = _renderFinished[frame];
+
+    const uint64_t value =
+        _graphicsTimeline.Submit(commandBuffers, waits, binary);
+    if (value != 0) {
+        _frameValues[frame] = value;
+    }
+    return value;
 }
 
 VkSemaphore VulkanSync::GetImageAvailable(uint32_t frame) const
@@ -99,9 +123,9 @@ VkSemaphore VulkanSync::GetRenderFinished(uint32_t frame) const
     return _renderFinished[frame];
 }
 
-VkFence VulkanSync::GetInFlightFence(uint32_t frame) const
+uint64_t VulkanSync::GetFrameValue(uint32_t frame) const
 {
-    return _inFlightFences[frame];
+    return _frameValues[frame];
 }
 
 } // namespace RHI
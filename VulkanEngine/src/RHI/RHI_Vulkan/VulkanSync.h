@@ -1,7 +1,7 @@
 ﻿#ifndef VULKANSYNC_H_
 #define VULKANSYNC_H_
 
-#include "VulkanHeadRHI.h"
+#include "VulkanTimeline.h"
 
 namespace RHI
 {
@@ -13,7 +13,8 @@ namespace RHI
  * 负责：
  * - ImageAvailable Semaphore：等待 Swapchain Image 可用
  * - RenderFinished Semaphore：等待渲染完成后再 Present
- * - InFlight Fence：CPU 等待 GPU 完成一帧
+ * - 图形队列时间线：每帧记录提交时 Signal 的值，
+ *   CPU 复用该帧资源前等待这个值（代替每帧一个 Fence）
  *
  */
 class VulkanSync
@@ -27,23 +28,48 @@ public:
     /**
      * @brief 创建同步对象
      * @param device 逻辑设备
+     * @param graphicsQueue 图形队列（时间线所属队列）
      * @param maxFrames 最大并行帧数（通常为 2）
      */
-    bool Init(VkDevice device, uint32_t maxFrames = 2);
+    bool Init(VkDevice device, VkQueue graphicsQueue, uint32_t maxFrames = 2);
 
     /**
      * @brief 销毁所有同步对象
      */
     void Destroy();
 
+    /**
+     * @brief 等待该帧上一次提交完成，并回收已完成的资源
+     */
+    bool WaitFrame(uint32_t frame);
+
+    /**
+     * @brief 提交该帧的命令：等待 ImageAvailable，Signal RenderFinished
+     *        与图形时间线
+     * @param waits 额外等待的其他队列时间线（如异步计算）
+     * @param waitStage 等待 ImageAvailable 的阶段（首次写交换链图像的阶段）
+     * @return 图形时间线的 Signal 值，失败返回 0
+     */
+    uint64_t SubmitFrame(uint32_t frame,
+                         const std::vector<VkCommandBuffer> &commandBuffers,
+                         const std::vector<TimelineWait> &waits = {},
+                         VkPipelineStageFlags waitStage =
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
     /// 当前帧可用信号量（image acquired）
     VkSemaphore GetImageAvailable(uint32_t frame) const;
 
     /// 当前帧渲染完成信号量（render finished）
     VkSemaphore GetRenderFinished(uint32_t frame) const;
 
-    /// 当前帧 Fence（CPU ↔ GPU 同步）
-    VkFence GetInFlightFence(uint32_t frame) const;
+    /// 该帧最近一次提交 Signal 的时间线值
+    uint64_t GetFrameValue(uint32_t frame) const;
+
+    /// 图形队列时间线（CPU ↔ GPU、跨队列同步）
+    VulkanTimeline *GetGraphicsTimeline()
+    {
+        return &_graphicsTimeline;
+    }
 
     /// 并行帧数量
     uint32_t GetFrameCount() const
@@ -64,8 +90,11 @@ private:
     // 每帧一个 RenderFinished Semaphore
     std::vector<VkSemaphore> _renderFinished;
 
-    // 每帧一个 Fence，用于 CPU 等待 GPU
-    std::vector<VkFence> _inFlightFences;
+    // 每帧最近一次提交的时间线值（0 表示尚未提交）
+    std::vector<uint64_t> _frameValues;
+
+    // 图形队列时间线
+    VulkanTimeline _graphicsTimeline;
 };
 
 } // namespace RHI
@@ -3,14 +3,17 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include "VulkanUtils.h"
+
 namespace RHI
 {
 VulkanTexture::VulkanTexture(VkPhysicalDevice physicalDevice, VkDevice device,
-                             VkCommandPool commandPool, VkQueue graphicsQueue,
+                             VkCommandPool commandPool,
+                             VulkanTimeline *timeline,
                              const std::string &filename,
                              VkSampleCountFlagBits samples)
 {
-    InitFromFile(physicalDevice, device, commandPool, graphicsQueue, filename,
+    InitFromFile(physicalDevice, device, commandPool, timeline, filename,
                  samples);
 }
 
@@ -21,7 +24,7 @@ VulkanTexture::~VulkanTexture()
 
 bool VulkanTexture::InitFromFile(VkPhysicalDevice physicalDevice,
                                  VkDevice device, VkCommandPool commandPool,
-                                 VkQueue graphicsQueue,
+                                 VulkanTimeline *timeline,
                                  const std::string &filename,
                                  VkSampleCountFlagBits samples)
 {
@@ -35,14 +38,19 @@ bool VulkanTexture::InitFromFile(VkPhysicalDevice physicalDevice,
 
     VkDeviceSize size = width * height * 4;
 
-    // staging buffer
-    VulkanBuffer staging;
-    staging.Init(physicalDevice, device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                     | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // staging buffer（拷贝完成前由时间线持有）
+    VulkanBuffer *staging = new (std::nothrow) VulkanBuffer();
+    if (nullptr == staging) {
+        stbi_image_free(pixels);
+        return false;
+    }
+    staging->Init(physicalDevice, device, size,
+                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    memcpy(staging.Map(), pixels, size);
-    staging.Unmap();
+    memcpy(staging->Map(), pixels, size);
+    staging->Unmap();
     stbi_image_free(pixels);
 
     // image
@@ -50,19 +58,20 @@ bool VulkanTexture::InitFromFile(VkPhysicalDevice physicalDevice,
                 VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                 VK_IMAGE_ASPECT_COLOR_BIT, samples);
 
-    _image.TransitionLayout(commandPool, graphicsQueue,
-                            VK_IMAGE_LAYOUT_UNDEFINED,
-                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    // 转换 → 拷贝 → 转换 一次提交，不等待队列空闲
+    VkCommandBuffer cmd = BeginSingleTimeCommand(device, commandPool);
+
+    _image.RecordTransitionLayout(cmd, VK_IMAGE_LAYOUT_UNDEFINED,
+                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    _image.CopyFromBuffer(commandPool, graphicsQueue, staging.Get(), width,
-                          height);
+    _image.RecordCopyFromBuffer(cmd, staging->Get(), width, height);
 
-    _image.TransitionLayout(commandPool, graphicsQueue,
-                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    _image.RecordTransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-    staging.Destroy();
-    return true;
+    return EndSingleTimeCommand(device, commandPool, timeline, cmd,
+                                [staging]() { delete staging; })
+           != 0;
 }
 
 void VulkanTexture::Destroy()
@@ -18,13 +18,19 @@ public:
     VulkanTexture() = default;
 
     VulkanTexture(VkPhysicalDevice physicalDevice, VkDevice device,
-                  VkCommandPool commandPool, VkQueue graphicsQueue,
+                  VkCommandPool commandPool, VulkanTimeline *timeline,
                   const std::string &filename, VkSampleCountFlagBits samples);
 
     ~VulkanTexture();
 
+    /**
+     * @brief 从文件加载纹理
+     *
+     * 转换与拷贝录制在同一个命令缓冲区，提交到图形时间线后立即返回，
+     * staging 由时间线在 GPU 完成后回收
+     */
     bool InitFromFile(VkPhysicalDevice physicalDevice, VkDevice device,
-                      VkCommandPool commandPool, VkQueue graphicsQueue,
+                      VkCommandPool commandPool, VulkanTimeline *timeline,
                       const std::string &filename,
                       VkSampleCountFlagBits samples);
 
@@ -0,0 +1,191 @@
+﻿#include "VulkanTimeline.h"
+
+#include <algorithm>
+
+#include "PrintMsg.h"
+
+namespace RHI
+{
+
+VulkanTimeline::VulkanTimeline()
+{
+}
+
+VulkanTimeline::~VulkanTimeline()
+{
+    Destroy();
+}
+
+bool VulkanTimeline::Init(VkDevice device, VkQueue queue)
+{
+    if (VK_NULL_HANDLE == device || VK_NULL_HANDLE == queue) {
+        PSG::PrintError("创建时间线信号量失败：设备或队列为空!");
+        return false;
+    }
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &_semaphore)
+        != VK_SUCCESS) {
+        PSG::PrintError("创建时间线信号量失败!");
+        return false;
+    }
+
+    _device = device;
+    _queue = queue;
+    _submitted = 0;
+    return true;
+}
+
+void VulkanTimeline::Destroy()
+{
+    if (VK_NULL_HANDLE == _semaphore) {
+        return;
+    }
+
+    // 等待全部提交完成，保证登记的资源都可以安全释放
+    Wait(_submitted);
+    while (!_retirements.empty()) {
+        std::function<void()> release =
+            std::move(_retirements.front().release);
+        _retirements.pop_front();
+        release();
+    }
+
+    vkDestroySemaphore(_device, _semaphore, nullptr);
+    _semaphore = VK_NULL_HANDLE;
+    _queue = VK_NULL_HANDLE;
+    _submitted = 0;
+}
+
+uint64_t
+VulkanTimeline::Submit(const std::vector<VkCommandBuffer> &commandBuffers,
+                       const std::vector<TimelineWait> &waits,
+                       const BinarySemaphores &binary)
+{
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<uint64_t> waitValues;
+    std::vector<VkPipelineStageFlags> waitStages;
+
+    for (const auto &wait : waits) {
+        if (nullptr == wait.timeline) {
+            continue;
+        }
+        waitSemaphores.push_back(wait.timeline->Get());
+        waitValues.push_back(wait.value);
+        waitStages.push_back(wait.stage);
+    }
+
+    // 二值信号量的值会被忽略，但数组长度必须与信号量数量一致
+    if (binary.wait != VK_NULL_HANDLE) {
+        waitSemaphores.push_back(binary.wait);
+        waitValues.push_back(0);
+        waitStages.push_back(binary.waitStage);
+    }
+
+    const uint64_t signalValue = _submitted + 1;
+
+    std::vector<VkSemaphore> signalSemaphores = {_semaphore};
+    std::vector<uint64_t> signalValues = {signalValue};
+    if (binary.signal != VK_NULL_HANDLE) {
+        signalSemaphores.push_back(binary.signal);
+        signalValues.push_back(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount =
+        static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount =
+        static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount =
+        static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount =
+        static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBuffers = commandBuffers.data();
+    submitInfo.signalSemaphoreCount =
+        static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    if (vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        PSG::PrintError("提交命令缓冲区失败!");
+        return 0;
+    }
+
+    _submitted = signalValue;
+    return signalValue;
+}
+
+bool VulkanTimeline::Wait(uint64_t value, uint64_t timeout) const
+{
+    // 0 为初始值，不需要等待
+    if (0 == value) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_semaphore;
+    waitInfo.pValues = &value;
+
+    return vkWaitSemaphores(_device, &waitInfo, timeout) == VK_SUCCESS;
+}
+
+uint64_t VulkanTimeline::GetCompleted() const
+{
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_device, _semaphore, &value);
+    return value;
+}
+
+bool VulkanTimeline::IsCompleted(uint64_t value) const
+{
+    return value <= GetCompleted();
+}
+
+void VulkanTimeline::Retire(uint64_t value, std::function<void()> release)
+{
+    if (!release) {
+        return;
+    }
+
+    // 保持按值有序，Collect 只需检查队首
+    auto it = std::upper_bound(
+        _retirements.begin(), _retirements.end(), value,
+        [](uint64_t v, const Retirement &r) { return v < r.value; });
+    _retirements.insert(it, {value, std::move(release)});
+}
+
+void VulkanTimeline::Collect()
+{
+    if (_retirements.empty()) {
+        return;
+    }
+
+    const uint64_t completed = GetCompleted();
+    while (!_retirements.empty() && _retirements.front().value <= completed) {
+        // 先出队再执行，回调中可以再次登记
+        std::function<void()> release =
+            std::move(_retirements.front().release);
+        _retirements.pop_front();
+        release();
+    }
+}
+
+} // namespace RHI
@@ -0,0 +1,155 @@
+﻿#ifndef VULKANTIMELINE_H_
+#define VULKANTIMELINE_H_
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "VulkanHeadRHI.h"
+
+namespace RHI
+{
+
+class VulkanTimeline;
+
+/**
+ * @brief 提交时等待另一条时间线（跨队列同步）
+ */
+struct TimelineWait
+{
+    const VulkanTimeline *timeline = nullptr;
+
+    // 等待该时间线到达的值
+    uint64_t value = 0;
+
+    // 在哪个阶段之前等待
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+};
+
+/**
+ * @brief 提交时附带的二值信号量（交换链获取 / 呈现只支持二值信号量）
+ */
+struct BinarySemaphores
+{
+    VkSemaphore wait = VK_NULL_HANDLE;
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    VkSemaphore signal = VK_NULL_HANDLE;
+};
+
+/**
+ * @brief VulkanTimeline
+ *
+ * 一个队列对应一条单调递增的时间线（Timeline Semaphore）：
+ * - 每次提交 Signal 下一个值，CPU / 其他队列按值等待
+ * - 资源释放（暂存缓冲、延迟销毁、环形缓冲区段）按值登记，
+ *   GPU 到达该值后再执行，不需要每帧的 VkFence
+ */
+class VulkanTimeline
+{
+public:
+    VulkanTimeline();
+
+    ~VulkanTimeline();
+
+public:
+    /**
+     * @brief 创建时间线信号量
+     * @param device 逻辑设备（需启用 timelineSemaphore 特性）
+     * @param queue 该时间线对应的队列
+     */
+    bool Init(VkDevice device, VkQueue queue);
+
+    /**
+     * @brief 等待全部已提交的工作完成，执行剩余的释放回调后销毁
+     */
+    void Destroy();
+
+    /**
+     * @brief 提交到队列，完成时 Signal 时间线的下一个值
+     * @param commandBuffers 提交的命令缓冲
+     * @param waits 等待其他时间线（可跨队列）
+     * @param binary 交换链使用的二值信号量（可为空）
+     * @return 本次提交 Signal 的值，失败返回 0
+     */
+    uint64_t Submit(const std::vector<VkCommandBuffer> &commandBuffers,
+                    const std::vector<TimelineWait> &waits = {},
+                    const BinarySemaphores &binary = {});
+
+    /**
+     * @brief CPU 等待时间线到达 value
+     * @param timeout 超时（纳秒）
+     */
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+    /**
+     * @brief GPU 已完成的值（查询设备）
+     */
+    uint64_t GetCompleted() const;
+
+    /**
+     * @brief value 对应的工作是否已完成
+     */
+    bool IsCompleted(uint64_t value) const;
+
+    /**
+     * @brief 登记在 value 完成后执行的释放操作
+     */
+    void Retire(uint64_t value, std::function<void()> release);
+
+    /**
+     * @brief 登记在当前已提交的全部工作完成后执行的释放操作
+     */
+    void Retire(std::function<void()> release)
+    {
+        Retire(_submitted, std::move(release));
+    }
+
+    /**
+     * @brief 执行 GPU 已完成部分的释放操作
+     */
+    void Collect();
+
+    VkSemaphore Get() const
+    {
+        return _semaphore;
+    }
+
+    VkQueue GetQueue() const
+    {
+        return _queue;
+    }
+
+    /**
+     * @brief 最近一次提交 Signal 的值
+     */
+    uint64_t GetSubmitted() const
+    {
+        return _submitted;
+    }
+
+private:
+    struct Retirement
+    {
+        uint64_t value = 0;
+        std::function<void()> release;
+    };
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+
+    VkQueue _queue = VK_NULL_HANDLE;
+
+    // 时间线信号量
+    VkSemaphore _semaphore = VK_NULL_HANDLE;
+
+    // 已提交的最大 Signal 值
+    uint64_t _submitted = 0;
+
+    // 按值递增排列的待释放资源
+    std::deque<Retirement> _retirements;
+};
+
+} // namespace RHI
+
+#endif // !VULKANTIMELINE_H_
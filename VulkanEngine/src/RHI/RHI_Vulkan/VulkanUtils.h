@@ -1,9 +1,12 @@
 ﻿#ifndef VULKAN_UTILS_H_
 #define VULKAN_UTILS_H_
 
+#include <functional>
 #include <stdexcept>
 #include <vulkan/vulkan.h>
 
+#include "VulkanTimeline.h"
+
 namespace RHI
 {
 
@@ -114,6 +117,79 @@ FindMaxUsableSampleCount(VkPhysicalDevice physicalDevice)
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
+/**
+ * @brief 图像处于某布局时的典型访问方式（用于推导屏障）
+ */
+struct ImageLayoutAccess
+{
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags access = 0;
+};
+
+/**
+ * @brief 根据布局推导访问阶段与访问类型
+ *
+ * 未列出的布局按最保守的 ALL_COMMANDS + MEMORY_READ / WRITE 处理
+ */
+inline ImageLayoutAccess GetImageLayoutAccess(VkImageLayout layout)
+{
+    switch (layout) {
+    case VK_IMAGE_LAYOUT_UNDEFINED:
+        return {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0};
+    case VK_IMAGE_LAYOUT_PREINITIALIZED:
+        return {VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                    | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_SHADER_READ_BIT};
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+                    | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                    | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT};
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                    | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                    | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                    | VK_ACCESS_SHADER_READ_BIT};
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        return {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0};
+    default:
+        return {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT};
+    }
+}
+
+/**
+ * @brief 根据格式推导图像的 aspect
+ */
+inline VkImageAspectFlags GetFormatAspect(VkFormat format)
+{
+    switch (format) {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    case VK_FORMAT_S8_UINT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
 // 创建命令缓冲区记录 并绑定 开始单次命令
 inline VkCommandBuffer BeginSingleTimeCommand(VkDevice device,
                                               VkCommandPool commandPool)
@@ -166,6 +242,41 @@ inline void EndSingleTimeCommand(VkDevice device, VkCommandPool commandPool,
     vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
 
+// 停止命令缓冲区记录 提交到时间线但不等待
+// 命令缓冲区与 release（如暂存缓冲）登记到时间线，GPU 执行完后在 Collect 中释放
+// 返回提交的时间线值，提交失败时立即释放并返回 0
+inline uint64_t EndSingleTimeCommand(VkDevice device, VkCommandPool commandPool,
+                                     VulkanTimeline *timeline,
+                                     VkCommandBuffer commandBuffer,
+                                     std::function<void()> release = {})
+{
+    vkEndCommandBuffer(commandBuffer);
+
+    const uint64_t value = timeline->Submit({commandBuffer});
+    if (0 == value) {
+        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+        if (release) {
+            release();
+        }
+        return 0;
+    }
+
+    timeline->Retire(value, [device, commandPool, commandBuffer, release]() {
+        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+        if (release) {
+            release();
+        }
+    });
+    return value;
+}
+
+// 哈希合并（用于描述符集等组合键）
+template <typename T>
+inline void HashCombine(size_t &seed, const T &value)
+{
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 } // namespace RHI
 
 #endif // VULKAN_UTILS_H_
\ No newline at end of file
@@ -7,11 +7,11 @@ namespace RHI
 VulkanVertexBuffer::VulkanVertexBuffer(VkPhysicalDevice physicalDevice,
                                        VkDevice device,
                                        VkCommandPool commandPool,
-                                       VkQueue graphicsQueue,
+                                       VulkanTimeline *timeline,
                                        const void *vertexData,
                                        VkDeviceSize size, uint32_t stride)
 {
-    Init(physicalDevice, device, commandPool, graphicsQueue, vertexData, size,
+    Init(physicalDevice, device, commandPool, timeline, vertexData, size,
          stride);
 }
 
@@ -21,23 +21,27 @@ VulkanVertexBuffer::~VulkanVertexBuffer()
 }
 
 bool VulkanVertexBuffer::Init(VkPhysicalDevice physicalDevice, VkDevice device,
-                              VkCommandPool commandPool, VkQueue graphicsQueue,
-                              const void *vertexData, VkDeviceSize size,
-                              uint32_t stride)
+                              VkCommandPool commandPool,
+                              VulkanTimeline *timeline, const void *vertexData,
+                              VkDeviceSize size, uint32_t stride)
 {
     _stride = stride;
 
     // =========================
-    // 1. staging buffer（CPU 可写）
+    // 1. staging buffer（CPU 可写，拷贝完成前由时间线持有）
     // =========================
-    VulkanBuffer staging;
-    staging.Init(physicalDevice, device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                     | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VulkanBuffer *staging = new (std::nothrow) VulkanBuffer();
+    if (nullptr == staging) {
+        return false;
+    }
+    staging->Init(physicalDevice, device, size,
+                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                      | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    void *data = staging.Map();
+    void *data = staging->Map();
     memcpy(data, vertexData, static_cast<size_t>(size));
-    staging.Unmap();
+    staging->Unmap();
 
     // =========================
     // 2. device local buffer（真正用来画）
@@ -48,12 +52,9 @@ bool VulkanVertexBuffer::Init(VkPhysicalDevice physicalDevice, VkDevice device,
                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     // =========================
-    // 3. staging → device local
+    // 3. staging → device local（不阻塞，GPU 完成后释放 staging）
     // =========================
-    _buffer.CopyFrom(staging, commandPool, graphicsQueue);
-
-    staging.Destroy();
-    return true;
+    return _buffer.CopyFrom(staging, commandPool, timeline) != 0;
 }
 
 void VulkanVertexBuffer::Destroy()
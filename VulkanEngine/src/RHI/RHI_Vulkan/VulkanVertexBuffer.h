@@ -12,7 +12,7 @@ public:
     VulkanVertexBuffer() = default;
 
     VulkanVertexBuffer(VkPhysicalDevice physicalDevice, VkDevice device,
-                       VkCommandPool commandPool, VkQueue graphicsQueue,
+                       VkCommandPool commandPool, VulkanTimeline *timeline,
                        const void *vertexData, VkDeviceSize size,
                        uint32_t stride);
 
@@ -20,9 +20,11 @@ public:
 
     /**
      * @brief 使用 staging buffer 创建顶点缓冲
+     *
+     * 拷贝提交到图形时间线，不等待完成，staging 由时间线回收
      */
     bool Init(VkPhysicalDevice physicalDevice, VkDevice device,
-              VkCommandPool commandPool, VkQueue graphicsQueue,
+              VkCommandPool commandPool, VulkanTimeline *timeline,
               const void *vertexData, VkDeviceSize size, uint32_t stride);
 
     void Destroy();
@@ -1,11 +1,13 @@
 ﻿#include "VulkanRHI.h"
 
+#include "PrintMsg.h"
+
 namespace RHI
 {
 
 VulkanRHI::~VulkanRHI()
 {
-    SDelete(_context);
+    Shutdown();
 }
 
 bool VulkanRHI::Init(const SurfaceDescRHI &surfaceDesc, int width, int height)
@@ -20,14 +22,45 @@ bool VulkanRHI::Init(const SurfaceDescRHI &surfaceDesc, int width, int height)
         return false;
     }
 
-    // 2. 创建 ResourceManager
+    // 重建交换链时 Surface 未固定分辨率则使用该尺寸
+    _width = width;
+    _height = height;
+
+    // 2. 创建 ResourceManager（每帧资源与同步对象使用相同的并行帧数）
     _resourceManager = new (std::nothrow) VulkanResourceManager();
-    ret = _resourceManager->Init(_context, 2);
-    return ret;
+    ret = _resourceManager->Init(_context, _context->GetFramesInFlight());
+    if (!ret) {
+        return false;
+    }
+
+    // 3. 每个并行帧一个主命令缓冲区
+    _commandBuffers = new (std::nothrow) VulkanCommandBuffer();
+    if (nullptr == _commandBuffers) {
+        return false;
+    }
+
+    ret = _commandBuffers->Init(_context->GetVkDevice(),
+                                _context->GetVkCommandPool(),
+                                _context->GetFramesInFlight());
+    if (!ret) {
+        return false;
+    }
+
+    // 4. 创建帧图
+    return createRenderGraph();
 }
 
 void VulkanRHI::Shutdown()
 {
+    // 销毁前等待 GPU 完成所有帧，并回收时间线上待释放的暂存缓冲
+    if (nullptr != _context) {
+        _context->WaitIdle();
+        _context->GetGraphicsTimeline()->Collect();
+    }
+
+    SDelete(_renderGraph);
+    SDelete(_commandBuffers);
+
     if (nullptr != _resourceManager) {
         SDelete(_resourceManager);
     }
@@ -35,14 +68,211 @@ void VulkanRHI::Shutdown()
     if (nullptr != _context) {
         SDelete(_context);
     }
+
+    _backbuffer = RENDER_GRAPH_INVALID;
+    _frameIndex = 0;
+    _frameStarted = false;
+    _swapchainDirty = false;
 }
 
 void VulkanRHI::BeginFrame()
 {
+    _frameStarted = false;
+    if (nullptr == _renderGraph) {
+        return;
+    }
+
+    // 交换链已失效（或窗口最小化时重建未成功）时先重建，失败则跳过本帧
+    if (_swapchainDirty && !recreateSwapchain()) {
+        return;
+    }
+
+    // 等待该帧上一次提交完成，其命令缓冲区与每帧描述符池才能复用
+    if (!_context->GetSync()->WaitFrame(_frameIndex)) {
+        return;
+    }
+    _resourceManager->BeginFrame(_frameIndex);
+
+    // 先开始录制再获取图像：录制失败时 imageAvailable 尚未发出信号，
+    // 不会留下无人等待的信号量
+    VkCommandBuffer cmd = _commandBuffers->Get(_frameIndex);
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) {
+        PSG::PrintError("开始录制命令缓冲区失败!");
+        return;
+    }
+
+    VkResult ret = vkAcquireNextImageKHR(
+        _context->GetVkDevice(), _context->GetVkSwapchain(), UINT64_MAX,
+        _context->GetImageAvailableSemaphore(_frameIndex), VK_NULL_HANDLE,
+        &_imageIndex);
+
+    // 交换链失效（窗口尺寸变化等）时信号量不会发出信号，跳过本帧并重建
+    if (ret == VK_ERROR_OUT_OF_DATE_KHR) {
+        _swapchainDirty = true;
+        return;
+    }
+
+    if (ret != VK_SUCCESS && ret != VK_SUBOPTIMAL_KHR) {
+        PSG::PrintError("获取交换链图像失败!");
+        return;
+    }
+
+    // 次优时信号量已发出信号，本帧照常提交呈现，呈现后再重建
+    if (ret == VK_SUBOPTIMAL_KHR) {
+        _swapchainDirty = true;
+    }
+
+    _frameStarted = true;
 }
 
 void VulkanRHI::EndFrame()
 {
+    if (!_frameStarted) {
+        return;
+    }
+    _frameStarted = false;
+
+    // 本帧的交换链图像
+    VulkanSwapchain *swapchain = _context->GetSwapchain();
+    _renderGraph->SetImportedTexture(_backbuffer,
+                                     swapchain->GetImages()[_imageIndex],
+                                     swapchain->GetImageViews()[_imageIndex]);
+
+    VkCommandBuffer cmd = _commandBuffers->Get(_frameIndex);
+    _renderGraph->Execute(cmd);
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        PSG::PrintError("结束录制命令缓冲区失败!");
+        return;
+    }
+
+    // 帧图第一次写交换链图像是拷贝，在传输阶段等待图像可用
+    const uint64_t value = _context->GetSync()->SubmitFrame(
+        _frameIndex, {cmd}, {}, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    if (0 == value) {
+        return;
+    }
+
+    VkSemaphore renderFinished =
+        _context->GetRenderFinishedSemaphore(_frameIndex);
+    VkSwapchainKHR vkSwapchain = swapchain->Get();
+
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &renderFinished;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &vkSwapchain;
+    presentInfo.pImageIndices = &_imageIndex;
+    VkResult ret = vkQueuePresentKHR(_context->GetDevice()->GetPresentQueue(),
+                                     &presentInfo);
+
+    // 交换链失效或与 Surface 不再匹配，下一帧开始前重建
+    if (ret == VK_ERROR_OUT_OF_DATE_KHR || ret == VK_SUBOPTIMAL_KHR) {
+        _swapchainDirty = true;
+    }
+
+    _frameIndex = (_frameIndex + 1) % _context->GetFramesInFlight();
+}
+
+bool VulkanRHI::recreateSwapchain()
+{
+    // 窗口最小化时重建失败，保留失效标记下一帧重试
+    if (!_context->RecreateSwapchain(_width, _height)) {
+        return false;
+    }
+
+    // 按新分辨率重新导入交换链图像并编译帧图
+    if (!buildRenderGraph()) {
+        return false;
+    }
+
+    _resourceManager->OnSwapchainRecreated(_context->GetFramesInFlight());
+    _swapchainDirty = false;
+    return true;
+}
+
+bool VulkanRHI::createRenderGraph()
+{
+    _renderGraph = new (std::nothrow) VulkanRenderGraph();
+    if (nullptr == _renderGraph) {
+        return false;
+    }
+
+    if (!_renderGraph->Init(_context->GetVkPhysicalDevice(),
+                            _context->GetVkDevice())) {
+        return false;
+    }
+
+    return buildRenderGraph();
+}
+
+bool VulkanRHI::buildRenderGraph()
+{
+    VulkanSwapchain *swapchain = _context->GetSwapchain();
+    if (!swapchain->SupportsTransferDst()) {
+        PSG::PrintError("交换链图像不支持拷贝写入，无法创建帧图!");
+        return false;
+    }
+
+    // 清空旧分辨率的资源与 Pass（同时释放瞬态图像）
+    _renderGraph->Reset();
+
+    const VkExtent2D extent = swapchain->GetExtent();
+
+    // 离屏颜色目标（瞬态，多帧并行时共享同一显存）
+    RenderGraphTextureDesc desc{};
+    desc.width = extent.width;
+    desc.height = extent.height;
+    desc.format = swapchain->GetFormat();
+    const RenderGraphResource sceneColor =
+        _renderGraph->CreateTexture("SceneColor", desc);
+
+    // 交换链图像：句柄每帧更新，获取时内容未定义，结束时转换到呈现布局
+    const RenderGraphResource backbuffer = _renderGraph->ImportTexture(
+        "Backbuffer", VK_NULL_HANDLE, VK_NULL_HANDLE, swapchain->GetFormat(),
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    _backbuffer = backbuffer;
+
+    VulkanRenderGraph *graph = _renderGraph;
+    _renderGraph
+        ->AddPass("Clear",
+                  [graph, sceneColor](VkCommandBuffer cmd) {
+                      VkClearColorValue color = {{1.0f, 1.0f, 1.0f, 1.0f}};
+                      VkImageSubresourceRange range{};
+                      range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                      range.levelCount = 1;
+                      range.layerCount = 1;
+                      vkCmdClearColorImage(
+                          cmd, graph->GetImage(sceneColor),
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1,
+                          &range);
+                  })
+        .Write(sceneColor, RenderGraphAccess::TransferDst);
+
+    _renderGraph
+        ->AddPass("Present",
+                  [graph, sceneColor, backbuffer, extent](VkCommandBuffer cmd) {
+                      VkImageCopy region{};
+                      region.srcSubresource.aspectMask =
+                          VK_IMAGE_ASPECT_COLOR_BIT;
+                      region.srcSubresource.layerCount = 1;
+                      region.dstSubresource = region.srcSubresource;
+                      region.extent = {extent.width, extent.height, 1};
+                      vkCmdCopyImage(cmd, graph->GetImage(sceneColor),
+                                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                     graph->GetImage(backbuffer),
+                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                                     &region);
+                  })
+        .Read(sceneColor, RenderGraphAccess::TransferSrc)
+        .Write(backbuffer, RenderGraphAccess::TransferDst);
+
+    return _renderGraph->Compile();
 }
 
 } // namespace RHI
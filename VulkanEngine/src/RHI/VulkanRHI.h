@@ -3,7 +3,9 @@
 
 #include "IRHI.h"
 
+#include "RHI_Vulkan/VulkanCommandBuffer.h"
 #include "RHI_Vulkan/VulkanContext.h"
+#include "RHI_Vulkan/VulkanRenderGraph.h"
 #include "RHI_Vulkan/VulkanResourceManager.h"
 
 namespace RHI
@@ -24,12 +26,53 @@ public:
 
     virtual void EndFrame() override;
 
+private:
+    /**
+     * @brief 创建帧图对象并按当前交换链构建
+     */
+    bool createRenderGraph();
+
+    /**
+     * @brief 按当前交换链分辨率构建帧图：离屏清屏 → 拷贝到交换链图像
+     */
+    bool buildRenderGraph();
+
+    /**
+     * @brief 重建交换链、帧图及依赖交换链的资源
+     */
+    bool recreateSwapchain();
+
 private:
     // 管理 Vulkan 基础对象
     VulkanContext *_context = nullptr;
 
     // 管理 Buffers / Textures / DescriptorSet
     VulkanResourceManager *_resourceManager = nullptr;
+
+    // 每个并行帧一个主命令缓冲区
+    VulkanCommandBuffer *_commandBuffers = nullptr;
+
+    // 帧图（Compile 一次，每帧 Execute）
+    VulkanRenderGraph *_renderGraph = nullptr;
+
+    // 帧图中导入的交换链图像
+    RenderGraphResource _backbuffer = RENDER_GRAPH_INVALID;
+
+    // 当前并行帧下标
+    uint32_t _frameIndex = 0;
+
+    // 本帧获取的交换链图像下标
+    uint32_t _imageIndex = 0;
+
+    // BeginFrame 成功获取图像后为 true，EndFrame 才提交
+    bool _frameStarted = false;
+
+    // 获取或呈现返回失效/次优后为 true，下一帧开始前重建交换链
+    bool _swapchainDirty = false;
+
+    // 窗口尺寸（Surface 未固定分辨率时用于重建交换链）
+    int _width = 0;
+    int _height = 0;
 };
 } // namespace RHI
 